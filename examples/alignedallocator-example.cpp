@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// alignedallocator-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 alignedallocator-example.cpp -I ../include -o alignedallocator-example.exe -lm -static
+// Run: ./alignedallocator-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "LinearDelayLine.h"
+#include "MirroredDelayLine.h"
+#include "MirroredFifo.h"
+
+//! Offset of a pointer from a 64 byte boundary
+size_t misalignment(const void * p)
+{
+	return (size_t)((uintptr_t)p % 64);
+}
+
+//! Count the samples of two delay lines that differ
+template <typename FirstType, typename SecondType>
+size_t compareLines(FirstType& first, SecondType& second, size_t length)
+{
+	size_t differences = 0;
+	for( size_t i = 0; i < length; i++ )
+	{
+		if( first.data()[i] != second.data()[i] )
+		{
+			differences++;
+		}
+	}
+	return differences;
+}
+
+//! Append blocks to a delay line, a different length each time
+template <typename DelayLineType>
+void fillLine(DelayLineType& delayLine, size_t count)
+{
+	for( size_t i = 0; i < count; i++ )
+	{
+		delayLine.append((float)(i % 1000003));
+	}
+}
+
+//! Write and read a fifo in uneven blocks - returns the number of samples out of order
+template <typename FifoType>
+size_t checkFifo(FifoType& fifo, size_t count)
+{
+	std::vector<float> block(1000);
+	size_t written = 0;
+	size_t read = 0;
+	size_t errors = 0;
+
+	while( read < count )
+	{
+		size_t length = 1 + (written * 7) % block.size();
+		for( size_t i = 0; i < length; i++ )
+		{
+			block[i] = (float)(written + i);
+		}
+		written += fifo.write(length, &block[0]);
+
+		length = fifo.read(1 + (read * 13) % block.size(), &block[0]);
+		for( size_t i = 0; i < length; i++ )
+		{
+			if( block[i] != (float)(read + i) )
+			{
+				errors++;
+			}
+		}
+		read += length;
+	}
+
+	return errors;
+}
+
+//! Time appends, ns per append
+template <typename DelayLineType>
+double timeAppends(DelayLineType& delayLine, int repetitions)
+{
+	float check = 0.0f;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		delayLine.append((float)r);
+		check += delayLine.data()[0];
+	}
+	std::clock_t endTime = std::clock();
+
+	// Keep the reads
+	if( check == -1.0f )
+	{
+		std::cout << check << std::endl;
+	}
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+}
+
+//! Time reads from random places in the line, ns per read
+template <typename DelayLineType>
+double timeRandomReads(DelayLineType& delayLine, int repetitions)
+{
+	const float * data = delayLine.data();
+	size_t length = delayLine.length();
+	uint32_t state = 12345;
+	float check = 0.0f;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		state = state * 1664525u + 1013904223u;
+		check += data[state % length];
+	}
+	std::clock_t endTime = std::clock();
+
+	// Keep the reads
+	if( check == -1.0f )
+	{
+		std::cout << check << std::endl;
+	}
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "AlignedAllocator example usage" << std::endl << std::endl;
+
+	// Every allocation starts on a 64 byte boundary
+	size_t misaligned = 0;
+	for( size_t n = 1; n < 1000; n += 7 )
+	{
+		std::vector<float, AlignedAllocator<float> > floats(n);
+		std::vector<double, AlignedAllocator<double> > doubles(n);
+		std::vector<int16_t, AlignedAllocator<int16_t> > shorts(n);
+		misaligned += (misalignment(&floats[0]) != 0) ? 1 : 0;
+		misaligned += (misalignment(&doubles[0]) != 0) ? 1 : 0;
+		misaligned += (misalignment(&shorts[0]) != 0) ? 1 : 0;
+
+		// A new line reads from the start of its storage
+		MirroredDelayLine<float> mirrored(n);
+		LinearDelayLine<float> linear(n);
+		misaligned += (!mirrored.isMapped() && misalignment(mirrored.data()) != 0) ? 1 : 0;
+		misaligned += (misalignment(linear.data()) != 0) ? 1 : 0;
+	}
+	std::cout << "Allocations not on a 64 byte boundary=" << misaligned << std::endl;
+
+	std::vector<float, HugePageAllocator<float> > huge(ALIGNEDALLOCATOR_HUGE_THRESHOLD / sizeof(float));
+	std::cout << "HugePageAllocator " << (huge.size() * sizeof(float)) << " bytes"
+			  << " huge=" << HugePageAllocator<float>::isHuge(huge.size() * sizeof(float))
+			  << " offset from a huge page=" << ((uintptr_t)&huge[0] % ALIGNEDALLOCATOR_HUGE_PAGE) 
+			  << std::endl << std::endl;
+
+	// The same contents whichever allocator holds them - 16MB lines, above 
+	// the huge page threshold
+	size_t N = 4 * 1024 * 1024;
+	size_t count = N + N / 3;
+
+	MirroredDelayLine<float> mappedLine(N);
+	MirroredDelayLine<float, std::allocator<float> > vectorLine(N);
+	MirroredDelayLine<float, HugePageAllocator<float> > hugeLine(N);
+	LinearDelayLine<float, HugePageAllocator<float> > hugeLinearLine(N);
+	fillLine(mappedLine, count);
+	fillLine(vectorLine, count);
+	fillLine(hugeLine, count);
+	fillLine(hugeLinearLine, count);
+
+	std::cout << "Delay lines of N=" << N << std::endl;
+	std::cout << "Default mapped=" << mappedLine.isMapped() << std::endl;
+	std::cout << "std::allocator mapped=" << vectorLine.isMapped() 
+			  << " differences=" << compareLines(mappedLine, vectorLine, N) << std::endl;
+	std::cout << "HugePageAllocator mapped=" << hugeLine.isMapped() 
+			  << " differences=" << compareLines(mappedLine, hugeLine, N) << std::endl;
+	std::cout << "LinearDelayLine HugePageAllocator differences=" 
+			  << compareLines(mappedLine, hugeLinearLine, N) << std::endl;
+
+	MirroredFifo<float> alignedFifo(N);
+	MirroredFifo<float, HugePageAllocator<float> > hugeFifo(N);
+	std::cout << "MirroredFifo errors=" << checkFifo(alignedFifo, count)
+			  << " HugePageAllocator errors=" << checkFifo(hugeFifo, count) 
+			  << std::endl << std::endl;
+
+	// Appends touch the line in order; random reads, as a beamformer's taps 
+	// might, are where the TLB misses show
+	int repetitions = 20000000;
+
+	std::cout << "Time per append." << std::endl;
+	std::cout << "Default (mapped) = " << timeAppends(mappedLine, repetitions) << " ns" << std::endl;
+	std::cout << "std::allocator = " << timeAppends(vectorLine, repetitions) << " ns" << std::endl;
+	std::cout << "HugePageAllocator = " << timeAppends(hugeLine, repetitions) << " ns" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Time per random read." << std::endl;
+	std::cout << "Default (mapped) = " << timeRandomReads(mappedLine, repetitions) << " ns" << std::endl;
+	std::cout << "std::allocator = " << timeRandomReads(vectorLine, repetitions) << " ns" << std::endl;
+	std::cout << "HugePageAllocator = " << timeRandomReads(hugeLine, repetitions) << " ns" << std::endl;
+
+	return 0;
+}
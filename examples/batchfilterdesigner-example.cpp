@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// batchfilterdesigner-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 -std=c++11 batchfilterdesigner-example.cpp -I ../include -o batchfilterdesigner-example.exe -lm -pthread
+// Run: ./batchfilterdesigner-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "BatchFilterDesigner.h"
+#include "FilterFactory.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "BatchFilterDesigner example usage" << std::endl << std::endl;
+
+	// A bank of 4096 bandpass designs across the band
+	std::vector<FilterDesignType> designs;
+	for( int i = 0; i < 4096; i++ )
+	{
+		FilterDesignType design;
+		design.order = 256;
+		design.windowType = FilterWindowType::HAMMING;
+		design.filterType = FilterType::BANDPASS;
+		design.Fs = 48000.0;
+		design.Fc1 = 100.0 + 5.0 * (float)i;
+		design.Fc2 = design.Fc1 + 200.0;
+		design.kaiserBeta = FILTERFACTORY_KAISER_BETA;
+		designs.push_back(design);
+	}
+
+	// Serially, a vector per design
+	FilterFactory filterFactory;
+	std::vector<FilterHolderType> holders(designs.size());
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	for( size_t i = 0; i < designs.size(); i++ )
+	{
+		holders[i] = filterFactory.createFilter(designs[i].order, designs[i].windowType, 
+							designs[i].filterType, designs[i].Fs, designs[i].Fc1, designs[i].Fc2);
+	}
+	double serialTime = std::chrono::duration<double, std::milli>(
+							std::chrono::steady_clock::now() - startTime).count();
+
+	// In parallel, into one arena
+	BatchFilterDesigner batchDesigner;
+	FilterArena arena;
+
+	startTime = std::chrono::steady_clock::now();
+	batchDesigner.design(designs, arena);
+	double batchTime = std::chrono::duration<double, std::milli>(
+							std::chrono::steady_clock::now() - startTime).count();
+
+	// Check against the serial designs
+	size_t mismatches = 0;
+	for( size_t i = 0; i < designs.size(); i++ )
+	{
+		for( size_t k = 0; k < arena.length(i); k++ )
+		{
+			if( arena.coefficients(i)[k] != holders[i].coefficients[k] )
+			{
+				mismatches++;
+				break;
+			}
+		}
+	}
+
+	std::cout << "Designs=" << arena.size() << " coefficients=" << arena.totalLength()
+			  << " mismatches=" << mismatches << std::endl;
+	std::cout << "Serial = " << serialTime << " ms" << std::endl;
+	std::cout << "Batch (" << batchDesigner.threadCount() << " threads) = " 
+			  << batchTime << " ms" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// blockconvolver-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Measures the crossover between direct and FFT convolution for a range of 
+// block sizes. The results can be passed to the BlockConvolver constructor.
+//
+// Compile: g++ -O2 blockconvolver-example.cpp -I ../include -o blockconvolver-example.exe -lm -static
+// Run: ./blockconvolver-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "BlockConvolver.h"
+#include "FilterFactory.h"
+
+double timeConvolver(BlockConvolver<float>& convolver, std::vector<float>& buffer);
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "BlockConvolver example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	// Sample Frequency
+	Float fSampling = 48000.0;
+
+	// Cut frequency
+	Float fCut = 1000.0;
+
+	// Check the two methods agree
+	{
+		FilterHolderType filter = filterFactory.createFilter(
+							1000, FilterWindowType::BLACKMAN, FilterType::LOWPASS,
+							fSampling, fCut);
+
+		BlockConvolver<float> direct(filter, 256, ConvolutionMethod::DIRECT);
+		BlockConvolver<float> fft(filter, 256, ConvolutionMethod::FFT);
+
+		std::vector<float> input(256*8);
+		std::vector<float> directOutput(input.size());
+		std::vector<float> fftOutput(input.size());
+		for( size_t i = 0; i < input.size(); i++ )
+		{
+			input[i] = (float)((i * 7919) % 101) / 50.0f - 1.0f;
+		}
+
+		direct.processBlock(&input[0], &directOutput[0], input.size());
+		fft.processBlock(&input[0], &fftOutput[0], input.size());
+
+		float maxError = 0.0f;
+		for( size_t i = 0; i < input.size(); i++ )
+		{
+			float error = fabs(directOutput[i] - fftOutput[i]);
+			if( error > maxError )
+			{
+				maxError = error;
+			}
+		}
+
+		std::cout << "Direct vs FFT maximum difference=" << maxError << std::endl << std::endl;
+	}
+
+	// Sweep the block sizes and orders
+	size_t blockSizes[] = { 32, 64, 128, 256, 512, 1024 };
+	int orders[] = { 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+
+	for( size_t b = 0; b < sizeof(blockSizes)/sizeof(blockSizes[0]); b++ )
+	{
+		size_t blockSize = blockSizes[b];
+		std::vector<float> buffer(blockSize, 0.0f);
+		int crossoverOrder = -1;
+
+		std::cout << "Timing comparisons: blockSize=" << blockSize << std::endl;
+
+		for( size_t o = 0; o < sizeof(orders)/sizeof(orders[0]); o++ )
+		{
+			FilterHolderType filter = filterFactory.createFilter(
+								orders[o], FilterWindowType::BLACKMAN, FilterType::LOWPASS,
+								fSampling, fCut);
+
+			BlockConvolver<float> direct(filter, blockSize, ConvolutionMethod::DIRECT);
+			BlockConvolver<float> fft(filter, blockSize, ConvolutionMethod::FFT);
+
+			double directTimeNs = timeConvolver(direct, buffer);
+			double fftTimeNs = timeConvolver(fft, buffer);
+
+			if( (crossoverOrder < 0) && (fftTimeNs < directTimeNs) )
+			{
+				crossoverOrder = orders[o];
+			}
+
+			std::cout << "order=" << orders[o]
+					  << " Direct = " << directTimeNs << " ns/sample"
+					  << " FFT = " << fftTimeNs << " ns/sample" << std::endl;
+		}
+
+		std::cout << "Measured crossover taps=";
+		if( crossoverOrder < 0 )
+		{
+			std::cout << "none";
+		}
+		else
+		{
+			std::cout << (crossoverOrder + 1);
+		}
+		std::cout << " default crossover taps=" 
+				  << BlockConvolver<float>::defaultCrossoverTaps(blockSize) 
+				  << std::endl << std::endl;
+	}
+
+	return 0;
+}
+
+//! Time per sample to process blocks for about 100ms
+double timeConvolver(BlockConvolver<float>& convolver, std::vector<float>& buffer)
+{
+	int repetitions = 0;
+
+	std::clock_t startTime = std::clock();
+	std::clock_t endTime = startTime;
+
+	while( (endTime - startTime) < (CLOCKS_PER_SEC / 10) )
+	{
+		for( int r = 0; r < 16; r++ )
+		{
+			buffer[0] = (float)r;
+			convolver.processBlock(&buffer[0], &buffer[0], buffer.size());
+		}
+		repetitions += 16;
+		endTime = std::clock();
+	}
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)buffer.size());
+}
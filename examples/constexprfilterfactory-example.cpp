@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// constexprfilterfactory-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 -std=c++14 constexprfilterfactory-example.cpp -I ../include -o constexprfilterfactory-example.exe -lm -static
+// Run: ./constexprfilterfactory-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "ConstexprFilterFactory.h"
+#include "FirFilter.h"
+
+// Designed by the compiler - filters either side of the unrolling limit
+static constexpr std::array<float, 9> shortCoefficients = 
+	ConstexprFilterFactory::createFilterWeights<float, 8>(
+		FilterWindowType::HAMMING, FilterType::LOWPASS, 48000.0, 4000.0);
+
+static constexpr std::array<float, 33> lowpassCoefficients = 
+	ConstexprFilterFactory::createFilterWeights<float, 32>(
+		FilterWindowType::HAMMING, FilterType::LOWPASS, 48000.0, 4000.0);
+
+static constexpr std::array<float, 129> longCoefficients = 
+	ConstexprFilterFactory::createFilterWeights<float, 128>(
+		FilterWindowType::HAMMING, FilterType::LOWPASS, 48000.0, 4000.0);
+
+//! Largest difference allowed from the runtime design
+#define COEFFICIENT_TOLERANCE 1.0e-6f
+
+//! Largest difference allowed between the filter outputs
+#define OUTPUT_TOLERANCE 1.0e-5f
+
+//! Time a filter, ns per sample
+template <typename FilterType>
+double timeFilter(FilterType& filter, std::vector<float>& buffer, int repetitions)
+{
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		buffer[0] = (float)r;
+		filter.processBlock(&buffer[0], &buffer[0], buffer.size());
+	}
+	std::clock_t endTime = std::clock();
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)buffer.size());
+}
+
+//! Check a compile time design against the runtime one and time the two 
+//! filters - returns false if the check fails
+template <size_t Taps, const std::array<float, Taps>& Coefficients>
+bool compareFilters()
+{
+	int order = (int)Taps - 1;
+
+	FilterFactory filterFactory;
+	FilterHolderType filter = filterFactory.createFilter(
+						order, FilterWindowType::HAMMING, FilterType::LOWPASS,
+						48000.0, 4000.0);
+
+	float maxDifference = 0.0f;
+	for(size_t n = 0; n < Taps; n++)
+	{
+		float difference = fabs(Coefficients[n] - filter.coefficients[n]);
+		if( difference > maxDifference )
+		{
+			maxDifference = difference;
+		}
+	}
+
+	FixedFirFilter<float, Taps, Coefficients> fixedFilter;
+	FirFilter<float> firFilter(filter);
+
+	float maxOutputDifference = 0.0f;
+	for( int i = 0; i < 4096; i++ )
+	{
+		float input = (float)((i * 7919) % 101) / 50.0f - 1.0f;
+		float difference = fabs(fixedFilter.processOne(input) - firFilter.processOne(input));
+		if( difference > maxOutputDifference )
+		{
+			maxOutputDifference = difference;
+		}
+	}
+
+	bool passed = (maxDifference <= COEFFICIENT_TOLERANCE) 
+		&& (maxOutputDifference <= OUTPUT_TOLERANCE);
+
+	std::cout << "order=" << order 
+			  << (Taps <= CONSTEXPRFILTERFACTORY_UNROLL_TAPS ? " (unrolled)" : " (DotProduct)")
+			  << " maximum difference to runtime design=" << maxDifference
+			  << " outputs=" << maxOutputDifference
+			  << (passed ? " OK" : " FAILED") << std::endl;
+
+	std::vector<float> buffer(1024, 0.0f);
+	int repetitions = 1000000 / (int)Taps;
+
+	double runtimeTimeNs = timeFilter(firFilter, buffer, repetitions);
+	double fixedTimeNs = timeFilter(fixedFilter, buffer, repetitions);
+
+	std::cout << "Time per sample: FirFilter = " << runtimeTimeNs << " ns"
+			  << " FixedFirFilter = " << fixedTimeNs << " ns" << std::endl << std::endl;
+
+	return passed;
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "ConstexprFilterFactory example usage" << std::endl << std::endl;
+
+	std::cout << "Compile time coefficients=[";
+	for(size_t n = 0; n < lowpassCoefficients.size(); n++)
+	{
+		std::cout << lowpassCoefficients[n];
+
+		if( n < (lowpassCoefficients.size()-1) )
+		{
+			std::cout << ", ";
+		}
+	}
+	std::cout << "]" << std::endl << std::endl;
+
+	bool passed = compareFilters<9, shortCoefficients>();
+	passed = compareFilters<33, lowpassCoefficients>() && passed;
+	passed = compareFilters<129, longCoefficients>() && passed;
+
+	return passed ? 0 : 1;
+}
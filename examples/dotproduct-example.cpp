@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// dotproduct-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 dotproduct-example.cpp -I ../include -o dotproduct-example.exe -lm -static
+// Run: ./dotproduct-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "DotProduct.h"
+
+template <typename DataType>
+void doTimingComparisons(const char * typeName, size_t length, int repetitions);
+
+const char * simdLevelName(SimdLevel::Type level);
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "DotProduct example usage" << std::endl << std::endl;
+
+	std::cout << "Detected SIMD level: " << simdLevelName(DotProduct::detectSimdLevel())
+			  << std::endl << std::endl;
+
+	doTimingComparisons<float>("float", 256, 1000000);
+	doTimingComparisons<double>("double", 256, 1000000);
+	doTimingComparisons<int16_t>("int16", 256, 1000000);
+
+	return 0;
+}
+
+//! Name of a SIMD level
+const char * simdLevelName(SimdLevel::Type level)
+{
+	switch( level )
+	{
+		case SimdLevel::SSE2: return "SSE2";
+		case SimdLevel::AVX2: return "AVX2";
+		case SimdLevel::AVX512: return "AVX-512";
+		default: return "Scalar";
+	}
+}
+
+//! Time each SIMD level against the scalar result
+template <typename DataType>
+void doTimingComparisons(const char * typeName, size_t length, int repetitions)
+{
+	// Small values so the int16 sums stay in range
+	std::vector<DataType> x(length);
+	std::vector<DataType> h(length);
+	for( size_t i = 0; i < length; i++ )
+	{
+		x[i] = (DataType)((int)(i % 7) - 3);
+		h[i] = (DataType)((int)(i % 5) - 2);
+	}
+
+	std::cout << "Timing comparisons: type=" << typeName
+			  << " length=" << length
+			  << " repetitions=" << repetitions << std::endl;
+
+	SimdLevel::Type detected = DotProduct::detectSimdLevel();
+	DataType reference = 0;
+
+	for( int level = SimdLevel::SCALAR; level <= detected; level++ )
+	{
+		DotProduct::setSimdLevel((SimdLevel::Type)level);
+
+		// Vary the start so the loop is not optimised away
+		volatile DataType result = 0;
+
+		std::clock_t startTime = std::clock();
+		for( int r = 0; r < repetitions; r++ )
+		{
+			result = result + DotProduct::dot(&x[0], &h[0], length - (r & 1));
+		}
+		std::clock_t endTime = std::clock();
+
+		double timeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+						/ (double)repetitions;
+
+		DataType value = DotProduct::dot(&x[0], &h[0], length);
+		if( level == SimdLevel::SCALAR )
+		{
+			reference = value;
+		}
+
+		std::cout << simdLevelName((SimdLevel::Type)level) << " = " << timeNs << " ns"
+				  << " result=" << (double)value
+				  << ((value == reference) ? "" : " MISMATCH") << std::endl;
+	}
+
+	DotProduct::setSimdLevel(detected);
+	std::cout << std::endl;
+}
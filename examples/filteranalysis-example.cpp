@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// filteranalysis-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 filteranalysis-example.cpp -I ../include -o filteranalysis-example.exe -lm -static
+// Run: ./filteranalysis-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FilterAnalysis.h"
+#include "FilterFactory.h"
+
+//! Direct evaluation of |H(f)| at pointCount frequencies - O(N.F)
+double directPeakError(const FilterHolderType& filter, const std::vector<float>& magnitude)
+{
+	size_t pointCount = magnitude.size();
+	double peakError = 0.0;
+
+	for( size_t k = 0; k < pointCount; k++ )
+	{
+		double w = M_PI * (double)k / (double)(pointCount - 1);
+		double re = 0.0;
+		double im = 0.0;
+		for( size_t n = 0; n < filter.coefficients.size(); n++ )
+		{
+			re += filter.coefficients[n] * cos(w * (double)n);
+			im -= filter.coefficients[n] * sin(w * (double)n);
+		}
+
+		double error = fabs(sqrt(re * re + im * im) - magnitude[k]);
+		peakError = (error > peakError) ? error : peakError;
+	}
+
+	return peakError;
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FilterAnalysis example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	int order = 64;
+	Float fSampling = 48000.0;
+	Float fCut1 = 4000.0;
+	Float fCut2 = 8000.0;
+
+	FilterHolderType bandpassFilter = filterFactory.createFilter(
+						order, FilterWindowType::HAMMING, FilterType::BANDPASS,
+						fSampling, fCut1, fCut2);
+
+	// Response on a 1025 point grid
+	FilterAnalysis<float> analysis(1025);
+	FrequencyResponseType<float> response;
+	analysis.frequencyResponse(bandpassFilter, fSampling, response);
+
+	std::cout << "Bandpass order=" << order << " FFT size=" << analysis.fftSize() << std::endl;
+	for( size_t k = 0; k < response.frequency.size(); k += 100 )
+	{
+		std::cout << "f=" << response.frequency[k] 
+				  << " |H|=" << (20.0 * log10(response.magnitude[k] + 1e-12)) << " dB"
+				  << " phase=" << response.phase[k] 
+				  << " group delay=" << response.groupDelay[k] << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Ripple and attenuation against a specification
+	FilterSpecificationType specification;
+	specification.filterType = FilterType::LOWPASS;
+	specification.Fs = fSampling;
+	specification.Fc1 = 4000.0;
+	specification.Fc2 = 0.0;
+	specification.passbandRippleDb = 0.1;
+	specification.stopbandAttenuationDb = 80.0;
+	specification.transitionWidth = 1000.0;
+
+	FilterHolderType kaiserFilter = filterFactory.createKaiserFilter(specification);
+	FilterResponseType measured = analysis.measureResponse(kaiserFilter, specification);
+
+	std::cout << "Kaiser lowpass order=" << measured.order 
+			  << " ripple=" << measured.passbandRippleDb << " dB"
+			  << " attenuation=" << measured.stopbandAttenuationDb << " dB"
+			  << " meets specification=" << (measured.meetsSpecification ? "yes" : "no") 
+			  << std::endl << std::endl;
+
+	// Timing comparison against direct evaluation
+	int orders[] = { 64, 256, 1024 };
+	size_t pointCount = 4097;
+	FilterAnalysis<float> timedAnalysis(pointCount);
+	std::vector<float> magnitude;
+
+	std::cout << "Timing comparisons: points=" << pointCount << std::endl;
+
+	for( int i = 0; i < 3; i++ )
+	{
+		FilterHolderType filter = filterFactory.createFilter(
+						orders[i], FilterWindowType::BLACKMAN, FilterType::LOWPASS,
+						fSampling, fCut1);
+
+		std::clock_t startTime = std::clock();
+		timedAnalysis.magnitudeResponse(filter, magnitude);
+		std::clock_t endTime = std::clock();
+		double fftTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+		startTime = std::clock();
+		double peakError = directPeakError(filter, magnitude);
+		endTime = std::clock();
+		double directTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+		std::cout << "order=" << orders[i] 
+				  << " FFT = " << (1000000000.0 * fftTime / (double)pointCount) << " ns/point"
+				  << " Direct = " << (1000000000.0 * directTime / (double)pointCount) << " ns/point" 
+				  << " peak difference = " << peakError
+				  << std::endl;
+	}
+
+	return 0;
+}
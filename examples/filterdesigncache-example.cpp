@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// filterdesigncache-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 -std=c++11 filterdesigncache-example.cpp -I ../include -o filterdesigncache-example.exe -lm -pthread
+// Run: ./filterdesigncache-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+
+#include "FilterDesignCache.h"
+#include "FilterFactory.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FilterDesignCache example usage" << std::endl << std::endl;
+
+	FilterFactory filterFactory;
+	FilterDesignCache filterDesignCache(16);
+
+	// Many channels opening with the same bandpass design
+	int channels = 256;
+	int order = 1024;
+	Float fSampling = 48000.0;
+	Float fCutLow = 8000.0;
+	Float fCutHigh = 16000.0;
+
+	std::clock_t startTime = std::clock();
+	for( int c = 0; c < channels; c++ )
+	{
+		FilterHolderType filter = filterFactory.createFilter(order, FilterWindowType::HAMMING, 
+								FilterType::BANDPASS, fSampling, fCutLow, fCutHigh);
+	}
+	std::clock_t endTime = std::clock();
+	double uncachedTimeMs = 1000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	startTime = std::clock();
+	for( int c = 0; c < channels; c++ )
+	{
+		FilterDesignCache::CoefficientsPointer coefficients = filterDesignCache.getFilterWeights(
+								order, FilterWindowType::HAMMING, FilterType::BANDPASS, 
+								fSampling, fCutLow, fCutHigh);
+	}
+	endTime = std::clock();
+	double cachedTimeMs = 1000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	FilterDesignCacheStatistics statistics = filterDesignCache.statistics();
+
+	std::cout << "Designs for " << channels << " channels, order=" << order << std::endl;
+	std::cout << "Uncached = " << uncachedTimeMs << " ms" << std::endl;
+	std::cout << "Cached = " << cachedTimeMs << " ms" << std::endl;
+	std::cout << "hits=" << statistics.hits
+			  << " misses=" << statistics.misses
+			  << " evictions=" << statistics.evictions
+			  << " size=" << statistics.size << std::endl;
+
+	return 0;
+}
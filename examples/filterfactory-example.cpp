@@ -111,5 +111,60 @@ int main(int argc, char** argv)
 	}
 	std::cout << "]" << std::endl << std::endl;
 
+	// Minimum order Kaiser design from a specification
+	FilterSpecificationType specification;
+	specification.filterType = FilterType::LOWPASS;
+	specification.Fs = 48000.0;
+	specification.Fc1 = 4000.0;
+	specification.Fc2 = 0.0;
+	specification.passbandRippleDb = 0.1;
+	specification.stopbandAttenuationDb = 60.0;
+	specification.transitionWidth = 1000.0;
+
+	FilterResponseType response;
+	FilterHolderType kaiserFilter = filterFactory.createKaiserFilter(specification, &response);
+
+	std::cout << "Kaiser Lowpass Filter: fCut=" << specification.Fc1
+			  << "Hz ripple<=" << specification.passbandRippleDb
+			  << "dB attenuation>=" << specification.stopbandAttenuationDb
+			  << "dB transition=" << specification.transitionWidth << "Hz" << std::endl;
+	std::cout << "estimated order=" << FilterFactory::estimateKaiserOrder(specification)
+			  << " minimum order=" << response.order
+			  << " beta=" << response.kaiserBeta
+			  << " achieved ripple=" << response.passbandRippleDb
+			  << "dB attenuation=" << response.stopbandAttenuationDb << "dB" << std::endl;
+
+	// Smallest order meeting the same specification with the fixed windows
+	FilterWindowType::Type windows[] = { FilterWindowType::HAMMING, FilterWindowType::BLACKMAN };
+	const char* windowNames[] = { "HAMMING", "BLACKMAN" };
+
+	for( int w = 0; w < 2; w++ )
+	{
+		int fixedOrder = 2;
+		bool met = false;
+		for( ; fixedOrder <= 4096; fixedOrder += 2 )
+		{
+			FilterHolderType fixedFilter = filterFactory.createFilter(fixedOrder, windows[w], 
+								specification.filterType, specification.Fs, specification.Fc1);
+			if( FilterFactory::measureResponse(fixedFilter, specification).meetsSpecification )
+			{
+				met = true;
+				break;
+			}
+		}
+
+		std::cout << windowNames[w] << " minimum order=";
+		if( met )
+		{
+			std::cout << fixedOrder;
+		}
+		else
+		{
+			std::cout << "none up to 4096";
+		}
+		std::cout << std::endl;
+	}
+	std::cout << std::endl;
+
 	return 0;
 }
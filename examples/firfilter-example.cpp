@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// firfilter-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ firfilter-example.cpp -I ../include -o firfilter-example.exe -lm -static
+// Run: ./firfilter-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+
+double timeFilter(FirFilter<float>& firFilter, std::vector<float>& buffer, int repetitions);
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FirFilter example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	// Filter order - must be even number.
+	int order = 8;
+
+	// Sample Frequency
+	Float fSampling = 48000.0;
+
+	// Cut frequency
+	Float fCut = 4000.0;
+
+	// Create Filter
+	FilterHolderType lowpassFilter = filterFactory.createFilter(
+						order, FilterWindowType::HAMMING, FilterType::LOWPASS,
+						fSampling, fCut);
+
+	// Create the streaming filter
+	FirFilter<float> firFilter(lowpassFilter);
+
+	// An impulse should give back the coefficients
+	std::vector<float> input(order+1, 0.0f);
+	std::vector<float> output(order+1, 0.0f);
+	input[0] = 1.0f;
+
+	firFilter.processBlock(&input[0], &output[0], input.size());
+
+	std::cout << "Impulse response=[";
+	for(size_t n = 0; n < output.size(); n++)
+	{
+		std::cout << output[n];
+
+		if( n < (output.size()-1) )
+		{
+			std::cout << ", ";
+		}
+	}
+	std::cout << "]" << std::endl;
+
+	std::cout << "coefficients=[";
+	for(size_t n = 0; n < lowpassFilter.coefficients.size(); n++)
+	{
+		std::cout << lowpassFilter.coefficients[n];
+
+		if( n < (lowpassFilter.coefficients.size()-1) )
+		{
+			std::cout << ", ";
+		}
+	}
+	std::cout << "]" << std::endl << std::endl;
+
+	// A step should settle at the DC gain of one
+	firFilter.reset();
+	std::vector<float> step(32, 1.0f);
+	firFilter.processBlock(&step[0], &step[0], step.size());
+
+	std::cout << "Step response settles at " << step[step.size()-1] << std::endl << std::endl;
+
+	// Timing comparison of the full and folded (symmetric) kernels
+	order = 512;
+	FilterHolderType longFilter = filterFactory.createFilter(
+						order, FilterWindowType::BLACKMAN, FilterType::LOWPASS,
+						fSampling, fCut);
+
+	FirFilter<float> fullFilter(longFilter, FirSymmetry::NONE);
+	FirFilter<float> foldedFilter(longFilter, FirSymmetry::AUTO);
+
+	std::vector<float> buffer(1024, 0.0f);
+	int repetitions = 1000;
+
+	std::cout << "Timing comparisons: order=" << order
+			  << " folded=" << foldedFilter.isFolded() << std::endl;
+	std::cout << "Full = " << timeFilter(fullFilter, buffer, repetitions) << " ns/sample" << std::endl;
+	std::cout << "Folded = " << timeFilter(foldedFilter, buffer, repetitions) << " ns/sample" << std::endl;
+
+	return 0;
+}
+
+//! Time per sample to filter a buffer repeatedly
+double timeFilter(FirFilter<float>& firFilter, std::vector<float>& buffer, int repetitions)
+{
+	std::clock_t startTime = std::clock();
+
+	for( int r = 0; r < repetitions; r++ )
+	{
+		buffer[0] = (float)r;
+		firFilter.processBlock(&buffer[0], &buffer[0], buffer.size());
+	}
+
+	std::clock_t endTime = std::clock();
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)buffer.size());
+}
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// firfilterbank-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 firfilterbank-example.cpp -I ../include -o firfilterbank-example.exe -lm -static
+// Run: ./firfilterbank-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+#include "FirFilterBank.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FirFilterBank example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	int order = 128;
+	Float fSampling = 48000.0;
+	Float fCut = 4000.0;
+
+	FilterHolderType lowpassFilter = filterFactory.createFilter(
+						order, FilterWindowType::HAMMING, FilterType::LOWPASS,
+						fSampling, fCut);
+
+	// Four channels, interleaved, each with a different step height
+	size_t channels = 4;
+	size_t frames = order + 1;
+	FirFilterBank<float> smallBank(lowpassFilter, channels);
+
+	std::vector<float> interleaved(frames * channels);
+	for( size_t frame = 0; frame < frames; frame++ )
+	{
+		for( size_t c = 0; c < channels; c++ )
+		{
+			interleaved[frame * channels + c] = (float)(c + 1);
+		}
+	}
+	smallBank.processInterleaved(&interleaved[0], &interleaved[0], frames);
+
+	std::cout << "Step responses settle at [";
+	for( size_t c = 0; c < channels; c++ )
+	{
+		std::cout << interleaved[(frames - 1) * channels + c];
+
+		if( c < (channels - 1) )
+		{
+			std::cout << ", ";
+		}
+	}
+	std::cout << "]" << std::endl << std::endl;
+
+	// Timing comparison against one FirFilter per channel
+	size_t channelCounts[] = { 32, 64, 128 };
+	frames = 4800;
+
+	std::cout << "Timing comparisons: order=" << order << std::endl;
+
+	for( int i = 0; i < 3; i++ )
+	{
+		channels = channelCounts[i];
+
+		// Bank - planar buffers
+		std::vector<std::vector<float> > planes(channels, std::vector<float>(frames, 0.5f));
+		std::vector<float*> planePointers(channels);
+		for( size_t c = 0; c < channels; c++ )
+		{
+			planePointers[c] = &planes[c][0];
+		}
+
+		FirFilterBank<float> bank(lowpassFilter, channels);
+
+		std::clock_t startTime = std::clock();
+		bank.processPlanar(&planePointers[0], &planePointers[0], frames);
+		std::clock_t endTime = std::clock();
+		double bankTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+		// One FirFilter per channel
+		std::vector<FirFilter<float>*> filters(channels);
+		for( size_t c = 0; c < channels; c++ )
+		{
+			filters[c] = new FirFilter<float>(lowpassFilter);
+		}
+
+		startTime = std::clock();
+		for( size_t c = 0; c < channels; c++ )
+		{
+			filters[c]->processBlock(&planes[c][0], &planes[c][0], frames);
+		}
+		endTime = std::clock();
+		double filtersTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+		for( size_t c = 0; c < channels; c++ )
+		{
+			delete filters[c];
+		}
+
+		std::cout << "channels=" << channels 
+				  << " FirFilterBank = " << (1000000000.0 * bankTime / (double)frames) << " ns/frame"
+				  << " FirFilter per channel = " << (1000000000.0 * filtersTime / (double)frames) << " ns/frame" 
+				  << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// fixedpointfirfilter-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 fixedpointfirfilter-example.cpp -I ../include -o fixedpointfirfilter-example.exe -lm -static
+// Run: ./fixedpointfirfilter-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+#include "FixedPointFirFilter.h"
+
+void printReport(const char* name, const QuantisedFilterHolderType& quantised);
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FixedPointFirFilter example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	int order = 128;
+	Float fSampling = 48000.0;
+	Float fCut = 4000.0;
+
+	FilterHolderType lowpassFilter = filterFactory.createFilter(
+						order, FilterWindowType::HAMMING, FilterType::LOWPASS,
+						fSampling, fCut);
+
+	// Quantise and report the headroom needed
+	QuantisedFilterHolderType q15 = FilterFactory::quantiseFilter(lowpassFilter, 15);
+	QuantisedFilterHolderType q15Scaled = FilterFactory::quantiseFilter(lowpassFilter, 15, true);
+	QuantisedFilterHolderType q31 = FilterFactory::quantiseFilter(lowpassFilter, 31);
+
+	printReport("Q15", q15);
+	printReport("Q15 scaled for headroom", q15Scaled);
+	printReport("Q31", q31);
+	std::cout << std::endl;
+
+	// int16 PCM in and out - a full scale square wave overshoots
+	std::vector<int16_t> input(48000);
+	for( size_t n = 0; n < input.size(); n++ )
+	{
+		input[n] = ((n / 48) % 2) ? 32767 : -32768;
+	}
+	std::vector<int16_t> output(input.size());
+
+	FixedPointFirFilter q15Filter(q15);
+	FixedPointFirFilter q15ScaledFilter(q15Scaled);
+	FixedPointFirFilter q31Filter(q31);
+
+	std::clock_t startTime = std::clock();
+	q15Filter.processBlock(&input[0], &output[0], input.size());
+	std::clock_t endTime = std::clock();
+	double q15Time = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	q15ScaledFilter.processBlock(&input[0], &output[0], input.size());
+
+	startTime = std::clock();
+	q31Filter.processBlock(&input[0], &output[0], input.size());
+	endTime = std::clock();
+	double q31Time = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	std::cout << "Saturated outputs: Q15=" << q15Filter.saturationCount()
+			  << " Q15 scaled=" << q15ScaledFilter.saturationCount()
+			  << " Q31=" << q31Filter.saturationCount() << std::endl << std::endl;
+
+	// The same through the float path, converting every sample in and out
+	FirFilter<float> floatFilter(lowpassFilter);
+	std::vector<float> buffer(input.size());
+
+	startTime = std::clock();
+	for( size_t n = 0; n < input.size(); n++ )
+	{
+		buffer[n] = (float)input[n];
+	}
+	floatFilter.processBlock(&buffer[0], &buffer[0], buffer.size());
+	for( size_t n = 0; n < input.size(); n++ )
+	{
+		float value = floor(buffer[n] + 0.5f);
+		output[n] = (value > 32767.0f) ? 32767 : ((value < -32768.0f) ? -32768 : (int16_t)value);
+	}
+	endTime = std::clock();
+	double floatTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	std::cout << "Timing comparisons: order=" << order << std::endl;
+	std::cout << "Q15 = " << (1000000000.0 * q15Time / (double)input.size()) << " ns/sample" << std::endl;
+	std::cout << "Q31 = " << (1000000000.0 * q31Time / (double)input.size()) << " ns/sample" << std::endl;
+	std::cout << "Float with conversion = " << (1000000000.0 * floatTime / (double)input.size()) << " ns/sample" << std::endl;
+
+	return 0;
+}
+
+//! Print the headroom analysis of a quantised filter
+void printReport(const char* name, const QuantisedFilterHolderType& quantised)
+{
+	std::cout << name << ": scale=" << quantised.scale
+			  << " sum|h|=" << quantised.absoluteSum
+			  << " headroomBits=" << quantised.headroomBits
+			  << " maxError=" << quantised.maxError << std::endl;
+}
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// fractionaldelay-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 fractionaldelay-example.cpp -I ../include -o fractionaldelay-example.exe -lm -static
+// Run: ./fractionaldelay-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FractionalDelay.h"
+#include "MirroredDelayLine.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "FractionalDelay example usage" << std::endl << std::endl;
+
+	const char* names[] = { "LINEAR", "LAGRANGE", "SINC" };
+
+	// Accuracy: a sine read at fractional delays
+	size_t lineLength = 1024;
+	MirroredDelayLine<float> delayLine(lineLength, 0.0f);
+	double w = 0.2 * M_PI;
+	for( size_t n = 0; n < lineLength; n++ )
+	{
+		delayLine.append((float)sin(w * (double)n));
+	}
+
+	size_t tapCount = 200;
+	std::vector<double> delays(tapCount);
+	for( size_t t = 0; t < tapCount; t++ )
+	{
+		delays[t] = 4.0 + 3.917 * (double)t;
+	}
+
+	std::vector<float> output(tapCount);
+
+	std::cout << "Sine at 0.1 Fs, peak error over " << tapCount << " fractional delays" << std::endl;
+	for( int i = 0; i < 3; i++ )
+	{
+		FractionalTapSet<float> taps((InterpolationType::Type)i, lineLength);
+		taps.setDelays(&delays[0], tapCount);
+		taps.read(delayLine, &output[0]);
+
+		double peakError = 0.0;
+		for( size_t t = 0; t < tapCount; t++ )
+		{
+			double expected = sin(w * ((double)(lineLength - 1) - delays[t]));
+			double error = fabs(expected - output[t]);
+			peakError = (error > peakError) ? error : peakError;
+		}
+
+		std::cout << names[i] << " points=" << taps.pointCount() 
+				  << " latency=" << taps.minimumDelay() << " samples"
+				  << " peak error=" << peakError << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Timing: 64 elements, each with 256 steering delays, every block
+	size_t elementCount = 64;
+	size_t beamCount = 256;
+	int blocks = 2000;
+
+	std::vector< MirroredDelayLine<float>* > elements(elementCount);
+	std::vector< FractionalTapSet<float>* > steering(elementCount);
+	std::vector<float> beams(elementCount * beamCount);
+	std::vector<double> elementDelays(beamCount);
+
+	for( int i = 0; i < 3; i++ )
+	{
+		for( size_t e = 0; e < elementCount; e++ )
+		{
+			elements[e] = new MirroredDelayLine<float>(lineLength, 0.0f);
+			for( size_t n = 0; n < lineLength; n++ )
+			{
+				elements[e]->append((float)sin(w * (double)(n + e)));
+			}
+
+			for( size_t b = 0; b < beamCount; b++ )
+			{
+				elementDelays[b] = 8.0 + 100.0 * (1.0 + sin((double)b * 0.01 + (double)e * 0.1));
+			}
+			steering[e] = new FractionalTapSet<float>((InterpolationType::Type)i, lineLength);
+			steering[e]->setDelays(&elementDelays[0], beamCount);
+		}
+
+		SimdLevel::Type levels[] = { SimdLevel::SCALAR, DotProduct::detectSimdLevel() };
+		const char* levelNames[] = { "scalar", "selected" };
+
+		for( int l = 0; l < 2; l++ )
+		{
+			DotProduct::setSimdLevel(levels[l]);
+
+			std::clock_t startTime = std::clock();
+			for( int r = 0; r < blocks; r++ )
+			{
+				for( size_t e = 0; e < elementCount; e++ )
+				{
+					steering[e]->read(*elements[e], &beams[e * beamCount]);
+				}
+			}
+			std::clock_t endTime = std::clock();
+			double timeNs = 1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+			std::cout << names[i] << " " << levelNames[l] << ": " 
+					  << (timeNs / ((double)blocks * (double)(elementCount * beamCount))) << " ns/tap, "
+					  << (timeNs / (double)blocks / 1000.0) << " us/block" << std::endl;
+		}
+
+		for( size_t e = 0; e < elementCount; e++ )
+		{
+			delete elements[e];
+			delete steering[e];
+		}
+	}
+
+	DotProduct::setSimdLevel(DotProduct::detectSimdLevel());
+
+	return 0;
+}
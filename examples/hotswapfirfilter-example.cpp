@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// hotswapfirfilter-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 -std=c++11 hotswapfirfilter-example.cpp -I ../include -o hotswapfirfilter-example.exe -lm -pthread
+// Run: ./hotswapfirfilter-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+#include "HotSwapFirFilter.h"
+
+//! Largest sample to sample step in a block
+float largestStep(const std::vector<float>& block)
+{
+	float largest = 0.0f;
+	for( size_t i = 1; i < block.size(); i++ )
+	{
+		float step = fabs(block[i] - block[i-1]);
+		largest = (step > largest) ? step : largest;
+	}
+	return largest;
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "HotSwapFirFilter example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	int order = 128;
+	Float fSampling = 48000.0;
+
+	FilterHolderType lowBand = filterFactory.createFilter(order, FilterWindowType::HAMMING, 
+						FilterType::BANDPASS, fSampling, 900.0, 1100.0);
+	FilterHolderType highBand = filterFactory.createFilter(order, FilterWindowType::HAMMING, 
+						FilterType::BANDPASS, fSampling, 1900.0, 2100.0);
+
+	// A 1 kHz and a 2 kHz tone: retuning from one band to the other swaps 
+	// which tone comes through
+	size_t blockLength = 4800;
+	std::vector<float> input(blockLength);
+	for( size_t n = 0; n < blockLength; n++ )
+	{
+		input[n] = (float)( sin(2.0 * M_PI * 1000.0 * (double)n / fSampling) + 
+							sin(2.0 * M_PI * 2000.0 * (double)n / fSampling) );
+	}
+
+	size_t crossfadeLengths[] = { 0, 480 };
+	for( int i = 0; i < 2; i++ )
+	{
+		HotSwapFirFilter<float> filter(lowBand, order + 1, crossfadeLengths[i]);
+		std::vector<float> output(blockLength + 1);
+
+		// Settle, retune, then run the block the swap lands in - keeping the
+		// last sample before the swap to see the step across it
+		filter.processBlock(&input[0], &output[0], blockLength);
+		output[0] = output[blockLength - 1];
+		filter.setFilter(highBand);
+		filter.processBlock(&input[0], &output[1], blockLength);
+
+		std::cout << "Crossfade=" << crossfadeLengths[i] << " samples:"
+				  << " swaps=" << filter.swapCount()
+				  << " largest step=" << largestStep(output) << std::endl;
+	}
+	std::cout << std::endl;
+
+	// A control thread retuning continuously while the audio thread runs
+	std::vector<FilterHolderType> designs;
+	for( int k = 0; k < 8; k++ )
+	{
+		Float fCentre = 1000.0 + 500.0 * (Float)k;
+		designs.push_back(filterFactory.createFilter(order, FilterWindowType::HAMMING, 
+						FilterType::BANDPASS, fSampling, fCentre - 100.0, fCentre + 100.0));
+	}
+
+	HotSwapFirFilter<float> liveFilter(designs[0], order + 1, 64);
+	std::atomic<bool> running(true);
+
+	std::thread control([&]()
+	{
+		int k = 0;
+		while( running )
+		{
+			liveFilter.setFilter(designs[k % designs.size()]);
+			k++;
+			std::this_thread::sleep_for(std::chrono::microseconds(500));
+		}
+	});
+
+	std::vector<float> output(blockLength);
+	int repetitions = 200;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		for( size_t offset = 0; offset < blockLength; offset += 480 )
+		{
+			liveFilter.processBlock(&input[offset], &output[offset], 480);
+		}
+	}
+	std::clock_t endTime = std::clock();
+	double liveTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	running = false;
+	control.join();
+
+	// The same blocks through a FirFilter that never changes
+	FirFilter<float> fixedFilter(designs[0]);
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		fixedFilter.processBlock(&input[0], &output[0], blockLength);
+	}
+	endTime = std::clock();
+	double fixedTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	double samples = (double)repetitions * (double)blockLength;
+	std::cout << "Swaps while running=" << liveFilter.swapCount() << std::endl;
+	std::cout << "Time per sample: order=" << order << std::endl;
+	std::cout << "HotSwapFirFilter = " << (1000000000.0 * liveTime / samples) << " ns" << std::endl;
+	std::cout << "FirFilter = " << (1000000000.0 * fixedTime / samples) << " ns" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// iirfilter-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 iirfilter-example.cpp -I ../include -o iirfilter-example.exe -lm -static
+// Run: ./iirfilter-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "BiquadFilterBank.h"
+#include "FilterFactory.h"
+#include "FirFilterBank.h"
+#include "IirFilterFactory.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "IirFilterFactory and BiquadFilterBank example usage" << std::endl << std::endl;
+
+	// The same specification for the FIR and the IIR designs
+	FilterSpecificationType specification;
+	specification.filterType = FilterType::LOWPASS;
+	specification.Fs = 48000.0;
+	specification.Fc1 = 4000.0;
+	specification.Fc2 = 0.0;
+	specification.passbandRippleDb = 0.5;
+	specification.stopbandAttenuationDb = 60.0;
+	specification.transitionWidth = 1000.0;
+
+	FilterFactory filterFactory;
+	FilterResponseType firResponse;
+	FilterHolderType firFilter = filterFactory.createKaiserFilter(specification, &firResponse);
+	std::cout << "Kaiser FIR: order=" << firFilter.order 
+			  << " MACs/sample=" << firFilter.coefficients.size() 
+			  << " attenuation=" << firResponse.stopbandAttenuationDb << " dB" << std::endl;
+
+	const char* names[] = { "Butterworth", "Chebyshev", "Elliptic" };
+	BiquadCascadeType cascades[3];
+	for( int p = 0; p < 3; p++ )
+	{
+		FilterResponseType response;
+		cascades[p] = IirFilterFactory::createFilter((IirPrototypeType::Type)p, 
+													 specification, &response);
+		std::cout << names[p] << " IIR: order=" << cascades[p].order 
+				  << " sections=" << cascades[p].sections.size()
+				  << " MACs/sample=" << (5 * cascades[p].sections.size())
+				  << " ripple=" << response.passbandRippleDb << " dB"
+				  << " attenuation=" << response.stopbandAttenuationDb << " dB" 
+				  << " meets specification=" << (response.meetsSpecification ? "yes" : "no") 
+				  << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Bandpass and bandstop from an order
+	BiquadCascadeType bandpass = IirFilterFactory::createFilter(IirPrototypeType::CHEBYSHEV, 
+		4, FilterType::BANDPASS, 48000.0, 2000.0, 4000.0, 0.5);
+	BiquadCascadeType bandstop = IirFilterFactory::createFilter(IirPrototypeType::ELLIPTIC, 
+		4, FilterType::BANDSTOP, 48000.0, 2000.0, 4000.0, 0.5, 60.0);
+
+	std::vector<double> bandpassMagnitude;
+	std::vector<double> bandstopMagnitude;
+	IirFilterFactory::magnitudeResponse(bandpass, 25, bandpassMagnitude);
+	IirFilterFactory::magnitudeResponse(bandstop, 25, bandstopMagnitude);
+
+	std::cout << "Chebyshev bandpass and elliptic bandstop, 2-4 kHz, order 4 prototypes" << std::endl;
+	for( size_t k = 0; k < 12; k++ )
+	{
+		std::cout << "f=" << (1000 * k) 
+				  << " bandpass=" << (20.0 * log10(bandpassMagnitude[k] + 1e-12)) << " dB"
+				  << " bandstop=" << (20.0 * log10(bandstopMagnitude[k] + 1e-12)) << " dB" 
+				  << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Timing comparison across channels
+	size_t channelCount = 16;
+	size_t frameCount = 48000;
+	std::vector<float> input(channelCount * frameCount);
+	std::vector<float> output(channelCount * frameCount);
+	for( size_t i = 0; i < input.size(); i++ )
+	{
+		input[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+	}
+
+	BiquadFilterBank<float> biquadBank(cascades[2], channelCount);
+	FirFilterBank<float> firBank(firFilter, channelCount);
+
+	std::clock_t startTime = std::clock();
+	biquadBank.processInterleaved(&input[0], &output[0], frameCount);
+	std::clock_t endTime = std::clock();
+	double biquadTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	startTime = std::clock();
+	firBank.processInterleaved(&input[0], &output[0], frameCount);
+	endTime = std::clock();
+	double firTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	double samples = (double)(channelCount * frameCount);
+	std::cout << "Timing comparisons: channels=" << channelCount << std::endl;
+	std::cout << "Elliptic BiquadFilterBank = " << (1000000000.0 * biquadTime / samples) << " ns/sample" 
+			  << std::endl;
+	std::cout << "Kaiser FirFilterBank = " << (1000000000.0 * firTime / samples) << " ns/sample" 
+			  << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// lineardelayline-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 lineardelayline-example.cpp -I ../include -o lineardelayline-example.exe -lm -static
+// Run: ./lineardelayline-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+#include "LinearDelayLine.h"
+#include "MirroredDelayLine.h"
+
+//! Time appends to a delay line, ns per append
+template <typename DelayLineType>
+double timeAppends(DelayLineType& delayLine, int repetitions)
+{
+	float check = 0.0f;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		delayLine.append((float)r);
+		check += delayLine.data()[0];
+	}
+	std::clock_t endTime = std::clock();
+
+	// Keep the reads
+	if( check == -1.0f )
+	{
+		std::cout << check << std::endl;
+	}
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+}
+
+//! Time a FirFilter, ns per sample
+template <typename FilterType>
+double timeFilter(FilterType& filter, std::vector<float>& samples, int repetitions)
+{
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		filter.processBlock(&samples[0], &samples[0], samples.size());
+	}
+	std::clock_t endTime = std::clock();
+
+	return (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) 
+		/ ((double)repetitions * (double)samples.size());
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "LinearDelayLine example usage" << std::endl << std::endl;
+
+	// Same contents as the mirrored delay line
+	LinearDelayLine<int> intDelayLine(5, 0, 3);
+	for( int i = 0; i < 8; i++ )
+	{
+		intDelayLine.append(i);
+		std::cout << i << " Contents=";
+		intDelayLine.debug_printContents();
+	}
+	std::cout << std::endl;
+
+	// Appends: mirrored (2N) against linear (N+B)
+	size_t lengths[] = { 64, 1024, 16384, 262144 };
+	size_t blocks[] = { 64, 1024, 16384 };
+	int repetitions = 20000000;
+
+	std::cout << "Time per delay line append operation." << std::endl;
+	for( int i = 0; i < 4; i++ )
+	{
+		size_t N = lengths[i];
+		MirroredDelayLine<float> mirrored(N, 0.0f);
+		std::cout << "N=" << N << " Mirrored (" << (2 * N) << " samples) = " 
+				  << timeAppends(mirrored, repetitions) << " ns" << std::endl;
+
+		for( int j = 0; j < 3; j++ )
+		{
+			size_t B = blocks[j];
+			LinearDelayLine<float> linear(N, 0.0f, B);
+			std::cout << "N=" << N << " Linear B=" << B << " (" << (N + B) << " samples) = " 
+					  << timeAppends(linear, repetitions) << " ns" << std::endl;
+		}
+	}
+	std::cout << std::endl;
+
+	// In a FirFilter
+	FilterFactory filterFactory;
+	int orders[] = { 63, 255, 1023 };
+	std::vector<float> samples(4096);
+	for( size_t i = 0; i < samples.size(); i++ )
+	{
+		samples[i] = (float)(i % 100) / 100.0f;
+	}
+
+	std::cout << "FirFilter time per sample." << std::endl;
+	for( int i = 0; i < 3; i++ )
+	{
+		FilterHolderType filter = filterFactory.createFilter(orders[i], 
+			FilterWindowType::HAMMING, FilterType::LOWPASS, 48000.0, 4000.0);
+		int filterRepetitions = 20000000 / (orders[i] + 1);
+
+		FirFilter<float> mirroredFilter(filter);
+		FirFilter<float, LinearDelayLine<float> > linearFilter(filter);
+
+		std::cout << "order=" << orders[i] 
+				  << " Mirrored = " << timeFilter(mirroredFilter, samples, filterRepetitions) << " ns"
+				  << " Linear B=" << LINEARDELAYLINE_DEFAULT_BLOCK << " = " 
+				  << timeFilter(linearFilter, samples, filterRepetitions) << " ns" << std::endl;
+	}
+
+	return 0;
+}
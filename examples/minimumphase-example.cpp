@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// minimumphase-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 minimumphase-example.cpp -I ../include -o minimumphase-example.exe -lm -static
+// Run: ./minimumphase-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "FirFilter.h"
+#include "MinimumPhase.h"
+
+//! Samples until the filtered step first reaches half of its final value
+size_t stepDelay(const FilterHolderType& filter)
+{
+	FirFilter<float> firFilter(filter);
+	double finalValue = 0.0;
+	for( size_t n = 0; n < filter.coefficients.size(); n++ )
+	{
+		finalValue += filter.coefficients[n];
+	}
+
+	for( size_t n = 0; n < 4 * filter.coefficients.size(); n++ )
+	{
+		if( firFilter.processOne(1.0f) >= 0.5 * finalValue )
+		{
+			return n;
+		}
+	}
+
+	return 0;
+}
+
+//! Print a report
+void printReport(const char* name, const MinimumPhaseReportType& report, double fSampling)
+{
+	std::cout << name 
+			  << " linear phase delay=" << report.linearPhaseDelay << " samples ("
+			  << (1000.0 * report.linearPhaseDelay / fSampling) << " ms)"
+			  << " minimum phase group delay=" << report.groupDelay << " samples ("
+			  << (1000.0 * report.groupDelaySeconds) << " ms)" << std::endl
+			  << "    peak tap=" << report.peakIndex 
+			  << " 99% energy by tap=" << report.energyIndex
+			  << " magnitude error=" << report.magnitudeErrorDb << " dB" << std::endl;
+}
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "MinimumPhase example usage" << std::endl << std::endl;
+
+	// Create a FilterFactory
+	FilterFactory filterFactory;
+
+	Float fSampling = 48000.0;
+
+	// Kaiser lowpass from a specification
+	FilterSpecificationType specification;
+	specification.filterType = FilterType::LOWPASS;
+	specification.Fs = fSampling;
+	specification.Fc1 = 4000.0;
+	specification.Fc2 = 0.0;
+	specification.passbandRippleDb = 0.1;
+	specification.stopbandAttenuationDb = 80.0;
+	specification.transitionWidth = 1000.0;
+
+	FilterHolderType lowpassFilter = filterFactory.createKaiserFilter(specification);
+
+	MinimumPhaseReportType report;
+	FilterHolderType minimumLowpass = MinimumPhase<float>::convert(lowpassFilter, &report, fSampling);
+	std::cout << "Kaiser lowpass order=" << lowpassFilter.order << std::endl;
+	printReport("   ", report, fSampling);
+
+	FilterResponseType original = FilterFactory::measureResponse(lowpassFilter, specification);
+	FilterResponseType converted = FilterFactory::measureResponse(minimumLowpass, specification);
+	std::cout << "    attenuation=" << original.stopbandAttenuationDb << " dB -> " 
+			  << converted.stopbandAttenuationDb << " dB"
+			  << " ripple=" << original.passbandRippleDb << " dB -> " 
+			  << converted.passbandRippleDb << " dB" << std::endl;
+	std::cout << "    step response half way: " << stepDelay(lowpassFilter) << " -> " 
+			  << stepDelay(minimumLowpass) << " samples" << std::endl << std::endl;
+
+	// Windowed bandpass
+	FilterHolderType bandpassFilter = filterFactory.createFilter(
+						128, FilterWindowType::HAMMING, FilterType::BANDPASS,
+						fSampling, 2000.0, 4000.0);
+	MinimumPhase<float>::convert(bandpassFilter, &report, fSampling);
+	std::cout << "Hamming bandpass order=" << bandpassFilter.order << std::endl;
+	printReport("   ", report, fSampling);
+
+	return 0;
+}
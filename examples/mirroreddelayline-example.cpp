@@ -39,6 +39,8 @@
 #include "MirroredDelayLine.h"
 
 void doTimingComparisons(size_t delayLineLength, int repetitions);
+void doMappedComparison(size_t pageCount, int repetitions);
+void doBlockComparison(size_t delayLineLength, size_t blockLength, int repetitions);
 
 //! Main Function
 int main(int argc, char** argv)
@@ -109,9 +111,58 @@ int main(int argc, char** argv)
 	repetitions = 10000000;
 	doTimingComparisons(delayLineLength, repetitions);
 
+	// A multi-second line, mapped against one sample longer (vector)
+	doMappedComparison(1024, 100000000);
+
+	// A capture block at a time
+	doBlockComparison(48000, 1024, 100000);
+
 	return 0;
 }
 
+void doMappedComparison(size_t pageCount, int repetitions)
+{
+	size_t pageLength = MirroredDelayLine<float>::pageLength();
+	if( pageLength == 0 )
+	{
+		std::cout << "Mapped delay lines are not available on this platform." << std::endl;
+		return;
+	}
+
+	size_t delayLineLength = pageCount * pageLength;
+	MirroredDelayLine<float> mappedDelayLine(delayLineLength, 0.0f);
+	MirroredDelayLine<float> vectorDelayLine(delayLineLength + 1, 0.0f);
+
+	std::cout << "Mapped comparison." << std::endl;
+	std::cout << "delayLineLength=" << delayLineLength 
+			  << " mapped=" << (mappedDelayLine.isMapped() ? "yes" : "no") 
+			  << " resident=" << (delayLineLength * sizeof(float) / 1024) << " kB" << std::endl;
+	std::cout << "delayLineLength=" << (delayLineLength + 1)
+			  << " mapped=" << (vectorDelayLine.isMapped() ? "yes" : "no") 
+			  << " resident=" << (2 * (delayLineLength + 1) * sizeof(float) / 1024) << " kB" << std::endl;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		mappedDelayLine.append((float)r);
+	}
+	std::clock_t endTime = std::clock();
+	double mappedTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		vectorDelayLine.append((float)r);
+	}
+	endTime = std::clock();
+	double vectorTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+
+	std::cout << "Time per delay line append operation. " << std::endl;
+	std::cout << "Mapped = " << mappedTimeNs << " ns" << std::endl;
+	std::cout << "Vector = " << vectorTimeNs << " ns" << std::endl;
+	std::cout << std::endl;
+}
+
 void doTimingComparisons(size_t delayLineLength, int repetitions)
 {
 	//size_t delayLineLength = 2000;
@@ -203,3 +254,42 @@ void doTimingComparisons(size_t delayLineLength, int repetitions)
 
 	return;
 }
+
+void doBlockComparison(size_t delayLineLength, size_t blockLength, int repetitions)
+{
+	std::vector<float> block(blockLength);
+	for( size_t i = 0; i < blockLength; i++ )
+	{
+		block[i] = (float)i;
+	}
+
+	MirroredDelayLine<float> sampleDelayLine(delayLineLength, 0.0f);
+	MirroredDelayLine<float> blockDelayLine(delayLineLength, 0.0f);
+
+	std::cout << "Block comparison." << std::endl;
+	std::cout << "delayLineLength=" << delayLineLength << " blockLength=" << blockLength << std::endl;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		for( size_t i = 0; i < blockLength; i++ )
+		{
+			sampleDelayLine.append(block[i]);
+		}
+	}
+	std::clock_t endTime = std::clock();
+	double sampleTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		blockDelayLine.appendBlock(&block[0], blockLength);
+	}
+	endTime = std::clock();
+	double blockTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC) / (double)repetitions;
+
+	std::cout << "Time per block. " << std::endl;
+	std::cout << "append() = " << sampleTimeNs << " ns" << std::endl;
+	std::cout << "appendBlock() = " << blockTimeNs << " ns" << std::endl;
+	std::cout << std::endl;
+}
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// multistagedecimator-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 multistagedecimator-example.cpp -I ../include -o multistagedecimator-example.exe -lm -static
+// Run: ./multistagedecimator-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "MultistageDecimator.h"
+#include "Polyphase.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "MultistageDecimator example usage" << std::endl << std::endl;
+
+	// 192 kHz to 2 kHz, keeping 0-800 Hz and stopping from 1 kHz
+	double inputRate = 192000.0;
+	double outputRate = 2000.0;
+
+	DecimationPlanType plan = MultistageDecimator<float>::plan(inputRate, outputRate, 
+									800.0, 1000.0, 0.1, 80.0);
+
+	std::cout << "Plan: " << plan.stages.size() << " stages" 
+			  << " meets specification=" << (plan.meetsSpecification ? "yes" : "no") << std::endl;
+	for( size_t i = 0; i < plan.stages.size(); i++ )
+	{
+		std::cout << "M=" << plan.stages[i].factor 
+				  << " Fs=" << plan.stages[i].inputRate 
+				  << " stopband=" << plan.stages[i].stopbandEdge 
+				  << " order=" << plan.stages[i].filter.order << std::endl;
+	}
+	std::cout << "MACs per output: cascade=" << plan.macsPerOutput 
+			  << " single stage=" << plan.singleStageMacsPerOutput << std::endl << std::endl;
+
+	// One second of a 500 Hz tone with a 1500 Hz tone that would alias onto it
+	size_t inputLength = (size_t)inputRate;
+	std::vector<float> input(inputLength);
+	for( size_t n = 0; n < inputLength; n++ )
+	{
+		input[n] = (float)( sin(2.0 * M_PI * 500.0 * (double)n / inputRate) + 
+							sin(2.0 * M_PI * 1500.0 * (double)n / inputRate) );
+	}
+
+	MultistageDecimator<float> cascade(plan);
+	std::vector<float> output(inputLength / cascade.factor());
+
+	std::clock_t startTime = std::clock();
+	size_t outputLength = cascade.process(&input[0], inputLength, &output[0]);
+	std::clock_t endTime = std::clock();
+	double cascadeTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	// RMS of the settled output should be the 500 Hz tone alone (0.707)
+	double sumSquares = 0.0;
+	for( size_t n = outputLength / 2; n < outputLength; n++ )
+	{
+		sumSquares += (double)output[n] * (double)output[n];
+	}
+	std::cout << "Outputs=" << outputLength 
+			  << " settled RMS=" << sqrt(sumSquares / (double)(outputLength - outputLength / 2)) 
+			  << std::endl << std::endl;
+
+	// The same specification in one stage
+	DoubleFilterSpecificationType specification;
+	specification.filterType = FilterType::LOWPASS;
+	specification.Fs = inputRate;
+	specification.Fc1 = 900.0;
+	specification.Fc2 = 0.0;
+	specification.passbandRippleDb = 0.1;
+	specification.stopbandAttenuationDb = 80.0;
+	specification.transitionWidth = 200.0;
+
+	DoubleFilterFactory filterFactory;
+	PolyphaseDecimator<float> single(BasicFilterHolderType<float>(
+						filterFactory.createKaiserFilter(specification)), cascade.factor());
+
+	startTime = std::clock();
+	single.process(&input[0], inputLength, &output[0]);
+	endTime = std::clock();
+	double singleTime = (double)(endTime - startTime) / (double)CLOCKS_PER_SEC;
+
+	std::cout << "Timing comparisons:" << std::endl;
+	std::cout << "Cascade = " << (1000000000.0 * cascadeTime / (double)outputLength) << " ns/output"
+			  << " Single stage = " << (1000000000.0 * singleTime / (double)outputLength) << " ns/output" 
+			  << std::endl;
+
+	return 0;
+}
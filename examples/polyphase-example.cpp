@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// polyphase-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 polyphase-example.cpp -I ../include -o polyphase-example.exe -lm -static
+// Run: ./polyphase-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "FirFilter.h"
+#include "MirroredFifo.h"
+#include "Polyphase.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "Polyphase example usage" << std::endl << std::endl;
+
+	size_t factor = 4;
+	int order = 128;
+
+	// Decimate a block of a slow sine wave through fifos
+	PolyphaseDecimator<float> decimator(factor, order);
+	PolyphaseInterpolator<float> interpolator(factor, order);
+
+	MirroredFifo<float> inputFifo(1024);
+	MirroredFifo<float> decimatedFifo(1024);
+	MirroredFifo<float> outputFifo(1024);
+
+	std::vector<float> input(1024);
+	for( size_t i = 0; i < input.size(); i++ )
+	{
+		input[i] = (float)sin(2.0 * M_PI * (double)i / 64.0);
+	}
+	inputFifo.write(input.size(), &input[0]);
+
+	size_t decimatedCount = decimator.process(inputFifo, decimatedFifo);
+	size_t interpolatedCount = interpolator.process(decimatedFifo, outputFifo);
+
+	std::cout << "Input=" << input.size()
+			  << " decimated=" << decimatedCount
+			  << " interpolated=" << interpolatedCount << std::endl;
+
+	// After the filter delays the sine should come back at the same amplitude
+	std::vector<float> output(outputFifo.canRead());
+	outputFifo.read(output.size(), &output[0]);
+
+	float peak = 0.0f;
+	for( size_t i = output.size()/2; i < output.size(); i++ )
+	{
+		if( output[i] > peak )
+		{
+			peak = output[i];
+		}
+	}
+	std::cout << "Round trip peak=" << peak << std::endl << std::endl;
+
+	// Timing comparison against filtering every sample then discarding
+	FilterFactory filterFactory;
+	FilterHolderType filter = filterFactory.createFilter(order, FilterWindowType::HAMMING, 
+							FilterType::LOWPASS, 1.0, 0.5 / (Float)factor);
+
+	FirFilter<float> firFilter(filter);
+	std::vector<float> filtered(input.size());
+	std::vector<float> decimated(input.size() / factor);
+	int repetitions = 2000;
+
+	std::clock_t startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		firFilter.processBlock(&input[0], &filtered[0], input.size());
+		for( size_t i = 0; i < decimated.size(); i++ )
+		{
+			decimated[i] = filtered[i*factor + factor - 1];
+		}
+	}
+	std::clock_t endTime = std::clock();
+	double discardTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)input.size());
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		decimator.process(&input[0], input.size(), &decimated[0]);
+	}
+	endTime = std::clock();
+	double polyphaseTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)input.size());
+
+	std::cout << "Time per input sample: factor=" << factor << " order=" << order << std::endl;
+	std::cout << "Filter and discard = " << discardTimeNs << " ns" << std::endl;
+	std::cout << "Polyphase = " << polyphaseTimeNs << " ns" << std::endl << std::endl;
+
+	// Decimate by 2 with a HALFBAND design, every other tap zero
+	int halfbandOrder = 62;
+	FilterHolderType halfbandFilter = filterFactory.createFilter(halfbandOrder, 
+							FilterWindowType::KAISER, FilterType::HALFBAND, 1.0);
+
+	PolyphaseDecimator<float> polyphaseHalfband(halfbandFilter, 2);
+	HalfbandDecimator<float> halfbandDecimator(halfbandFilter);
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		polyphaseHalfband.process(&input[0], input.size(), &filtered[0]);
+	}
+	endTime = std::clock();
+	polyphaseTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)input.size());
+
+	startTime = std::clock();
+	for( int r = 0; r < repetitions; r++ )
+	{
+		halfbandDecimator.process(&input[0], input.size(), &filtered[0]);
+	}
+	endTime = std::clock();
+	double halfbandTimeNs = (1000000000.0 * (double)(endTime - startTime) / (double)CLOCKS_PER_SEC)
+		/ ((double)repetitions * (double)input.size());
+
+	std::cout << "Time per input sample: factor=2 HALFBAND order=" << halfbandOrder << std::endl;
+	std::cout << "Polyphase = " << polyphaseTimeNs << " ns" << std::endl;
+	std::cout << "Halfband = " << halfbandTimeNs << " ns" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// resampler-example.cpp
+//
+//------------------------------------------------------------------------------
+//
+// Compile: g++ -O2 resampler-example.cpp -I ../include -o resampler-example.exe -lm -static
+// Run: ./resampler-example.exe
+//
+//------------------------------------------------------------------------------
+
+// Includes
+#include <iostream>
+#include <vector>
+
+#include "Resampler.h"
+#include "WavWriter.h"
+
+//! Main Function
+int main(int argc, char** argv)
+{
+	std::cout << "Resampler example usage" << std::endl << std::endl;
+
+	double inputRate = 48000.0;
+	double outputRate = 44100.0;
+
+	// Streaming: feed blocks of 480 samples of a 1kHz tone
+	Resampler<float> resampler(inputRate, outputRate);
+
+	std::cout << "Streaming " << inputRate << "Hz to " << outputRate << "Hz"
+			  << " tapsPerPhase=" << resampler.tapsPerPhase()
+			  << " latency=" << resampler.latency() << " samples" << std::endl;
+
+	size_t blockLength = 480;
+	std::vector<float> input(blockLength);
+	std::vector<float> output(resampler.maxOutputCount(blockLength));
+
+	size_t time = 0;
+	for( int block = 0; block < 5; block++ )
+	{
+		for( size_t i = 0; i < blockLength; i++ )
+		{
+			input[i] = (float)sin(2.0 * M_PI * 1000.0 * (double)time / inputRate);
+			time++;
+		}
+
+		size_t outputLength = resampler.process(&input[0], blockLength, &output[0]);
+
+		std::cout << "Block " << block << ": in=" << blockLength 
+				  << " out=" << outputLength << std::endl;
+	}
+	std::cout << std::endl;
+
+	// Offline: write a one second 440Hz tone at 48kHz and resample the file
+	std::vector<int16_t> tone((size_t)inputRate);
+	for( size_t i = 0; i < tone.size(); i++ )
+	{
+		tone[i] = (int16_t)(16000.0 * sin(2.0 * M_PI * 440.0 * (double)i / inputRate));
+	}
+	WavWriter::writeWav16(&tone[0], (uint32_t)tone.size(), (uint32_t)inputRate, "tone48000.wav");
+
+	bool ok = Resampler<float>::resampleWav16("tone48000.wav", "tone44100.wav", (uint32_t)outputRate);
+
+	uint32_t sampleRate = 0;
+	std::vector<int16_t> resampled = WavWriter::readWav16("tone44100.wav", sampleRate);
+
+	std::cout << "Offline tone48000.wav -> tone44100.wav ok=" << ok
+			  << " sampleRate=" << sampleRate
+			  << " samples=" << resampled.size() << std::endl;
+
+	return 0;
+}
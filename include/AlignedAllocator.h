@@ -0,0 +1,382 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// AlignedAllocator.h
+//
+//------------------------------------------------------------------------------
+//
+// Standard allocators for the storage of MirroredDelayLine, LinearDelayLine
+// and MirroredFifo.
+//
+// AlignedAllocator starts every allocation on an Alignment byte boundary (64 
+// by default, a cache line and an AVX-512 vector), so the start of the 
+// storage never splits a vector load across cache lines.
+//
+// HugePageAllocator does the same for small buffers, but backs allocations of
+// ALIGNEDALLOCATOR_HUGE_THRESHOLD bytes or more with huge pages, so a multi-
+// megabyte line needs a handful of TLB entries rather than hundreds. It asks
+// for explicit huge pages (MAP_HUGETLB) first, which need pages reserved in 
+// /proc/sys/vm/nr_hugepages, and otherwise maps ordinary pages and marks them
+// for transparent huge pages (madvise MADV_HUGEPAGE). On other platforms it 
+// is the AlignedAllocator.
+//
+// As with std::allocator a failed allocation throws std::bad_alloc.
+//
+//------------------------------------------------------------------------------
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+//! Default alignment in bytes
+#define ALIGNEDALLOCATOR_ALIGNMENT 64
+
+//! Allocations of at least this many bytes use huge pages
+#define ALIGNEDALLOCATOR_HUGE_THRESHOLD (2 * 1024 * 1024)
+
+//! Huge page size - mapped lengths are rounded up to a multiple of this
+#define ALIGNEDALLOCATOR_HUGE_PAGE (2 * 1024 * 1024)
+
+
+//! Aligned Allocator class - Alignment must be a power of two and a multiple
+//! of sizeof(void*)
+template <typename T, size_t Alignment = ALIGNEDALLOCATOR_ALIGNMENT>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    //! Rebind to another type with the same alignment
+    template <typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    //! Constructor
+    AlignedAllocator() {}
+
+    //! Converting Constructor
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    //! Address of an item
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    //! Allocate n items, aligned
+    pointer allocate(size_type n, const void * hint = 0);
+
+    //! Free n items from allocate()
+    void deallocate(pointer p, size_type n);
+
+    //! Largest n that can be allocated
+    size_type max_size() const { return ((size_type)-1) / sizeof(T); }
+
+    //! Construct an item in place
+    void construct(pointer p, const T& value) { new((void *)p) T(value); }
+
+    //! Destroy an item in place
+    void destroy(pointer p) { p->~T(); }
+
+    //! Aligned allocation of a number of bytes - NULL on failure
+    static void * allocateBytes(size_t bytes);
+
+    //! Free an allocation from allocateBytes()
+    static void deallocateBytes(void * p);
+
+}; // class AlignedAllocator
+
+
+//! Allocators are interchangeable if they have the same alignment
+template <typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+    return true;
+}
+
+template <typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+    return false;
+}
+
+
+//! Huge Page Allocator class - huge pages for large allocations, otherwise 
+//! the AlignedAllocator
+template <typename T, size_t Alignment = ALIGNEDALLOCATOR_ALIGNMENT>
+class HugePageAllocator
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    //! Rebind to another type with the same alignment
+    template <typename U>
+    struct rebind
+    {
+        typedef HugePageAllocator<U, Alignment> other;
+    };
+
+    //! Constructor
+    HugePageAllocator() {}
+
+    //! Converting Constructor
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment>&) {}
+
+    //! Address of an item
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    //! Allocate n items - huge pages if large enough
+    pointer allocate(size_type n, const void * hint = 0);
+
+    //! Free n items from allocate()
+    void deallocate(pointer p, size_type n);
+
+    //! Largest n that can be allocated
+    size_type max_size() const { return ((size_type)-1) / sizeof(T); }
+
+    //! Construct an item in place
+    void construct(pointer p, const T& value) { new((void *)p) T(value); }
+
+    //! Destroy an item in place
+    void destroy(pointer p) { p->~T(); }
+
+    //! Is an allocation of this many bytes mapped in huge pages
+    static bool isHuge(size_t bytes);
+
+}; // class HugePageAllocator
+
+
+//! Allocators are interchangeable if they have the same alignment
+template <typename T, typename U, size_t Alignment>
+bool operator==(const HugePageAllocator<T, Alignment>&, const HugePageAllocator<U, Alignment>&)
+{
+    return true;
+}
+
+template <typename T, typename U, size_t Alignment>
+bool operator!=(const HugePageAllocator<T, Alignment>&, const HugePageAllocator<U, Alignment>&)
+{
+    return false;
+}
+
+
+//------------------------------------------------------------------------------
+// AlignedAllocator
+//------------------------------------------------------------------------------
+
+//! Allocate n items, aligned
+template <typename T, size_t Alignment>
+typename AlignedAllocator<T, Alignment>::pointer AlignedAllocator<T, Alignment>::allocate(
+    size_type n, const void * /* hint = 0 */)
+{
+    if( n == 0 )
+    {
+        return NULL;
+    }
+
+    if( n > max_size() )
+    {
+        throw std::bad_alloc();
+    }
+
+    void * p = allocateBytes(n * sizeof(T));
+    if( p == NULL )
+    {
+        throw std::bad_alloc();
+    }
+
+    return (pointer)p;
+}
+
+
+//! Free n items from allocate()
+template <typename T, size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(pointer p, size_type /* n */)
+{
+    deallocateBytes(p);
+}
+
+
+//! Aligned allocation of a number of bytes - NULL on failure
+template <typename T, size_t Alignment>
+void * AlignedAllocator<T, Alignment>::allocateBytes(size_t bytes)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, Alignment);
+#else
+    void * p = NULL;
+    if( posix_memalign(&p, Alignment, bytes) != 0 )
+    {
+        return NULL;
+    }
+    return p;
+#endif
+}
+
+
+//! Free an allocation from allocateBytes()
+template <typename T, size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocateBytes(void * p)
+{
+    if( p == NULL )
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+// HugePageAllocator
+//------------------------------------------------------------------------------
+
+//! Allocate n items - huge pages if large enough
+template <typename T, size_t Alignment>
+typename HugePageAllocator<T, Alignment>::pointer HugePageAllocator<T, Alignment>::allocate(
+    size_type n, const void * /* hint = 0 */)
+{
+    if( n == 0 )
+    {
+        return NULL;
+    }
+
+    if( n > max_size() )
+    {
+        throw std::bad_alloc();
+    }
+
+    size_t bytes = n * sizeof(T);
+    void * p = NULL;
+
+#if defined(__linux__)
+    if( isHuge(bytes) )
+    {
+        size_t length = ((bytes + ALIGNEDALLOCATOR_HUGE_PAGE - 1) / ALIGNEDALLOCATOR_HUGE_PAGE) 
+            * ALIGNEDALLOCATOR_HUGE_PAGE;
+
+        p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+        p = mmap(NULL, length, PROT_READ | PROT_WRITE, 
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if( p == MAP_FAILED )
+        {
+            // No reserved huge pages - ask for transparent ones
+            p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+            if( p != MAP_FAILED )
+            {
+                madvise(p, length, MADV_HUGEPAGE);
+            }
+#endif
+        }
+
+        if( p == MAP_FAILED )
+        {
+            throw std::bad_alloc();
+        }
+
+        return (pointer)p;
+    }
+#endif
+
+    p = AlignedAllocator<T, Alignment>::allocateBytes(bytes);
+    if( p == NULL )
+    {
+        throw std::bad_alloc();
+    }
+
+    return (pointer)p;
+}
+
+
+//! Free n items from allocate()
+template <typename T, size_t Alignment>
+void HugePageAllocator<T, Alignment>::deallocate(pointer p, size_type n)
+{
+    if( p == NULL )
+    {
+        return;
+    }
+
+#if defined(__linux__)
+    size_t bytes = n * sizeof(T);
+    if( isHuge(bytes) )
+    {
+        size_t length = ((bytes + ALIGNEDALLOCATOR_HUGE_PAGE - 1) / ALIGNEDALLOCATOR_HUGE_PAGE) 
+            * ALIGNEDALLOCATOR_HUGE_PAGE;
+        munmap((void *)p, length);
+        return;
+    }
+#endif
+
+    AlignedAllocator<T, Alignment>::deallocateBytes(p);
+}
+
+
+//! Is an allocation of this many bytes mapped in huge pages
+template <typename T, size_t Alignment>
+bool HugePageAllocator<T, Alignment>::isHuge(size_t bytes)
+{
+#if defined(__linux__)
+    return (bytes >= ALIGNEDALLOCATOR_HUGE_THRESHOLD);
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+
+#endif // ALIGNEDALLOCATOR_H
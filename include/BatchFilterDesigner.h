@@ -0,0 +1,461 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// BatchFilterDesigner.h
+//
+//------------------------------------------------------------------------------
+//
+// Designs many filters at once across a pool of threads, writing all the
+// coefficients into one contiguous FilterArena rather than a vector each.
+//
+// Every design's order is known up front, so the arena is sized and each
+// design given its offset before any work starts; the threads then write 
+// into disjoint parts of it with no further coordination.
+//
+// The designs are shared out by work stealing. Each thread starts with an 
+// even share of the indices, packed as [begin, end) into one 64-bit atomic.
+// The owner takes designs one at a time from the front. A thread that runs 
+// out takes the back half of the first other share that still has work, so
+// a few long designs in one share do not leave the other threads idle. Only
+// compare-and-swap on the shares is used while designing; the mutex and 
+// condition variables are only for starting and finishing a batch. The 
+// calling thread works on the batch too.
+//
+// Requires C++11.
+//
+//------------------------------------------------------------------------------
+
+#ifndef BATCHFILTERDESIGNER_H
+#define BATCHFILTERDESIGNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include "FilterFactory.h"
+
+
+//! Filter Design struct - the arguments to FilterFactory::createFilter
+template <typename T>
+struct BasicFilterDesignType
+{
+    int order;
+    FilterWindowType::Type windowType;
+    FilterType::Type filterType;
+    T Fs;
+    T Fc1;
+    T Fc2;
+    T kaiserBeta;    //!< Only used by KAISER windows
+};
+
+//! Single precision design
+typedef BasicFilterDesignType<float> FilterDesignType;
+
+//! Double precision design
+typedef BasicFilterDesignType<double> DoubleFilterDesignType;
+
+
+template <typename T> class BasicBatchFilterDesigner;
+
+
+//! Filter Arena class - the coefficients of a batch of designs, contiguous
+template <typename T>
+class BasicFilterArena
+{
+public:
+    //! Constructor - empty
+    BasicFilterArena() {}
+
+    //! Number of designs
+    size_t size() const { return m_orders.size(); }
+
+    //! Total coefficients over all designs
+    size_t totalLength() const { return m_coefficients.size(); }
+
+    //! Order of design index
+    int order(size_t index) const { return m_orders[index]; }
+
+    //! Number of taps of design index
+    size_t length(size_t index) const { return m_offsets[index + 1] - m_offsets[index]; }
+
+    //! Coefficients of design index - length(index) of them
+    const T * coefficients(size_t index) const { return &m_coefficients[m_offsets[index]]; }
+
+    //! Copy of design index as a holder, for the filters that take one
+    BasicFilterHolderType<T> filter(size_t index) const;
+
+private:
+    friend class BasicBatchFilterDesigner<T>;
+
+    //! All coefficients, design after design
+    std::vector<T> m_coefficients;
+
+    //! Start of each design, plus the end of the last
+    std::vector<size_t> m_offsets;
+
+    //! Order of each design
+    std::vector<int> m_orders;
+
+}; // class BasicFilterArena
+
+//! Single precision arena
+typedef BasicFilterArena<float> FilterArena;
+
+//! Double precision arena
+typedef BasicFilterArena<double> DoubleFilterArena;
+
+
+//! Batch Filter Designer class
+template <typename T>
+class BasicBatchFilterDesigner
+{
+public:
+    //! Constructor - starts the pool
+    //! threadCount = threads in total, including the calling thread. 0 for 
+    //! one per hardware thread.
+    BasicBatchFilterDesigner(size_t threadCount = 0);
+
+    //! Destructor - stops the pool
+    virtual ~BasicBatchFilterDesigner();
+
+    //! Get the number of threads, including the calling thread
+    size_t threadCount();
+
+    //! Design - every design into the arena, in order. Returns when all are done.
+    void design(const std::vector<BasicFilterDesignType<T> >& designs, 
+                BasicFilterArena<T>& arena);
+
+protected:
+
+private:
+    //! Not copyable
+    BasicBatchFilterDesigner(const BasicBatchFilterDesigner&);
+    BasicBatchFilterDesigner& operator=(const BasicBatchFilterDesigner&);
+
+    //! Pool thread - waits for a batch, works on it, repeats
+    void workerLoop(size_t worker);
+
+    //! Work on the batch until there is nothing left to take
+    void run(size_t worker);
+
+    //! Take the next design from the front of a share
+    bool takeFront(size_t worker, size_t& index);
+
+    //! Move the back half of another share into this (empty) one
+    bool steal(size_t worker);
+
+    //! Design one into the arena
+    void designOne(size_t worker, size_t index);
+
+    //! Pack and unpack a share
+    static uint64_t pack(size_t begin, size_t end) { return ((uint64_t)begin << 32) | (uint64_t)end; }
+    static size_t shareBegin(uint64_t share) { return (size_t)(share >> 32); }
+    static size_t shareEnd(uint64_t share) { return (size_t)(share & 0xFFFFFFFFu); }
+
+    //! Pool threads - one fewer than threadCount()
+    std::vector<std::thread> m_threads;
+
+    //! Per thread factory (each has its own Kaiser beta)
+    std::vector<BasicFilterFactory<T> > m_factories;
+
+    //! Per thread share of the batch, as pack(begin, end)
+    std::vector<std::atomic<uint64_t> > m_shares;
+
+    //! The batch being designed
+    const std::vector<BasicFilterDesignType<T> > * m_designs;
+    BasicFilterArena<T> * m_arena;
+
+    //! Start and finish signalling
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_finished;
+    size_t m_generation;
+    size_t m_active;
+    bool m_stopping;
+
+}; // class BasicBatchFilterDesigner
+
+//! Single precision batch designer
+typedef BasicBatchFilterDesigner<float> BatchFilterDesigner;
+
+//! Double precision batch designer
+typedef BasicBatchFilterDesigner<double> DoubleBatchFilterDesigner;
+
+
+//------------------------------------------------------------------------------
+// BasicFilterArena
+//------------------------------------------------------------------------------
+
+//! Copy of design index as a holder
+template <typename T>
+BasicFilterHolderType<T> BasicFilterArena<T>::filter(size_t index) const
+{
+    BasicFilterHolderType<T> holder;
+    holder.order = m_orders[index];
+    holder.coefficients.assign(m_coefficients.begin() + m_offsets[index], 
+                               m_coefficients.begin() + m_offsets[index + 1]);
+    return holder;
+}
+
+
+//------------------------------------------------------------------------------
+// BasicBatchFilterDesigner
+//------------------------------------------------------------------------------
+
+//! Constructor - starts the pool
+template <typename T>
+BasicBatchFilterDesigner<T>::BasicBatchFilterDesigner(size_t threadCount)
+    : m_designs(NULL), m_arena(NULL), m_generation(0), m_active(0), m_stopping(false)
+{
+    if( threadCount == 0 )
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if( threadCount == 0 )
+    {
+        threadCount = 1;
+    }
+
+    m_factories.resize(threadCount);
+    m_shares = std::vector<std::atomic<uint64_t> >(threadCount);
+    for( size_t i = 0; i < threadCount; i++ )
+    {
+        m_shares[i].store(0);
+    }
+
+    // The calling thread is worker 0
+    for( size_t i = 1; i < threadCount; i++ )
+    {
+        m_threads.push_back(std::thread(&BasicBatchFilterDesigner<T>::workerLoop, this, i));
+    }
+}
+
+
+//! Destructor - stops the pool
+template <typename T>
+BasicBatchFilterDesigner<T>::~BasicBatchFilterDesigner()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start.notify_all();
+
+    for( size_t i = 0; i < m_threads.size(); i++ )
+    {
+        m_threads[i].join();
+    }
+}
+
+
+//! Get the number of threads, including the calling thread
+template <typename T>
+size_t BasicBatchFilterDesigner<T>::threadCount()
+{
+    return m_factories.size();
+}
+
+
+//! Design - every design into the arena, in order
+template <typename T>
+void BasicBatchFilterDesigner<T>::design(const std::vector<BasicFilterDesignType<T> >& designs, 
+                                         BasicFilterArena<T>& arena)
+{
+    size_t count = designs.size();
+
+    // Lay out the arena
+    arena.m_orders.resize(count);
+    arena.m_offsets.resize(count + 1);
+    arena.m_offsets[0] = 0;
+    for( size_t i = 0; i < count; i++ )
+    {
+        int order = (designs[i].order < 0) ? 0 : designs[i].order;
+        arena.m_orders[i] = order;
+        arena.m_offsets[i + 1] = arena.m_offsets[i] + (size_t)order + 1;
+    }
+    arena.m_coefficients.assign(arena.m_offsets[count], T(0));
+
+    // Even shares to start with
+    size_t threads = threadCount();
+    for( size_t i = 0; i < threads; i++ )
+    {
+        m_shares[i].store(pack(count * i / threads, count * (i + 1) / threads));
+    }
+
+    m_designs = &designs;
+    m_arena = &arena;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active = threads - 1;
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    run(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_active == 0; });
+
+    m_designs = NULL;
+    m_arena = NULL;
+}
+
+
+//! Pool thread - waits for a batch, works on it, repeats
+template <typename T>
+void BasicBatchFilterDesigner<T>::workerLoop(size_t worker)
+{
+    size_t generation = 0;
+
+    for( ;; )
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&]() { return m_stopping || (m_generation != generation); });
+            if( m_stopping )
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        run(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active--;
+        }
+        m_finished.notify_all();
+    }
+}
+
+
+//! Work on the batch until there is nothing left to take
+template <typename T>
+void BasicBatchFilterDesigner<T>::run(size_t worker)
+{
+    size_t index;
+
+    for( ;; )
+    {
+        if( takeFront(worker, index) )
+        {
+            designOne(worker, index);
+        }
+        else if( !steal(worker) )
+        {
+            // Every share is empty - what is left is being designed by 
+            // the threads that took it
+            return;
+        }
+    }
+}
+
+
+//! Take the next design from the front of a share
+template <typename T>
+bool BasicBatchFilterDesigner<T>::takeFront(size_t worker, size_t& index)
+{
+    uint64_t share = m_shares[worker].load(std::memory_order_acquire);
+
+    for( ;; )
+    {
+        size_t begin = shareBegin(share);
+        size_t end = shareEnd(share);
+        if( begin >= end )
+        {
+            return false;
+        }
+
+        if( m_shares[worker].compare_exchange_weak(share, pack(begin + 1, end), 
+                                                   std::memory_order_acq_rel) )
+        {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+
+//! Move the back half of another share into this (empty) one
+template <typename T>
+bool BasicBatchFilterDesigner<T>::steal(size_t worker)
+{
+    size_t threads = threadCount();
+
+    for( size_t step = 1; step < threads; step++ )
+    {
+        size_t victim = (worker + step) % threads;
+        uint64_t share = m_shares[victim].load(std::memory_order_acquire);
+
+        for( ;; )
+        {
+            size_t begin = shareBegin(share);
+            size_t end = shareEnd(share);
+            if( begin >= end )
+            {
+                break;
+            }
+
+            size_t middle = end - (end - begin + 1) / 2;
+            if( m_shares[victim].compare_exchange_weak(share, pack(begin, middle), 
+                                                       std::memory_order_acq_rel) )
+            {
+                // Nobody takes from an empty share, so a plain store is safe
+                m_shares[worker].store(pack(middle, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+//! Design one into the arena
+template <typename T>
+void BasicBatchFilterDesigner<T>::designOne(size_t worker, size_t index)
+{
+    const BasicFilterDesignType<T>& design = (*m_designs)[index];
+    BasicFilterFactory<T>& filterFactory = m_factories[worker];
+
+    if( design.windowType == FilterWindowType::KAISER )
+    {
+        filterFactory.setKaiserBeta(design.kaiserBeta);
+    }
+
+    std::vector<T> weights = filterFactory.createFilterWeights(m_arena->m_orders[index], 
+        design.windowType, design.filterType, design.Fs, design.Fc1, design.Fc2);
+
+    std::copy(weights.begin(), weights.end(), 
+              m_arena->m_coefficients.begin() + m_arena->m_offsets[index]);
+}
+
+
+#endif // BATCHFILTERDESIGNER_H
@@ -0,0 +1,757 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// BiquadFilterBank.h
+//
+//------------------------------------------------------------------------------
+//
+// Multi-channel streaming IIR filter: a cascade of biquads designed by the 
+// IirFilterFactory run over many channels, e.g. an array of hydrophones.
+//
+// Each section is the transposed direct form II
+//   y = b0.x + z1
+//   z1 = b1.x - a1.y + z2
+//   z2 = b2.x - a2.y
+// which is a serial dependency from one sample to the next, so there is 
+// nothing to vectorise within a channel. Instead, as in FirFilterBank, the 
+// channels are held structure-of-arrays: a block of BIQUADFILTERBANK_BLOCK 
+// frames is staged in rows of every channel, padded to a multiple of 
+// BIQUADFILTERBANK_LANE_PAD, and each section runs over the whole block with
+// a vector of channels per instruction and the state in registers. The 
+// SSE2, AVX2 (with FMA) and AVX-512 kernels follow the level DotProduct has
+// selected.
+//
+// A decaying IIR state eventually reaches the denormal range, where every 
+// operation on it can cost a hundred cycles or more. On x86 the MXCSR flush
+// to zero and denormals are zero modes are set for the duration of each 
+// process call (DenormalGuard) and restored afterwards. Elsewhere any state
+// smaller than BIQUADFILTERBANK_DENORMAL_FLOOR is set to zero after each 
+// block.
+//
+// Input and output blocks may be interleaved (frame by frame, channels 
+// adjacent) or planar (one buffer per channel).
+//
+//------------------------------------------------------------------------------
+
+#ifndef BIQUADFILTERBANK_H
+#define BIQUADFILTERBANK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "DotProduct.h"
+#include "IirFilterFactory.h"
+
+#if defined(__SSE__) || defined(__x86_64__)
+#define BIQUADFILTERBANK_FTZ 1
+#include <xmmintrin.h>
+#else
+#define BIQUADFILTERBANK_FTZ 0
+#endif
+
+//! Channels in each row are padded to a multiple of this
+#define BIQUADFILTERBANK_LANE_PAD 16
+
+//! Frames staged per pass of the sections
+#define BIQUADFILTERBANK_BLOCK 64
+
+//! State below this is flushed to zero when the FTZ mode is not available
+#define BIQUADFILTERBANK_DENORMAL_FLOOR 1e-30
+
+
+//! Denormal Guard - flush to zero and denormals are zero while in scope
+class DenormalGuard
+{
+public:
+    //! Constructor - set FTZ and DAZ
+    DenormalGuard()
+    {
+#if BIQUADFILTERBANK_FTZ
+        m_csr = _mm_getcsr();
+        _mm_setcsr(m_csr | 0x8040);
+#endif
+    }
+
+    //! Destructor - restore the previous mode
+    ~DenormalGuard()
+    {
+#if BIQUADFILTERBANK_FTZ
+        _mm_setcsr(m_csr);
+#endif
+    }
+
+private:
+    //! Copy Constructor - not copyable
+    DenormalGuard(const DenormalGuard&);
+
+    //! Assignment - not copyable
+    DenormalGuard& operator=(const DenormalGuard&);
+
+    //! MXCSR on entry
+    unsigned int m_csr;
+
+}; // class DenormalGuard
+
+
+//! Biquad kernels - one section over a block of rows, stride channels per
+//! row. coefficients = b0, b1, b2, a1, a2. z1 and z2 hold stride states.
+class BiquadKernels
+{
+public:
+    //! Run a section using the level selected by DotProduct - float
+    static void process(const float * coefficients, float * z1, float * z2, 
+        float * block, size_t stride, size_t frameCount);
+
+    //! Run a section using the level selected by DotProduct - double
+    static void process(const double * coefficients, double * z1, double * z2, 
+        double * block, size_t stride, size_t frameCount);
+
+    //! Run a section for any other type - scalar only
+    template <typename DataType>
+    static void process(const DataType * coefficients, DataType * z1, DataType * z2, 
+        DataType * block, size_t stride, size_t frameCount);
+
+    //! Scalar kernel
+    template <typename DataType>
+    static void processScalar(const DataType * coefficients, DataType * z1, DataType * z2, 
+        DataType * block, size_t stride, size_t frameCount);
+
+#if DOTPRODUCT_X86_DISPATCH
+    //! SSE2 kernels
+    static void processSse2(const float * coefficients, float * z1, float * z2, 
+        float * block, size_t stride, size_t frameCount);
+    static void processSse2(const double * coefficients, double * z1, double * z2, 
+        double * block, size_t stride, size_t frameCount);
+
+    //! AVX2 kernels
+    static void processAvx2(const float * coefficients, float * z1, float * z2, 
+        float * block, size_t stride, size_t frameCount);
+    static void processAvx2(const double * coefficients, double * z1, double * z2, 
+        double * block, size_t stride, size_t frameCount);
+
+    //! AVX-512 kernels
+    static void processAvx512(const float * coefficients, float * z1, float * z2, 
+        float * block, size_t stride, size_t frameCount);
+    static void processAvx512(const double * coefficients, double * z1, double * z2, 
+        double * block, size_t stride, size_t frameCount);
+#endif
+
+}; // class BiquadKernels
+
+
+template <typename DataType>
+class BiquadFilterBank
+{
+public:
+
+    //! Constructor
+    //! cascade = the sections designed by IirFilterFactory::createFilter
+    //! channelCount = the number of channels, each filtered independently
+    BiquadFilterBank(const BasicBiquadCascadeType<DataType>& cascade, size_t channelCount);
+
+    //! Destructor
+    virtual ~BiquadFilterBank();
+
+    //! Reset the filter state of every channel to zero
+    void reset();
+
+    //! Get the filter order (number of poles)
+    int order();
+
+    //! Get the number of sections
+    size_t sectionCount();
+
+    //! Get the number of channels
+    size_t channelCount();
+
+    //! Filter one frame - one sample for each channel. input and output may 
+    //! be the same buffer.
+    void processFrame(const DataType * const input, DataType * output);
+
+    //! Filter a block of interleaved frames - input[frame*channelCount + c].
+    //! input and output may be the same buffer. No allocations are made.
+    void processInterleaved(const DataType * const input, DataType * output, 
+                            size_t frameCount);
+
+    //! Filter a block of planar frames - input[c][frame]. input and output 
+    //! may be the same buffers. No allocations are made.
+    void processPlanar(const DataType * const * input, DataType * const * output, 
+                       size_t frameCount);
+
+protected:
+
+private:
+    //! Run every section over the first frameCount rows of the block
+    void processBlock(size_t frameCount);
+
+    //! Filter Order
+    int m_order;
+
+    //! Number of sections
+    size_t m_sectionCount;
+
+    //! Number of channels
+    size_t m_channelCount;
+
+    //! Distance between rows (channelCount rounded up)
+    size_t m_stride;
+
+    //! b0, b1, b2, a1, a2 of each section
+    std::vector<DataType> m_coefficients;
+
+    //! z1 then z2 of each section - 2 * sectionCount rows of stride
+    std::vector<DataType> m_state;
+
+    //! Staged frames - BIQUADFILTERBANK_BLOCK rows of stride
+    std::vector<DataType> m_block;
+
+}; // class BiquadFilterBank
+
+
+//! Constructor
+template <typename DataType>
+BiquadFilterBank<DataType>::BiquadFilterBank(const BasicBiquadCascadeType<DataType>& cascade, 
+                                             size_t channelCount)
+    : m_order(cascade.order), m_sectionCount(cascade.sections.size()),
+      m_channelCount(channelCount), 
+      m_stride(((channelCount + BIQUADFILTERBANK_LANE_PAD - 1) / BIQUADFILTERBANK_LANE_PAD) 
+               * BIQUADFILTERBANK_LANE_PAD),
+      m_coefficients(5 * m_sectionCount), 
+      m_state(2 * m_sectionCount * m_stride, DataType(0)),
+      m_block(BIQUADFILTERBANK_BLOCK * m_stride, DataType(0))
+{
+    for( size_t s = 0; s < m_sectionCount; s++ )
+    {
+        m_coefficients[5 * s + 0] = cascade.sections[s].b0;
+        m_coefficients[5 * s + 1] = cascade.sections[s].b1;
+        m_coefficients[5 * s + 2] = cascade.sections[s].b2;
+        m_coefficients[5 * s + 3] = cascade.sections[s].a1;
+        m_coefficients[5 * s + 4] = cascade.sections[s].a2;
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+BiquadFilterBank<DataType>::~BiquadFilterBank()
+{
+}
+
+
+//! Reset the filter state of every channel to zero
+template <typename DataType>
+void BiquadFilterBank<DataType>::reset()
+{
+    std::fill(m_state.begin(), m_state.end(), DataType(0));
+}
+
+
+//! Get the filter order (number of poles)
+template <typename DataType>
+int BiquadFilterBank<DataType>::order()
+{
+    return m_order;
+}
+
+
+//! Get the number of sections
+template <typename DataType>
+size_t BiquadFilterBank<DataType>::sectionCount()
+{
+    return m_sectionCount;
+}
+
+
+//! Get the number of channels
+template <typename DataType>
+size_t BiquadFilterBank<DataType>::channelCount()
+{
+    return m_channelCount;
+}
+
+
+//! Filter one frame - one sample for each channel
+template <typename DataType>
+void BiquadFilterBank<DataType>::processFrame(const DataType * const input, DataType * output)
+{
+    DenormalGuard guard;
+
+    memcpy(&m_block[0], input, m_channelCount * sizeof(DataType));
+    processBlock(1);
+    memcpy(output, &m_block[0], m_channelCount * sizeof(DataType));
+}
+
+
+//! Filter a block of interleaved frames
+template <typename DataType>
+void BiquadFilterBank<DataType>::processInterleaved(const DataType * const input, 
+    DataType * output, size_t frameCount)
+{
+    DenormalGuard guard;
+
+    for( size_t first = 0; first < frameCount; first += BIQUADFILTERBANK_BLOCK )
+    {
+        size_t count = std::min((size_t)BIQUADFILTERBANK_BLOCK, frameCount - first);
+
+        for( size_t frame = 0; frame < count; frame++ )
+        {
+            memcpy(&m_block[frame * m_stride], input + (first + frame) * m_channelCount, 
+                   m_channelCount * sizeof(DataType));
+        }
+
+        processBlock(count);
+
+        for( size_t frame = 0; frame < count; frame++ )
+        {
+            memcpy(output + (first + frame) * m_channelCount, &m_block[frame * m_stride], 
+                   m_channelCount * sizeof(DataType));
+        }
+    }
+}
+
+
+//! Filter a block of planar frames
+template <typename DataType>
+void BiquadFilterBank<DataType>::processPlanar(const DataType * const * input, 
+    DataType * const * output, size_t frameCount)
+{
+    DenormalGuard guard;
+
+    for( size_t first = 0; first < frameCount; first += BIQUADFILTERBANK_BLOCK )
+    {
+        size_t count = std::min((size_t)BIQUADFILTERBANK_BLOCK, frameCount - first);
+
+        // Gather
+        for( size_t c = 0; c < m_channelCount; c++ )
+        {
+            const DataType * channel = input[c] + first;
+            for( size_t frame = 0; frame < count; frame++ )
+            {
+                m_block[frame * m_stride + c] = channel[frame];
+            }
+        }
+
+        processBlock(count);
+
+        // Scatter
+        for( size_t c = 0; c < m_channelCount; c++ )
+        {
+            DataType * channel = output[c] + first;
+            for( size_t frame = 0; frame < count; frame++ )
+            {
+                channel[frame] = m_block[frame * m_stride + c];
+            }
+        }
+    }
+}
+
+
+//! Run every section over the first frameCount rows of the block
+template <typename DataType>
+void BiquadFilterBank<DataType>::processBlock(size_t frameCount)
+{
+    for( size_t s = 0; s < m_sectionCount; s++ )
+    {
+        BiquadKernels::process(&m_coefficients[5 * s], 
+                               &m_state[(2 * s) * m_stride], &m_state[(2 * s + 1) * m_stride], 
+                               &m_block[0], m_stride, frameCount);
+    }
+
+#if !BIQUADFILTERBANK_FTZ
+    for( size_t i = 0; i < m_state.size(); i++ )
+    {
+        if( std::fabs(m_state[i]) < BIQUADFILTERBANK_DENORMAL_FLOOR )
+        {
+            m_state[i] = DataType(0);
+        }
+    }
+#endif
+}
+
+
+//! Run a section using the selected level - float
+inline void BiquadKernels::process(const float * coefficients, float * z1, float * z2, 
+    float * block, size_t stride, size_t frameCount)
+{
+#if DOTPRODUCT_X86_DISPATCH
+    switch( DotProduct::simdLevel() )
+    {
+        case SimdLevel::AVX512:
+            processAvx512(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        case SimdLevel::AVX2:
+            processAvx2(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        case SimdLevel::SSE2:
+            processSse2(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        default:
+            break;
+    }
+#endif
+    processScalar(coefficients, z1, z2, block, stride, frameCount);
+}
+
+
+//! Run a section using the selected level - double
+inline void BiquadKernels::process(const double * coefficients, double * z1, double * z2, 
+    double * block, size_t stride, size_t frameCount)
+{
+#if DOTPRODUCT_X86_DISPATCH
+    switch( DotProduct::simdLevel() )
+    {
+        case SimdLevel::AVX512:
+            processAvx512(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        case SimdLevel::AVX2:
+            processAvx2(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        case SimdLevel::SSE2:
+            processSse2(coefficients, z1, z2, block, stride, frameCount);
+            return;
+        default:
+            break;
+    }
+#endif
+    processScalar(coefficients, z1, z2, block, stride, frameCount);
+}
+
+
+//! Run a section for any other type - scalar only
+template <typename DataType>
+void BiquadKernels::process(const DataType * coefficients, DataType * z1, DataType * z2, 
+    DataType * block, size_t stride, size_t frameCount)
+{
+    processScalar(coefficients, z1, z2, block, stride, frameCount);
+}
+
+
+//! Scalar kernel
+template <typename DataType>
+void BiquadKernels::processScalar(const DataType * coefficients, DataType * z1, DataType * z2, 
+    DataType * block, size_t stride, size_t frameCount)
+{
+    DataType b0 = coefficients[0];
+    DataType b1 = coefficients[1];
+    DataType b2 = coefficients[2];
+    DataType a1 = coefficients[3];
+    DataType a2 = coefficients[4];
+
+    for( size_t c = 0; c < stride; c++ )
+    {
+        DataType s1 = z1[c];
+        DataType s2 = z2[c];
+
+        DataType * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            DataType x = *row;
+            DataType y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            *row = y;
+        }
+
+        z1[c] = s1;
+        z2[c] = s2;
+    }
+}
+
+
+#if DOTPRODUCT_X86_DISPATCH
+
+//! SSE2 kernel - float. The stride is a multiple of 16 so the channels go
+//! in pairs of vectors, two independent recurrences in flight.
+DOTPRODUCT_TARGET("sse2")
+inline void BiquadKernels::processSse2(const float * coefficients, float * z1, float * z2, 
+    float * block, size_t stride, size_t frameCount)
+{
+    __m128 b0 = _mm_set1_ps(coefficients[0]);
+    __m128 b1 = _mm_set1_ps(coefficients[1]);
+    __m128 b2 = _mm_set1_ps(coefficients[2]);
+    __m128 a1 = _mm_set1_ps(coefficients[3]);
+    __m128 a2 = _mm_set1_ps(coefficients[4]);
+
+    for( size_t c = 0; c < stride; c += 8 )
+    {
+        __m128 s1a = _mm_loadu_ps(z1 + c);
+        __m128 s1b = _mm_loadu_ps(z1 + c + 4);
+        __m128 s2a = _mm_loadu_ps(z2 + c);
+        __m128 s2b = _mm_loadu_ps(z2 + c + 4);
+
+        float * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m128 xa = _mm_loadu_ps(row);
+            __m128 xb = _mm_loadu_ps(row + 4);
+            __m128 ya = _mm_add_ps(_mm_mul_ps(b0, xa), s1a);
+            __m128 yb = _mm_add_ps(_mm_mul_ps(b0, xb), s1b);
+            s1a = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, xa), _mm_mul_ps(a1, ya)), s2a);
+            s1b = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, xb), _mm_mul_ps(a1, yb)), s2b);
+            s2a = _mm_sub_ps(_mm_mul_ps(b2, xa), _mm_mul_ps(a2, ya));
+            s2b = _mm_sub_ps(_mm_mul_ps(b2, xb), _mm_mul_ps(a2, yb));
+            _mm_storeu_ps(row, ya);
+            _mm_storeu_ps(row + 4, yb);
+        }
+
+        _mm_storeu_ps(z1 + c, s1a);
+        _mm_storeu_ps(z1 + c + 4, s1b);
+        _mm_storeu_ps(z2 + c, s2a);
+        _mm_storeu_ps(z2 + c + 4, s2b);
+    }
+}
+
+
+//! SSE2 kernel - double
+DOTPRODUCT_TARGET("sse2")
+inline void BiquadKernels::processSse2(const double * coefficients, double * z1, double * z2, 
+    double * block, size_t stride, size_t frameCount)
+{
+    __m128d b0 = _mm_set1_pd(coefficients[0]);
+    __m128d b1 = _mm_set1_pd(coefficients[1]);
+    __m128d b2 = _mm_set1_pd(coefficients[2]);
+    __m128d a1 = _mm_set1_pd(coefficients[3]);
+    __m128d a2 = _mm_set1_pd(coefficients[4]);
+
+    for( size_t c = 0; c < stride; c += 4 )
+    {
+        __m128d s1a = _mm_loadu_pd(z1 + c);
+        __m128d s1b = _mm_loadu_pd(z1 + c + 2);
+        __m128d s2a = _mm_loadu_pd(z2 + c);
+        __m128d s2b = _mm_loadu_pd(z2 + c + 2);
+
+        double * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m128d xa = _mm_loadu_pd(row);
+            __m128d xb = _mm_loadu_pd(row + 2);
+            __m128d ya = _mm_add_pd(_mm_mul_pd(b0, xa), s1a);
+            __m128d yb = _mm_add_pd(_mm_mul_pd(b0, xb), s1b);
+            s1a = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, xa), _mm_mul_pd(a1, ya)), s2a);
+            s1b = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, xb), _mm_mul_pd(a1, yb)), s2b);
+            s2a = _mm_sub_pd(_mm_mul_pd(b2, xa), _mm_mul_pd(a2, ya));
+            s2b = _mm_sub_pd(_mm_mul_pd(b2, xb), _mm_mul_pd(a2, yb));
+            _mm_storeu_pd(row, ya);
+            _mm_storeu_pd(row + 2, yb);
+        }
+
+        _mm_storeu_pd(z1 + c, s1a);
+        _mm_storeu_pd(z1 + c + 2, s1b);
+        _mm_storeu_pd(z2 + c, s2a);
+        _mm_storeu_pd(z2 + c + 2, s2b);
+    }
+}
+
+
+//! AVX2 kernel - float
+DOTPRODUCT_TARGET("avx2,fma")
+inline void BiquadKernels::processAvx2(const float * coefficients, float * z1, float * z2, 
+    float * block, size_t stride, size_t frameCount)
+{
+    __m256 b0 = _mm256_set1_ps(coefficients[0]);
+    __m256 b1 = _mm256_set1_ps(coefficients[1]);
+    __m256 b2 = _mm256_set1_ps(coefficients[2]);
+    __m256 a1 = _mm256_set1_ps(coefficients[3]);
+    __m256 a2 = _mm256_set1_ps(coefficients[4]);
+
+    for( size_t c = 0; c < stride; c += 16 )
+    {
+        __m256 s1a = _mm256_loadu_ps(z1 + c);
+        __m256 s1b = _mm256_loadu_ps(z1 + c + 8);
+        __m256 s2a = _mm256_loadu_ps(z2 + c);
+        __m256 s2b = _mm256_loadu_ps(z2 + c + 8);
+
+        float * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m256 xa = _mm256_loadu_ps(row);
+            __m256 xb = _mm256_loadu_ps(row + 8);
+            __m256 ya = _mm256_fmadd_ps(b0, xa, s1a);
+            __m256 yb = _mm256_fmadd_ps(b0, xb, s1b);
+            s1a = _mm256_fmadd_ps(b1, xa, _mm256_fnmadd_ps(a1, ya, s2a));
+            s1b = _mm256_fmadd_ps(b1, xb, _mm256_fnmadd_ps(a1, yb, s2b));
+            s2a = _mm256_fnmadd_ps(a2, ya, _mm256_mul_ps(b2, xa));
+            s2b = _mm256_fnmadd_ps(a2, yb, _mm256_mul_ps(b2, xb));
+            _mm256_storeu_ps(row, ya);
+            _mm256_storeu_ps(row + 8, yb);
+        }
+
+        _mm256_storeu_ps(z1 + c, s1a);
+        _mm256_storeu_ps(z1 + c + 8, s1b);
+        _mm256_storeu_ps(z2 + c, s2a);
+        _mm256_storeu_ps(z2 + c + 8, s2b);
+    }
+}
+
+
+//! AVX2 kernel - double
+DOTPRODUCT_TARGET("avx2,fma")
+inline void BiquadKernels::processAvx2(const double * coefficients, double * z1, double * z2, 
+    double * block, size_t stride, size_t frameCount)
+{
+    __m256d b0 = _mm256_set1_pd(coefficients[0]);
+    __m256d b1 = _mm256_set1_pd(coefficients[1]);
+    __m256d b2 = _mm256_set1_pd(coefficients[2]);
+    __m256d a1 = _mm256_set1_pd(coefficients[3]);
+    __m256d a2 = _mm256_set1_pd(coefficients[4]);
+
+    for( size_t c = 0; c < stride; c += 8 )
+    {
+        __m256d s1a = _mm256_loadu_pd(z1 + c);
+        __m256d s1b = _mm256_loadu_pd(z1 + c + 4);
+        __m256d s2a = _mm256_loadu_pd(z2 + c);
+        __m256d s2b = _mm256_loadu_pd(z2 + c + 4);
+
+        double * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m256d xa = _mm256_loadu_pd(row);
+            __m256d xb = _mm256_loadu_pd(row + 4);
+            __m256d ya = _mm256_fmadd_pd(b0, xa, s1a);
+            __m256d yb = _mm256_fmadd_pd(b0, xb, s1b);
+            s1a = _mm256_fmadd_pd(b1, xa, _mm256_fnmadd_pd(a1, ya, s2a));
+            s1b = _mm256_fmadd_pd(b1, xb, _mm256_fnmadd_pd(a1, yb, s2b));
+            s2a = _mm256_fnmadd_pd(a2, ya, _mm256_mul_pd(b2, xa));
+            s2b = _mm256_fnmadd_pd(a2, yb, _mm256_mul_pd(b2, xb));
+            _mm256_storeu_pd(row, ya);
+            _mm256_storeu_pd(row + 4, yb);
+        }
+
+        _mm256_storeu_pd(z1 + c, s1a);
+        _mm256_storeu_pd(z1 + c + 4, s1b);
+        _mm256_storeu_pd(z2 + c, s2a);
+        _mm256_storeu_pd(z2 + c + 4, s2b);
+    }
+}
+
+
+//! AVX-512 kernel - float. Pairs of vectors where the stride allows, then 
+//! one vector for an odd multiple of 16.
+DOTPRODUCT_TARGET("avx512f")
+inline void BiquadKernels::processAvx512(const float * coefficients, float * z1, float * z2, 
+    float * block, size_t stride, size_t frameCount)
+{
+    __m512 b0 = _mm512_set1_ps(coefficients[0]);
+    __m512 b1 = _mm512_set1_ps(coefficients[1]);
+    __m512 b2 = _mm512_set1_ps(coefficients[2]);
+    __m512 a1 = _mm512_set1_ps(coefficients[3]);
+    __m512 a2 = _mm512_set1_ps(coefficients[4]);
+
+    size_t c = 0;
+    for( ; c + 32 <= stride; c += 32 )
+    {
+        __m512 s1a = _mm512_loadu_ps(z1 + c);
+        __m512 s1b = _mm512_loadu_ps(z1 + c + 16);
+        __m512 s2a = _mm512_loadu_ps(z2 + c);
+        __m512 s2b = _mm512_loadu_ps(z2 + c + 16);
+
+        float * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m512 xa = _mm512_loadu_ps(row);
+            __m512 xb = _mm512_loadu_ps(row + 16);
+            __m512 ya = _mm512_fmadd_ps(b0, xa, s1a);
+            __m512 yb = _mm512_fmadd_ps(b0, xb, s1b);
+            s1a = _mm512_fmadd_ps(b1, xa, _mm512_fnmadd_ps(a1, ya, s2a));
+            s1b = _mm512_fmadd_ps(b1, xb, _mm512_fnmadd_ps(a1, yb, s2b));
+            s2a = _mm512_fnmadd_ps(a2, ya, _mm512_mul_ps(b2, xa));
+            s2b = _mm512_fnmadd_ps(a2, yb, _mm512_mul_ps(b2, xb));
+            _mm512_storeu_ps(row, ya);
+            _mm512_storeu_ps(row + 16, yb);
+        }
+
+        _mm512_storeu_ps(z1 + c, s1a);
+        _mm512_storeu_ps(z1 + c + 16, s1b);
+        _mm512_storeu_ps(z2 + c, s2a);
+        _mm512_storeu_ps(z2 + c + 16, s2b);
+    }
+
+    if( c < stride )
+    {
+        __m512 s1 = _mm512_loadu_ps(z1 + c);
+        __m512 s2 = _mm512_loadu_ps(z2 + c);
+
+        float * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m512 x = _mm512_loadu_ps(row);
+            __m512 y = _mm512_fmadd_ps(b0, x, s1);
+            s1 = _mm512_fmadd_ps(b1, x, _mm512_fnmadd_ps(a1, y, s2));
+            s2 = _mm512_fnmadd_ps(a2, y, _mm512_mul_ps(b2, x));
+            _mm512_storeu_ps(row, y);
+        }
+
+        _mm512_storeu_ps(z1 + c, s1);
+        _mm512_storeu_ps(z2 + c, s2);
+    }
+}
+
+
+//! AVX-512 kernel - double
+DOTPRODUCT_TARGET("avx512f")
+inline void BiquadKernels::processAvx512(const double * coefficients, double * z1, double * z2, 
+    double * block, size_t stride, size_t frameCount)
+{
+    __m512d b0 = _mm512_set1_pd(coefficients[0]);
+    __m512d b1 = _mm512_set1_pd(coefficients[1]);
+    __m512d b2 = _mm512_set1_pd(coefficients[2]);
+    __m512d a1 = _mm512_set1_pd(coefficients[3]);
+    __m512d a2 = _mm512_set1_pd(coefficients[4]);
+
+    for( size_t c = 0; c < stride; c += 16 )
+    {
+        __m512d s1a = _mm512_loadu_pd(z1 + c);
+        __m512d s1b = _mm512_loadu_pd(z1 + c + 8);
+        __m512d s2a = _mm512_loadu_pd(z2 + c);
+        __m512d s2b = _mm512_loadu_pd(z2 + c + 8);
+
+        double * row = block + c;
+        for( size_t frame = 0; frame < frameCount; frame++, row += stride )
+        {
+            __m512d xa = _mm512_loadu_pd(row);
+            __m512d xb = _mm512_loadu_pd(row + 8);
+            __m512d ya = _mm512_fmadd_pd(b0, xa, s1a);
+            __m512d yb = _mm512_fmadd_pd(b0, xb, s1b);
+            s1a = _mm512_fmadd_pd(b1, xa, _mm512_fnmadd_pd(a1, ya, s2a));
+            s1b = _mm512_fmadd_pd(b1, xb, _mm512_fnmadd_pd(a1, yb, s2b));
+            s2a = _mm512_fnmadd_pd(a2, ya, _mm512_mul_pd(b2, xa));
+            s2b = _mm512_fnmadd_pd(a2, yb, _mm512_mul_pd(b2, xb));
+            _mm512_storeu_pd(row, ya);
+            _mm512_storeu_pd(row + 8, yb);
+        }
+
+        _mm512_storeu_pd(z1 + c, s1a);
+        _mm512_storeu_pd(z1 + c + 8, s1b);
+        _mm512_storeu_pd(z2 + c, s2a);
+        _mm512_storeu_pd(z2 + c + 8, s2b);
+    }
+}
+
+#endif // DOTPRODUCT_X86_DISPATCH
+
+
+#endif // BIQUADFILTERBANK_H
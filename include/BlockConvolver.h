@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// BlockConvolver.h
+//
+//------------------------------------------------------------------------------
+//
+// Block convolution that picks between direct form (FirFilter) and partitioned
+// FFT convolution (FftConvolver) based on the filter length and block size.
+//
+// The direct cost per sample grows with the number of taps while the FFT cost
+// grows with log(blockSize) plus taps/blockSize, so for a given block size
+// there is a number of taps above which the FFT is cheaper. The defaults in
+// defaultCrossoverTaps() are the crossovers reported by 
+// examples/blockconvolver-example.cpp on an AVX-512 machine, which sweeps 
+// orders in powers of two, taking the longest over repeated runs so that AUTO
+// leans towards direct form where the two are close. Run it on the target to 
+// calibrate and pass the result to the constructor.
+//
+//------------------------------------------------------------------------------
+
+#ifndef BLOCKCONVOLVER_H
+#define BLOCKCONVOLVER_H
+
+#include <cstdlib>
+
+#include "FftConvolver.h"
+#include "FilterFactory.h"
+#include "FirFilter.h"
+
+//! Convolution Method enum container
+struct ConvolutionMethod
+{
+    typedef enum
+    {
+        DIRECT = 0,
+        FFT,
+        AUTO
+    } Type;
+};
+
+
+template <typename DataType>
+class BlockConvolver
+{
+public:
+
+    //! Constructor
+    //! filter = the filter designed by FilterFactory::createFilter
+    //! blockSize = the number of samples per processed block
+    //! method = DIRECT, FFT or AUTO to choose on the crossover
+    //! crossoverTaps = taps at which AUTO switches to FFT, 0 for the default
+    BlockConvolver(const BasicFilterHolderType<DataType>& filter, size_t blockSize, 
+                   ConvolutionMethod::Type method = ConvolutionMethod::AUTO,
+                   size_t crossoverTaps = 0);
+
+    //! Destructor
+    virtual ~BlockConvolver();
+
+    //! Reset the filter state (history) to zero
+    void reset();
+
+    //! Get the block size
+    size_t blockSize();
+
+    //! Get the method in use - DIRECT or FFT
+    ConvolutionMethod::Type method();
+
+    //! Filter whole blocks of samples. input and output may be the same buffer.
+    //! Returns the number of samples processed - a multiple of blockSize().
+    size_t processBlock(const DataType * const input, DataType * output, size_t length);
+
+    //! The measured number of taps above which FFT convolution is faster 
+    //! for a given block size
+    static size_t defaultCrossoverTaps(size_t blockSize);
+
+protected:
+
+private:
+    //! Not copyable
+    BlockConvolver(const BlockConvolver&);
+    BlockConvolver& operator=(const BlockConvolver&);
+
+    //! Block Size
+    size_t m_blockSize;
+
+    //! Method in use
+    ConvolutionMethod::Type m_method;
+
+    //! Direct form filter - when m_method == DIRECT
+    FirFilter<DataType> * m_directFilter;
+
+    //! FFT convolver - when m_method == FFT
+    FftConvolver<DataType> * m_fftConvolver;
+
+}; // class BlockConvolver
+
+
+//! Constructor
+template <typename DataType>
+BlockConvolver<DataType>::BlockConvolver(const BasicFilterHolderType<DataType>& filter, size_t blockSize, 
+                                         ConvolutionMethod::Type method,
+                                         size_t crossoverTaps)
+    : m_blockSize(Fft<DataType>::nextPowerOfTwo(blockSize < 1 ? 1 : blockSize)),
+      m_method(method), m_directFilter(NULL), m_fftConvolver(NULL)
+{
+    if( m_method == ConvolutionMethod::AUTO )
+    {
+        if( crossoverTaps == 0 )
+        {
+            crossoverTaps = defaultCrossoverTaps(m_blockSize);
+        }
+
+        m_method = (filter.coefficients.size() >= crossoverTaps) 
+            ? ConvolutionMethod::FFT : ConvolutionMethod::DIRECT;
+    }
+
+    if( m_method == ConvolutionMethod::FFT )
+    {
+        m_fftConvolver = new FftConvolver<DataType>(filter, m_blockSize);
+    }
+    else
+    {
+        m_method = ConvolutionMethod::DIRECT;
+        m_directFilter = new FirFilter<DataType>(filter);
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+BlockConvolver<DataType>::~BlockConvolver()
+{
+    delete m_directFilter;
+    delete m_fftConvolver;
+}
+
+
+//! Reset the filter state (history) to zero
+template <typename DataType>
+void BlockConvolver<DataType>::reset()
+{
+    if( m_directFilter )
+    {
+        m_directFilter->reset();
+    }
+
+    if( m_fftConvolver )
+    {
+        m_fftConvolver->reset();
+    }
+}
+
+
+//! Get the block size
+template <typename DataType>
+size_t BlockConvolver<DataType>::blockSize()
+{
+    return m_blockSize;
+}
+
+
+//! Get the method in use - DIRECT or FFT
+template <typename DataType>
+ConvolutionMethod::Type BlockConvolver<DataType>::method()
+{
+    return m_method;
+}
+
+
+//! Filter whole blocks of samples - returns the number of samples processed
+template <typename DataType>
+size_t BlockConvolver<DataType>::processBlock(const DataType * const input, DataType * output, size_t length)
+{
+    if( m_fftConvolver )
+    {
+        return m_fftConvolver->processBlock(input, output, length);
+    }
+
+    length -= (length % m_blockSize);
+    m_directFilter->processBlock(input, output, length);
+    return length;
+}
+
+
+//! The measured number of taps above which FFT convolution is faster
+template <typename DataType>
+size_t BlockConvolver<DataType>::defaultCrossoverTaps(size_t blockSize)
+{
+    // Short blocks mean many short partitions, so the FFT needs a longer 
+    // filter before it pays for itself.
+    if( blockSize < 64 )
+    {
+        return 8193;
+    }
+
+    if( blockSize < 128 )
+    {
+        return 4097;
+    }
+
+    return 1025;
+}
+
+
+#endif // BLOCKCONVOLVER_H
@@ -0,0 +1,1319 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// DotProduct.h
+//
+//------------------------------------------------------------------------------
+//
+// Multiply-accumulate kernels for a contiguous window of history against a
+// coefficient vector, e.g. MirroredDelayLine::data() against the time-reversed
+// coefficients held by FirFilter.
+//
+// There are scalar, SSE2, AVX2 (with FMA) and AVX-512 versions for float,
+// double and int16. The best version supported by the CPU is selected at
+// runtime the first time a kernel is used. Loads are unaligned throughout as
+// data() moves one sample at a time.
+//
+// The folded kernels are for linear-phase (symmetric) filters. They pre-add
+// the mirrored samples x[j] + x[length-1-j] and multiply by the first half of
+// the coefficients only, so roughly half the multiplies are needed.
+//
+// The int16 kernels accumulate pairwise products (pmaddwd) into 32-bit lanes
+// and the result is returned modulo 2^32, so the caller must ensure the sum
+// has headroom, e.g. Q15 coefficients with sum|h| <= 1.
+//
+// The lane kernels are for many channels sharing one set of coefficients,
+// with the history stored structure-of-arrays: row j holds sample j of every
+// channel. Each coefficient is broadcast once and multiplied against a whole
+// row of channels, so the vector width is spread across channels rather than
+// taps and there is no horizontal sum.
+//
+//------------------------------------------------------------------------------
+
+#ifndef DOTPRODUCT_H
+#define DOTPRODUCT_H
+
+#include <cstdlib>
+#include <stdint.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DOTPRODUCT_X86_DISPATCH 1
+#include <immintrin.h>
+#define DOTPRODUCT_TARGET(x) __attribute__((target(x)))
+#else
+#define DOTPRODUCT_X86_DISPATCH 0
+#endif
+
+
+//! SIMD Level enum container
+struct SimdLevel
+{
+    typedef enum
+    {
+        SCALAR = 0,
+        SSE2,
+        AVX2,
+        AVX512
+    } Type;
+};
+
+
+//! Dot Product kernels with runtime CPU dispatch
+class DotProduct
+{
+public:
+    //! Kernel function pointer types
+    typedef float (*FloatKernel)(const float * x, const float * h, size_t length);
+    typedef double (*DoubleKernel)(const double * x, const double * h, size_t length);
+    typedef int32_t (*Int16Kernel)(const int16_t * x, const int16_t * h, size_t length);
+    typedef float (*FloatFoldedKernel)(const float * x, const float * h, size_t length);
+    typedef double (*DoubleFoldedKernel)(const double * x, const double * h, size_t length);
+    typedef void (*FloatLaneKernel)(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+    typedef void (*DoubleLaneKernel)(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+
+    //! Dot product using the selected kernel - float
+    static float dot(const float * x, const float * h, size_t length);
+
+    //! Dot product using the selected kernel - double
+    static double dot(const double * x, const double * h, size_t length);
+
+    //! Dot product using the selected kernel - int16 with 32-bit accumulator
+    static int32_t dot(const int16_t * x, const int16_t * h, size_t length);
+
+    //! Dot product for any other type - scalar only
+    template <typename DataType>
+    static DataType dot(const DataType * x, const DataType * h, size_t length);
+
+    //! Folded dot product for symmetric coefficients - float
+    //! length = the full number of taps, only h[0 .. (length-1)/2] is read.
+    static float foldedDot(const float * x, const float * h, size_t length);
+
+    //! Folded dot product for symmetric coefficients - double
+    static double foldedDot(const double * x, const double * h, size_t length);
+
+    //! Folded dot product for any other type - scalar only
+    template <typename DataType>
+    static DataType foldedDot(const DataType * x, const DataType * h, size_t length);
+
+    //! Lane dot product - float
+    //! y[c] = sum h[j] * x[j*stride + c] for c in [0, lanes). y must not 
+    //! overlap x.
+    static void laneDot(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+
+    //! Lane dot product - double
+    static void laneDot(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+
+    //! Lane dot product for any other type - scalar only
+    template <typename DataType>
+    static void laneDot(const DataType * x, size_t stride, const DataType * h, 
+        size_t length, DataType * y, size_t lanes);
+
+    //! Get the best SIMD level supported by this CPU
+    static SimdLevel::Type detectSimdLevel();
+
+    //! Get the SIMD level currently in use
+    static SimdLevel::Type simdLevel();
+
+    //! Select the SIMD level to use (clamped to what the CPU supports).
+    //! Intended for start up and benchmarking - not thread safe against
+    //! concurrent dot() calls.
+    static void setSimdLevel(SimdLevel::Type level);
+
+    //! Scalar kernels
+    static float dotScalar(const float * x, const float * h, size_t length);
+    static double dotScalar(const double * x, const double * h, size_t length);
+    static int32_t dotScalar(const int16_t * x, const int16_t * h, size_t length);
+    static float foldedDotScalar(const float * x, const float * h, size_t length);
+    static double foldedDotScalar(const double * x, const double * h, size_t length);
+    static void laneDotScalar(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+    static void laneDotScalar(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+
+#if DOTPRODUCT_X86_DISPATCH
+    //! SSE2 kernels
+    static float dotSse2(const float * x, const float * h, size_t length);
+    static double dotSse2(const double * x, const double * h, size_t length);
+    static int32_t dotSse2(const int16_t * x, const int16_t * h, size_t length);
+    static float foldedDotSse2(const float * x, const float * h, size_t length);
+    static double foldedDotSse2(const double * x, const double * h, size_t length);
+    static void laneDotSse2(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+    static void laneDotSse2(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+
+    //! AVX2 kernels
+    static float dotAvx2(const float * x, const float * h, size_t length);
+    static double dotAvx2(const double * x, const double * h, size_t length);
+    static int32_t dotAvx2(const int16_t * x, const int16_t * h, size_t length);
+    static float foldedDotAvx2(const float * x, const float * h, size_t length);
+    static double foldedDotAvx2(const double * x, const double * h, size_t length);
+    static void laneDotAvx2(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+    static void laneDotAvx2(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+
+    //! AVX-512 kernels
+    static float dotAvx512(const float * x, const float * h, size_t length);
+    static double dotAvx512(const double * x, const double * h, size_t length);
+    static int32_t dotAvx512(const int16_t * x, const int16_t * h, size_t length);
+    static float foldedDotAvx512(const float * x, const float * h, size_t length);
+    static double foldedDotAvx512(const double * x, const double * h, size_t length);
+    static void laneDotAvx512(const float * x, size_t stride, const float * h, 
+        size_t length, float * y, size_t lanes);
+    static void laneDotAvx512(const double * x, size_t stride, const double * h, 
+        size_t length, double * y, size_t lanes);
+#endif
+
+protected:
+
+private:
+    //! Selected kernels
+    struct KernelTable
+    {
+        SimdLevel::Type level;
+        FloatKernel floatKernel;
+        DoubleKernel doubleKernel;
+        Int16Kernel int16Kernel;
+        FloatFoldedKernel floatFoldedKernel;
+        DoubleFoldedKernel doubleFoldedKernel;
+        FloatLaneKernel floatLaneKernel;
+        DoubleLaneKernel doubleLaneKernel;
+    };
+
+    //! Get the kernel table - selected on first use
+    static KernelTable& kernelTable();
+
+    //! Fill the kernel table for a given level
+    static void selectKernels(KernelTable& table, SimdLevel::Type level);
+
+}; // class DotProduct
+
+
+//! Dot product using the selected kernel - float
+inline float DotProduct::dot(const float * x, const float * h, size_t length)
+{
+    return kernelTable().floatKernel(x, h, length);
+}
+
+
+//! Dot product using the selected kernel - double
+inline double DotProduct::dot(const double * x, const double * h, size_t length)
+{
+    return kernelTable().doubleKernel(x, h, length);
+}
+
+
+//! Dot product using the selected kernel - int16 with 32-bit accumulator
+inline int32_t DotProduct::dot(const int16_t * x, const int16_t * h, size_t length)
+{
+    return kernelTable().int16Kernel(x, h, length);
+}
+
+
+//! Dot product for any other type - scalar only
+template <typename DataType>
+DataType DotProduct::dot(const DataType * x, const DataType * h, size_t length)
+{
+    DataType sum = DataType(0);
+    for( size_t i = 0; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! Folded dot product for symmetric coefficients - float
+inline float DotProduct::foldedDot(const float * x, const float * h, size_t length)
+{
+    return kernelTable().floatFoldedKernel(x, h, length);
+}
+
+
+//! Folded dot product for symmetric coefficients - double
+inline double DotProduct::foldedDot(const double * x, const double * h, size_t length)
+{
+    return kernelTable().doubleFoldedKernel(x, h, length);
+}
+
+
+//! Folded dot product for any other type - scalar only
+template <typename DataType>
+DataType DotProduct::foldedDot(const DataType * x, const DataType * h, size_t length)
+{
+    size_t half = length / 2;
+
+    DataType sum = DataType(0);
+    for( size_t j = 0; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+
+    if( length & 1 )
+    {
+        // Centre tap
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! Lane dot product - float
+inline void DotProduct::laneDot(const float * x, size_t stride, const float * h, 
+    size_t length, float * y, size_t lanes)
+{
+    kernelTable().floatLaneKernel(x, stride, h, length, y, lanes);
+}
+
+
+//! Lane dot product - double
+inline void DotProduct::laneDot(const double * x, size_t stride, const double * h, 
+    size_t length, double * y, size_t lanes)
+{
+    kernelTable().doubleLaneKernel(x, stride, h, length, y, lanes);
+}
+
+
+//! Lane dot product for any other type - scalar only
+template <typename DataType>
+void DotProduct::laneDot(const DataType * x, size_t stride, const DataType * h, 
+    size_t length, DataType * y, size_t lanes)
+{
+    for( size_t c = 0; c < lanes; c++ )
+    {
+        y[c] = DataType(0);
+    }
+
+    for( size_t j = 0; j < length; j++ )
+    {
+        const DataType * row = x + j * stride;
+        for( size_t c = 0; c < lanes; c++ )
+        {
+            y[c] += h[j] * row[c];
+        }
+    }
+}
+
+
+//! Get the best SIMD level supported by this CPU
+inline SimdLevel::Type DotProduct::detectSimdLevel()
+{
+#if DOTPRODUCT_X86_DISPATCH
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") )
+    {
+        return SimdLevel::AVX512;
+    }
+
+    if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") )
+    {
+        return SimdLevel::AVX2;
+    }
+
+    if( __builtin_cpu_supports("sse2") )
+    {
+        return SimdLevel::SSE2;
+    }
+#endif
+
+    return SimdLevel::SCALAR;
+}
+
+
+//! Get the SIMD level currently in use
+inline SimdLevel::Type DotProduct::simdLevel()
+{
+    return kernelTable().level;
+}
+
+
+//! Select the SIMD level to use (clamped to what the CPU supports).
+inline void DotProduct::setSimdLevel(SimdLevel::Type level)
+{
+    SimdLevel::Type detected = detectSimdLevel();
+    if( level > detected )
+    {
+        level = detected;
+    }
+
+    selectKernels(kernelTable(), level);
+}
+
+
+//! Get the kernel table - selected on first use
+inline DotProduct::KernelTable& DotProduct::kernelTable()
+{
+    struct Initialiser
+    {
+        KernelTable table;
+
+        Initialiser()
+        {
+            selectKernels(table, detectSimdLevel());
+        }
+    };
+
+    static Initialiser initialiser;
+    return initialiser.table;
+}
+
+
+//! Fill the kernel table for a given level
+inline void DotProduct::selectKernels(KernelTable& table, SimdLevel::Type level)
+{
+    table.level = SimdLevel::SCALAR;
+    table.floatKernel = &DotProduct::dotScalar;
+    table.doubleKernel = &DotProduct::dotScalar;
+    table.int16Kernel = &DotProduct::dotScalar;
+    table.floatFoldedKernel = &DotProduct::foldedDotScalar;
+    table.doubleFoldedKernel = &DotProduct::foldedDotScalar;
+    table.floatLaneKernel = &DotProduct::laneDotScalar;
+    table.doubleLaneKernel = &DotProduct::laneDotScalar;
+
+#if DOTPRODUCT_X86_DISPATCH
+    switch( level )
+    {
+        case SimdLevel::AVX512:
+        {
+            table.level = SimdLevel::AVX512;
+            table.floatKernel = &DotProduct::dotAvx512;
+            table.doubleKernel = &DotProduct::dotAvx512;
+            table.int16Kernel = &DotProduct::dotAvx512;
+            table.floatFoldedKernel = &DotProduct::foldedDotAvx512;
+            table.doubleFoldedKernel = &DotProduct::foldedDotAvx512;
+            table.floatLaneKernel = &DotProduct::laneDotAvx512;
+            table.doubleLaneKernel = &DotProduct::laneDotAvx512;
+            break;
+        }
+
+        case SimdLevel::AVX2:
+        {
+            table.level = SimdLevel::AVX2;
+            table.floatKernel = &DotProduct::dotAvx2;
+            table.doubleKernel = &DotProduct::dotAvx2;
+            table.int16Kernel = &DotProduct::dotAvx2;
+            table.floatFoldedKernel = &DotProduct::foldedDotAvx2;
+            table.doubleFoldedKernel = &DotProduct::foldedDotAvx2;
+            table.floatLaneKernel = &DotProduct::laneDotAvx2;
+            table.doubleLaneKernel = &DotProduct::laneDotAvx2;
+            break;
+        }
+
+        case SimdLevel::SSE2:
+        {
+            table.level = SimdLevel::SSE2;
+            table.floatKernel = &DotProduct::dotSse2;
+            table.doubleKernel = &DotProduct::dotSse2;
+            table.int16Kernel = &DotProduct::dotSse2;
+            table.floatFoldedKernel = &DotProduct::foldedDotSse2;
+            table.doubleFoldedKernel = &DotProduct::foldedDotSse2;
+            table.floatLaneKernel = &DotProduct::laneDotSse2;
+            table.doubleLaneKernel = &DotProduct::laneDotSse2;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+#else
+    (void)level;
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+// Scalar kernels
+//------------------------------------------------------------------------------
+
+//! Scalar kernel - float
+inline float DotProduct::dotScalar(const float * x, const float * h, size_t length)
+{
+    return dot<float>(x, h, length);
+}
+
+
+//! Scalar kernel - double
+inline double DotProduct::dotScalar(const double * x, const double * h, size_t length)
+{
+    return dot<double>(x, h, length);
+}
+
+
+//! Scalar kernel - int16
+inline int32_t DotProduct::dotScalar(const int16_t * x, const int16_t * h, size_t length)
+{
+    // Unsigned arithmetic so wrap around matches the SIMD kernels
+    uint32_t sum = 0;
+    for( size_t i = 0; i < length; i++ )
+    {
+        sum += (uint32_t)((int32_t)x[i] * (int32_t)h[i]);
+    }
+    return (int32_t)sum;
+}
+
+
+//! Scalar folded kernel - float
+inline float DotProduct::foldedDotScalar(const float * x, const float * h, size_t length)
+{
+    return foldedDot<float>(x, h, length);
+}
+
+
+//! Scalar folded kernel - double
+inline double DotProduct::foldedDotScalar(const double * x, const double * h, size_t length)
+{
+    return foldedDot<double>(x, h, length);
+}
+
+
+//! Scalar lane kernel - float
+inline void DotProduct::laneDotScalar(const float * x, size_t stride, const float * h, 
+    size_t length, float * y, size_t lanes)
+{
+    laneDot<float>(x, stride, h, length, y, lanes);
+}
+
+
+//! Scalar lane kernel - double
+inline void DotProduct::laneDotScalar(const double * x, size_t stride, const double * h, 
+    size_t length, double * y, size_t lanes)
+{
+    laneDot<double>(x, stride, h, length, y, lanes);
+}
+
+
+#if DOTPRODUCT_X86_DISPATCH
+
+//------------------------------------------------------------------------------
+// SSE2 kernels
+//------------------------------------------------------------------------------
+
+//! SSE2 kernel - float
+DOTPRODUCT_TARGET("sse2")
+inline float DotProduct::dotSse2(const float * x, const float * h, size_t length)
+{
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+
+    size_t i = 0;
+    for( ; i + 8 <= length; i += 8 )
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(h + i + 4)));
+    }
+
+    sum0 = _mm_add_ps(sum0, sum1);
+    sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+    sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+    float sum = _mm_cvtss_f32(sum0);
+
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! SSE2 kernel - double
+DOTPRODUCT_TARGET("sse2")
+inline double DotProduct::dotSse2(const double * x, const double * h, size_t length)
+{
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+
+    size_t i = 0;
+    for( ; i + 4 <= length; i += 4 )
+    {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(h + i)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(h + i + 2)));
+    }
+
+    sum0 = _mm_add_pd(sum0, sum1);
+    sum0 = _mm_add_sd(sum0, _mm_unpackhi_pd(sum0, sum0));
+    double sum = _mm_cvtsd_f64(sum0);
+
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! SSE2 kernel - int16
+DOTPRODUCT_TARGET("sse2")
+inline int32_t DotProduct::dotSse2(const int16_t * x, const int16_t * h, size_t length)
+{
+    __m128i sum0 = _mm_setzero_si128();
+
+    size_t i = 0;
+    for( ; i + 8 <= length; i += 8 )
+    {
+        __m128i xv = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i hv = _mm_loadu_si128((const __m128i *)(h + i));
+        sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(xv, hv));
+    }
+
+    sum0 = _mm_add_epi32(sum0, _mm_shuffle_epi32(sum0, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum0 = _mm_add_epi32(sum0, _mm_shuffle_epi32(sum0, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(sum0);
+
+    for( ; i < length; i++ )
+    {
+        sum += (uint32_t)((int32_t)x[i] * (int32_t)h[i]);
+    }
+    return (int32_t)sum;
+}
+
+//! SSE2 folded kernel - float
+DOTPRODUCT_TARGET("sse2")
+inline float DotProduct::foldedDotSse2(const float * x, const float * h, size_t length)
+{
+    size_t half = length / 2;
+    const float * xBack = x + length;
+    __m128 sum0 = _mm_setzero_ps();
+
+    size_t j = 0;
+    for( ; j + 4 <= half; j += 4 )
+    {
+        __m128 back = _mm_loadu_ps(xBack - j - 4);
+        back = _mm_shuffle_ps(back, back, _MM_SHUFFLE(0, 1, 2, 3));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(h + j),
+                                           _mm_add_ps(_mm_loadu_ps(x + j), back)));
+    }
+
+    sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+    sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+    float sum = _mm_cvtss_f32(sum0);
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! SSE2 folded kernel - double
+DOTPRODUCT_TARGET("sse2")
+inline double DotProduct::foldedDotSse2(const double * x, const double * h, size_t length)
+{
+    size_t half = length / 2;
+    const double * xBack = x + length;
+    __m128d sum0 = _mm_setzero_pd();
+
+    size_t j = 0;
+    for( ; j + 2 <= half; j += 2 )
+    {
+        __m128d back = _mm_loadu_pd(xBack - j - 2);
+        back = _mm_shuffle_pd(back, back, 1);
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(h + j),
+                                           _mm_add_pd(_mm_loadu_pd(x + j), back)));
+    }
+
+    sum0 = _mm_add_sd(sum0, _mm_unpackhi_pd(sum0, sum0));
+    double sum = _mm_cvtsd_f64(sum0);
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! SSE2 lane kernel - float
+DOTPRODUCT_TARGET("sse2")
+inline void DotProduct::laneDotSse2(const float * x, size_t stride, const float * h, 
+    size_t length, float * y, size_t lanes)
+{
+    size_t c = 0;
+    for( ; c + 16 <= lanes; c += 16 )
+    {
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        __m128 sum2 = _mm_setzero_ps();
+        __m128 sum3 = _mm_setzero_ps();
+
+        const float * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m128 hj = _mm_set1_ps(h[j]);
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(hj, _mm_loadu_ps(row)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(hj, _mm_loadu_ps(row + 4)));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(hj, _mm_loadu_ps(row + 8)));
+            sum3 = _mm_add_ps(sum3, _mm_mul_ps(hj, _mm_loadu_ps(row + 12)));
+        }
+
+        _mm_storeu_ps(y + c, sum0);
+        _mm_storeu_ps(y + c + 4, sum1);
+        _mm_storeu_ps(y + c + 8, sum2);
+        _mm_storeu_ps(y + c + 12, sum3);
+    }
+    for( ; c + 4 <= lanes; c += 4 )
+    {
+        __m128 sum0 = _mm_setzero_ps();
+
+        const float * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_set1_ps(h[j]), _mm_loadu_ps(row)));
+        }
+
+        _mm_storeu_ps(y + c, sum0);
+    }
+
+    laneDot<float>(x + c, stride, h, length, y + c, lanes - c);
+}
+
+
+//! SSE2 lane kernel - double
+DOTPRODUCT_TARGET("sse2")
+inline void DotProduct::laneDotSse2(const double * x, size_t stride, const double * h, 
+    size_t length, double * y, size_t lanes)
+{
+    size_t c = 0;
+    for( ; c + 8 <= lanes; c += 8 )
+    {
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        __m128d sum2 = _mm_setzero_pd();
+        __m128d sum3 = _mm_setzero_pd();
+
+        const double * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m128d hj = _mm_set1_pd(h[j]);
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(hj, _mm_loadu_pd(row)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(hj, _mm_loadu_pd(row + 2)));
+            sum2 = _mm_add_pd(sum2, _mm_mul_pd(hj, _mm_loadu_pd(row + 4)));
+            sum3 = _mm_add_pd(sum3, _mm_mul_pd(hj, _mm_loadu_pd(row + 6)));
+        }
+
+        _mm_storeu_pd(y + c, sum0);
+        _mm_storeu_pd(y + c + 2, sum1);
+        _mm_storeu_pd(y + c + 4, sum2);
+        _mm_storeu_pd(y + c + 6, sum3);
+    }
+    for( ; c + 2 <= lanes; c += 2 )
+    {
+        __m128d sum0 = _mm_setzero_pd();
+
+        const double * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_set1_pd(h[j]), _mm_loadu_pd(row)));
+        }
+
+        _mm_storeu_pd(y + c, sum0);
+    }
+
+    laneDot<double>(x + c, stride, h, length, y + c, lanes - c);
+}
+
+
+//------------------------------------------------------------------------------
+// AVX2 kernels
+//------------------------------------------------------------------------------
+
+//! AVX2 kernel - float
+DOTPRODUCT_TARGET("avx2,fma")
+inline float DotProduct::dotAvx2(const float * x, const float * h, size_t length)
+{
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for( ; i + 32 <= length; i += 32 )
+    {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(h + i + 8), sum1);
+        sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(h + i + 16), sum2);
+        sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(h + i + 24), sum3);
+    }
+    for( ; i + 8 <= length; i += 8 )
+    {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), sum0);
+    }
+
+    sum0 = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_movehdup_ps(sum4));
+    float sum = _mm_cvtss_f32(sum4);
+
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! AVX2 kernel - double
+DOTPRODUCT_TARGET("avx2,fma")
+inline double DotProduct::dotAvx2(const double * x, const double * h, size_t length)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    __m256d sum2 = _mm256_setzero_pd();
+    __m256d sum3 = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for( ; i + 16 <= length; i += 16 )
+    {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(h + i), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(h + i + 4), sum1);
+        sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(h + i + 8), sum2);
+        sum3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(h + i + 12), sum3);
+    }
+    for( ; i + 4 <= length; i += 4 )
+    {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(h + i), sum0);
+    }
+
+    sum0 = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+    __m128d sum4 = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+    sum4 = _mm_add_sd(sum4, _mm_unpackhi_pd(sum4, sum4));
+    double sum = _mm_cvtsd_f64(sum4);
+
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! AVX2 kernel - int16
+DOTPRODUCT_TARGET("avx2,fma")
+inline int32_t DotProduct::dotAvx2(const int16_t * x, const int16_t * h, size_t length)
+{
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for( ; i + 32 <= length; i += 32 )
+    {
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(x + i)),
+            _mm256_loadu_si256((const __m256i *)(h + i))));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(x + i + 16)),
+            _mm256_loadu_si256((const __m256i *)(h + i + 16))));
+    }
+    for( ; i + 16 <= length; i += 16 )
+    {
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(x + i)),
+            _mm256_loadu_si256((const __m256i *)(h + i))));
+    }
+
+    sum0 = _mm256_add_epi32(sum0, sum1);
+    __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(sum0), _mm256_extracti128_si256(sum0, 1));
+    sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(sum4);
+
+    for( ; i < length; i++ )
+    {
+        sum += (uint32_t)((int32_t)x[i] * (int32_t)h[i]);
+    }
+    return (int32_t)sum;
+}
+
+//! AVX2 folded kernel - float
+DOTPRODUCT_TARGET("avx2,fma")
+inline float DotProduct::foldedDotAvx2(const float * x, const float * h, size_t length)
+{
+    size_t half = length / 2;
+    const float * xBack = x + length;
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+
+    size_t j = 0;
+    for( ; j + 16 <= half; j += 16 )
+    {
+        __m256 back0 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(xBack - j - 8), reverse);
+        __m256 back1 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(xBack - j - 16), reverse);
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(h + j),
+                               _mm256_add_ps(_mm256_loadu_ps(x + j), back0), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(h + j + 8),
+                               _mm256_add_ps(_mm256_loadu_ps(x + j + 8), back1), sum1);
+    }
+    for( ; j + 8 <= half; j += 8 )
+    {
+        __m256 back0 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(xBack - j - 8), reverse);
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(h + j),
+                               _mm256_add_ps(_mm256_loadu_ps(x + j), back0), sum0);
+    }
+
+    sum0 = _mm256_add_ps(sum0, sum1);
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_movehdup_ps(sum4));
+    float sum = _mm_cvtss_f32(sum4);
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! AVX2 folded kernel - double
+DOTPRODUCT_TARGET("avx2,fma")
+inline double DotProduct::foldedDotAvx2(const double * x, const double * h, size_t length)
+{
+    size_t half = length / 2;
+    const double * xBack = x + length;
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+
+    size_t j = 0;
+    for( ; j + 8 <= half; j += 8 )
+    {
+        __m256d back0 = _mm256_permute4x64_pd(_mm256_loadu_pd(xBack - j - 4), _MM_SHUFFLE(0, 1, 2, 3));
+        __m256d back1 = _mm256_permute4x64_pd(_mm256_loadu_pd(xBack - j - 8), _MM_SHUFFLE(0, 1, 2, 3));
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(h + j),
+                               _mm256_add_pd(_mm256_loadu_pd(x + j), back0), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(h + j + 4),
+                               _mm256_add_pd(_mm256_loadu_pd(x + j + 4), back1), sum1);
+    }
+    for( ; j + 4 <= half; j += 4 )
+    {
+        __m256d back0 = _mm256_permute4x64_pd(_mm256_loadu_pd(xBack - j - 4), _MM_SHUFFLE(0, 1, 2, 3));
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(h + j),
+                               _mm256_add_pd(_mm256_loadu_pd(x + j), back0), sum0);
+    }
+
+    sum0 = _mm256_add_pd(sum0, sum1);
+    __m128d sum4 = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+    sum4 = _mm_add_sd(sum4, _mm_unpackhi_pd(sum4, sum4));
+    double sum = _mm_cvtsd_f64(sum4);
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! AVX2 lane kernel - float
+DOTPRODUCT_TARGET("avx2,fma")
+inline void DotProduct::laneDotAvx2(const float * x, size_t stride, const float * h, 
+    size_t length, float * y, size_t lanes)
+{
+    size_t c = 0;
+    for( ; c + 32 <= lanes; c += 32 )
+    {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        const float * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m256 hj = _mm256_set1_ps(h[j]);
+            sum0 = _mm256_fmadd_ps(hj, _mm256_loadu_ps(row), sum0);
+            sum1 = _mm256_fmadd_ps(hj, _mm256_loadu_ps(row + 8), sum1);
+            sum2 = _mm256_fmadd_ps(hj, _mm256_loadu_ps(row + 16), sum2);
+            sum3 = _mm256_fmadd_ps(hj, _mm256_loadu_ps(row + 24), sum3);
+        }
+
+        _mm256_storeu_ps(y + c, sum0);
+        _mm256_storeu_ps(y + c + 8, sum1);
+        _mm256_storeu_ps(y + c + 16, sum2);
+        _mm256_storeu_ps(y + c + 24, sum3);
+    }
+    for( ; c + 8 <= lanes; c += 8 )
+    {
+        __m256 sum0 = _mm256_setzero_ps();
+
+        const float * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            sum0 = _mm256_fmadd_ps(_mm256_set1_ps(h[j]), _mm256_loadu_ps(row), sum0);
+        }
+
+        _mm256_storeu_ps(y + c, sum0);
+    }
+
+    laneDot<float>(x + c, stride, h, length, y + c, lanes - c);
+}
+
+
+//! AVX2 lane kernel - double
+DOTPRODUCT_TARGET("avx2,fma")
+inline void DotProduct::laneDotAvx2(const double * x, size_t stride, const double * h, 
+    size_t length, double * y, size_t lanes)
+{
+    size_t c = 0;
+    for( ; c + 16 <= lanes; c += 16 )
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d sum3 = _mm256_setzero_pd();
+
+        const double * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m256d hj = _mm256_set1_pd(h[j]);
+            sum0 = _mm256_fmadd_pd(hj, _mm256_loadu_pd(row), sum0);
+            sum1 = _mm256_fmadd_pd(hj, _mm256_loadu_pd(row + 4), sum1);
+            sum2 = _mm256_fmadd_pd(hj, _mm256_loadu_pd(row + 8), sum2);
+            sum3 = _mm256_fmadd_pd(hj, _mm256_loadu_pd(row + 12), sum3);
+        }
+
+        _mm256_storeu_pd(y + c, sum0);
+        _mm256_storeu_pd(y + c + 4, sum1);
+        _mm256_storeu_pd(y + c + 8, sum2);
+        _mm256_storeu_pd(y + c + 12, sum3);
+    }
+    for( ; c + 4 <= lanes; c += 4 )
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+
+        const double * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            sum0 = _mm256_fmadd_pd(_mm256_set1_pd(h[j]), _mm256_loadu_pd(row), sum0);
+        }
+
+        _mm256_storeu_pd(y + c, sum0);
+    }
+
+    laneDot<double>(x + c, stride, h, length, y + c, lanes - c);
+}
+
+
+//------------------------------------------------------------------------------
+// AVX-512 kernels
+//------------------------------------------------------------------------------
+
+//! AVX-512 kernel - float
+DOTPRODUCT_TARGET("avx512f")
+inline float DotProduct::dotAvx512(const float * x, const float * h, size_t length)
+{
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    __m512 sum2 = _mm512_setzero_ps();
+    __m512 sum3 = _mm512_setzero_ps();
+
+    size_t i = 0;
+    for( ; i + 64 <= length; i += 64 )
+    {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(h + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(h + i + 16), sum1);
+        sum2 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(h + i + 32), sum2);
+        sum3 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(h + i + 48), sum3);
+    }
+    for( ; i + 16 <= length; i += 16 )
+    {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(h + i), sum0);
+    }
+
+    sum0 = _mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3));
+    float sum = _mm512_reduce_add_ps(sum0);
+
+    // Scalar tail - a masked load over the sample just appended cannot be
+    // store forwarded and stalls for longer than the tail takes
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! AVX-512 kernel - double
+DOTPRODUCT_TARGET("avx512f")
+inline double DotProduct::dotAvx512(const double * x, const double * h, size_t length)
+{
+    __m512d sum0 = _mm512_setzero_pd();
+    __m512d sum1 = _mm512_setzero_pd();
+    __m512d sum2 = _mm512_setzero_pd();
+    __m512d sum3 = _mm512_setzero_pd();
+
+    size_t i = 0;
+    for( ; i + 32 <= length; i += 32 )
+    {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(h + i), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(h + i + 8), sum1);
+        sum2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(h + i + 16), sum2);
+        sum3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(h + i + 24), sum3);
+    }
+    for( ; i + 8 <= length; i += 8 )
+    {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(h + i), sum0);
+    }
+
+    sum0 = _mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3));
+    double sum = _mm512_reduce_add_pd(sum0);
+
+    // Scalar tail - a masked load over the sample just appended cannot be
+    // store forwarded and stalls for longer than the tail takes
+    for( ; i < length; i++ )
+    {
+        sum += x[i] * h[i];
+    }
+    return sum;
+}
+
+
+//! AVX-512 kernel - int16
+DOTPRODUCT_TARGET("avx512f,avx512bw")
+inline int32_t DotProduct::dotAvx512(const int16_t * x, const int16_t * h, size_t length)
+{
+    __m512i sum0 = _mm512_setzero_si512();
+    __m512i sum1 = _mm512_setzero_si512();
+
+    size_t i = 0;
+    for( ; i + 64 <= length; i += 64 )
+    {
+        sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(
+            _mm512_loadu_si512((const void *)(x + i)),
+            _mm512_loadu_si512((const void *)(h + i))));
+        sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(
+            _mm512_loadu_si512((const void *)(x + i + 32)),
+            _mm512_loadu_si512((const void *)(h + i + 32))));
+    }
+    for( ; i + 32 <= length; i += 32 )
+    {
+        sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(
+            _mm512_loadu_si512((const void *)(x + i)),
+            _mm512_loadu_si512((const void *)(h + i))));
+    }
+
+    sum0 = _mm512_add_epi32(sum0, sum1);
+    uint32_t sum = (uint32_t)_mm512_reduce_add_epi32(sum0);
+
+    // Scalar tail - see dotAvx512(float)
+    for( ; i < length; i++ )
+    {
+        sum += (uint32_t)((int32_t)x[i] * (int32_t)h[i]);
+    }
+    return (int32_t)sum;
+}
+
+//! AVX-512 folded kernel - float
+DOTPRODUCT_TARGET("avx512f")
+inline float DotProduct::foldedDotAvx512(const float * x, const float * h, size_t length)
+{
+    size_t half = length / 2;
+    const float * xBack = x + length;
+    const __m512i reverse = _mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8,
+                                              7, 6, 5, 4, 3, 2, 1, 0);
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+
+    size_t j = 0;
+    for( ; j + 32 <= half; j += 32 )
+    {
+        __m512 back0 = _mm512_permutexvar_ps(reverse, _mm512_loadu_ps(xBack - j - 16));
+        __m512 back1 = _mm512_permutexvar_ps(reverse, _mm512_loadu_ps(xBack - j - 32));
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(h + j),
+                               _mm512_add_ps(_mm512_loadu_ps(x + j), back0), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(h + j + 16),
+                               _mm512_add_ps(_mm512_loadu_ps(x + j + 16), back1), sum1);
+    }
+    for( ; j + 16 <= half; j += 16 )
+    {
+        __m512 back0 = _mm512_permutexvar_ps(reverse, _mm512_loadu_ps(xBack - j - 16));
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(h + j),
+                               _mm512_add_ps(_mm512_loadu_ps(x + j), back0), sum0);
+    }
+
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! AVX-512 folded kernel - double
+DOTPRODUCT_TARGET("avx512f")
+inline double DotProduct::foldedDotAvx512(const double * x, const double * h, size_t length)
+{
+    size_t half = length / 2;
+    const double * xBack = x + length;
+    const __m512i reverse = _mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    __m512d sum0 = _mm512_setzero_pd();
+    __m512d sum1 = _mm512_setzero_pd();
+
+    size_t j = 0;
+    for( ; j + 16 <= half; j += 16 )
+    {
+        __m512d back0 = _mm512_permutexvar_pd(reverse, _mm512_loadu_pd(xBack - j - 8));
+        __m512d back1 = _mm512_permutexvar_pd(reverse, _mm512_loadu_pd(xBack - j - 16));
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(h + j),
+                               _mm512_add_pd(_mm512_loadu_pd(x + j), back0), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(h + j + 8),
+                               _mm512_add_pd(_mm512_loadu_pd(x + j + 8), back1), sum1);
+    }
+    for( ; j + 8 <= half; j += 8 )
+    {
+        __m512d back0 = _mm512_permutexvar_pd(reverse, _mm512_loadu_pd(xBack - j - 8));
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(h + j),
+                               _mm512_add_pd(_mm512_loadu_pd(x + j), back0), sum0);
+    }
+
+    double sum = _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+
+    for( ; j < half; j++ )
+    {
+        sum += h[j] * (x[j] + x[length - 1 - j]);
+    }
+    if( length & 1 )
+    {
+        sum += h[half] * x[half];
+    }
+    return sum;
+}
+
+
+//! AVX-512 lane kernel - float
+DOTPRODUCT_TARGET("avx512f")
+inline void DotProduct::laneDotAvx512(const float * x, size_t stride, const float * h, 
+    size_t length, float * y, size_t lanes)
+{
+    // Up to 64 lanes per pass over the taps, masked so that a partial pass
+    // still keeps four independent accumulators
+    for( size_t c = 0; c < lanes; c += 64 )
+    {
+        __mmask16 mask[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            size_t first = c + 16 * k;
+            size_t remaining = (lanes > first) ? (lanes - first) : 0;
+            mask[k] = (remaining >= 16) ? (__mmask16)0xFFFF 
+                                        : (__mmask16)((1u << remaining) - 1u);
+        }
+
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+
+        const float * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m512 hj = _mm512_set1_ps(h[j]);
+            sum0 = _mm512_fmadd_ps(hj, _mm512_maskz_loadu_ps(mask[0], row), sum0);
+            sum1 = _mm512_fmadd_ps(hj, _mm512_maskz_loadu_ps(mask[1], row + 16), sum1);
+            sum2 = _mm512_fmadd_ps(hj, _mm512_maskz_loadu_ps(mask[2], row + 32), sum2);
+            sum3 = _mm512_fmadd_ps(hj, _mm512_maskz_loadu_ps(mask[3], row + 48), sum3);
+        }
+
+        _mm512_mask_storeu_ps(y + c, mask[0], sum0);
+        _mm512_mask_storeu_ps(y + c + 16, mask[1], sum1);
+        _mm512_mask_storeu_ps(y + c + 32, mask[2], sum2);
+        _mm512_mask_storeu_ps(y + c + 48, mask[3], sum3);
+    }
+}
+
+
+//! AVX-512 lane kernel - double
+DOTPRODUCT_TARGET("avx512f")
+inline void DotProduct::laneDotAvx512(const double * x, size_t stride, const double * h, 
+    size_t length, double * y, size_t lanes)
+{
+    // Up to 32 lanes per pass over the taps, masked so that a partial pass
+    // still keeps four independent accumulators
+    for( size_t c = 0; c < lanes; c += 32 )
+    {
+        __mmask8 mask[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            size_t first = c + 8 * k;
+            size_t remaining = (lanes > first) ? (lanes - first) : 0;
+            mask[k] = (remaining >= 8) ? (__mmask8)0xFF 
+                                       : (__mmask8)((1u << remaining) - 1u);
+        }
+
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        __m512d sum2 = _mm512_setzero_pd();
+        __m512d sum3 = _mm512_setzero_pd();
+
+        const double * row = x + c;
+        for( size_t j = 0; j < length; j++, row += stride )
+        {
+            __m512d hj = _mm512_set1_pd(h[j]);
+            sum0 = _mm512_fmadd_pd(hj, _mm512_maskz_loadu_pd(mask[0], row), sum0);
+            sum1 = _mm512_fmadd_pd(hj, _mm512_maskz_loadu_pd(mask[1], row + 8), sum1);
+            sum2 = _mm512_fmadd_pd(hj, _mm512_maskz_loadu_pd(mask[2], row + 16), sum2);
+            sum3 = _mm512_fmadd_pd(hj, _mm512_maskz_loadu_pd(mask[3], row + 24), sum3);
+        }
+
+        _mm512_mask_storeu_pd(y + c, mask[0], sum0);
+        _mm512_mask_storeu_pd(y + c + 8, mask[1], sum1);
+        _mm512_mask_storeu_pd(y + c + 16, mask[2], sum2);
+        _mm512_mask_storeu_pd(y + c + 24, mask[3], sum3);
+    }
+}
+
+#endif // DOTPRODUCT_X86_DISPATCH
+
+
+#endif // DOTPRODUCT_H
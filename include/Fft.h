@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// Fft.h
+//
+//------------------------------------------------------------------------------
+//
+// Self-contained radix-2 real FFT.
+//
+// A real sequence of length N is transformed by packing the even and odd
+// samples into the real and imaginary parts of a length N/2 complex sequence,
+// doing an iterative decimation-in-time complex FFT, and then separating the
+// two halves with one extra twiddle pass.
+// https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm
+//
+// Spectra are held as split real and imaginary arrays of N/2+1 bins (DC to
+// Nyquist) as this suits vectorised complex multiply-accumulates.
+//
+// Twiddle factors are calculated once, in double precision, at construction.
+// forward() and inverse() do not allocate.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+template <typename DataType>
+class Fft
+{
+public:
+
+    //! Constructor
+    //! size = the transform length. Rounded up to a power of two (minimum 2).
+    Fft(size_t size);
+
+    //! Destructor
+    virtual ~Fft();
+
+    //! Get the transform length
+    size_t size();
+
+    //! Get the number of spectrum bins (size/2 + 1)
+    size_t spectrumSize();
+
+    //! Forward real FFT
+    //! input = size() real samples
+    //! outputReal, outputImag = spectrumSize() bins
+    void forward(const DataType * input, DataType * outputReal, DataType * outputImag);
+
+    //! Inverse real FFT - scaled by 1/size() so that inverse(forward(x)) == x
+    //! inputReal, inputImag = spectrumSize() bins
+    //! output = size() real samples
+    void inverse(const DataType * inputReal, const DataType * inputImag, DataType * output);
+
+    //! Smallest power of two >= value
+    static size_t nextPowerOfTwo(size_t value);
+
+protected:
+
+private:
+    //! In place complex FFT of length m_halfSize on the work arrays
+    void transform(DataType * real, DataType * imag);
+
+    //! Real transform length
+    size_t m_size;
+
+    //! Complex transform length
+    size_t m_halfSize;
+
+    //! Bit reversal permutation for the complex transform
+    std::vector<size_t> m_bitReverse;
+
+    //! Complex transform twiddles e^(-2*pi*i*k/m_halfSize)
+    std::vector<DataType> m_twiddleReal;
+    std::vector<DataType> m_twiddleImag;
+
+    //! Real separation twiddles e^(-2*pi*i*k/m_size)
+    std::vector<DataType> m_splitReal;
+    std::vector<DataType> m_splitImag;
+
+    //! Work arrays
+    std::vector<DataType> m_workReal;
+    std::vector<DataType> m_workImag;
+
+}; // class Fft
+
+
+//! Constructor
+template <typename DataType>
+Fft<DataType>::Fft(size_t size)
+    : m_size(nextPowerOfTwo(size < 2 ? 2 : size)), m_halfSize(m_size/2),
+      m_bitReverse(m_halfSize), m_twiddleReal(m_halfSize/2 + 1), m_twiddleImag(m_halfSize/2 + 1),
+      m_splitReal(m_halfSize + 1), m_splitImag(m_halfSize + 1),
+      m_workReal(m_halfSize), m_workImag(m_halfSize)
+{
+    // Bit reversal table
+    size_t bits = 0;
+    while( ((size_t)1 << bits) < m_halfSize )
+    {
+        bits++;
+    }
+
+    for( size_t i = 0; i < m_halfSize; i++ )
+    {
+        size_t reversed = 0;
+        for( size_t b = 0; b < bits; b++ )
+        {
+            if( i & ((size_t)1 << b) )
+            {
+                reversed |= (size_t)1 << (bits - 1 - b);
+            }
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    // Twiddles
+    for( size_t k = 0; k < m_twiddleReal.size(); k++ )
+    {
+        double angle = -2.0 * M_PI * (double)k / (double)m_halfSize;
+        m_twiddleReal[k] = (DataType)cos(angle);
+        m_twiddleImag[k] = (DataType)sin(angle);
+    }
+
+    for( size_t k = 0; k <= m_halfSize; k++ )
+    {
+        double angle = -2.0 * M_PI * (double)k / (double)m_size;
+        m_splitReal[k] = (DataType)cos(angle);
+        m_splitImag[k] = (DataType)sin(angle);
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+Fft<DataType>::~Fft()
+{
+}
+
+
+//! Get the transform length
+template <typename DataType>
+size_t Fft<DataType>::size()
+{
+    return m_size;
+}
+
+
+//! Get the number of spectrum bins (size/2 + 1)
+template <typename DataType>
+size_t Fft<DataType>::spectrumSize()
+{
+    return m_halfSize + 1;
+}
+
+
+//! Forward real FFT
+template <typename DataType>
+void Fft<DataType>::forward(const DataType * input, DataType * outputReal, DataType * outputImag)
+{
+    DataType * zr = &m_workReal[0];
+    DataType * zi = &m_workImag[0];
+
+    // Pack even/odd samples as complex, in bit reversed order
+    for( size_t n = 0; n < m_halfSize; n++ )
+    {
+        size_t r = m_bitReverse[n];
+        zr[r] = input[2*n];
+        zi[r] = input[2*n + 1];
+    }
+
+    transform(zr, zi);
+
+    // Separate: X[k] = Fe[k] + W^k Fo[k]
+    // Fe[k] = (Z[k] + conj(Z[M-k]))/2, Fo[k] = (Z[k] - conj(Z[M-k]))/(2i)
+    for( size_t k = 0; k <= m_halfSize; k++ )
+    {
+        size_t a = (k == m_halfSize) ? 0 : k;
+        size_t b = (k == 0) ? 0 : (m_halfSize - k);
+
+        DataType feReal = (zr[a] + zr[b]) * DataType(0.5);
+        DataType feImag = (zi[a] - zi[b]) * DataType(0.5);
+        DataType foReal = (zi[a] + zi[b]) * DataType(0.5);
+        DataType foImag = (zr[b] - zr[a]) * DataType(0.5);
+
+        outputReal[k] = feReal + m_splitReal[k] * foReal - m_splitImag[k] * foImag;
+        outputImag[k] = feImag + m_splitReal[k] * foImag + m_splitImag[k] * foReal;
+    }
+}
+
+
+//! Inverse real FFT - scaled by 1/size()
+template <typename DataType>
+void Fft<DataType>::inverse(const DataType * inputReal, const DataType * inputImag, DataType * output)
+{
+    DataType * zr = &m_workReal[0];
+    DataType * zi = &m_workImag[0];
+
+    // Recombine: Fe[k] = (X[k] + conj(X[M-k]))/2, Fo[k] = (X[k] - conj(X[M-k])) W^-k / 2
+    // Z[k] = Fe[k] + i Fo[k]
+    // The inverse complex transform is done as conj(FFT(conj(Z))).
+    for( size_t k = 0; k < m_halfSize; k++ )
+    {
+        size_t b = m_halfSize - k;
+
+        DataType feReal = (inputReal[k] + inputReal[b]) * DataType(0.5);
+        DataType feImag = (inputImag[k] - inputImag[b]) * DataType(0.5);
+        DataType dReal = (inputReal[k] - inputReal[b]) * DataType(0.5);
+        DataType dImag = (inputImag[k] + inputImag[b]) * DataType(0.5);
+
+        // Multiply by W^-k = conj(W^k)
+        DataType foReal = dReal * m_splitReal[k] + dImag * m_splitImag[k];
+        DataType foImag = dImag * m_splitReal[k] - dReal * m_splitImag[k];
+
+        size_t r = m_bitReverse[k];
+        zr[r] = feReal - foImag;
+        zi[r] = -(feImag + foReal);
+    }
+
+    transform(zr, zi);
+
+    DataType scale = DataType(1) / (DataType)m_halfSize;
+    for( size_t n = 0; n < m_halfSize; n++ )
+    {
+        output[2*n] = zr[n] * scale;
+        output[2*n + 1] = -zi[n] * scale;
+    }
+}
+
+
+//! Smallest power of two >= value
+template <typename DataType>
+size_t Fft<DataType>::nextPowerOfTwo(size_t value)
+{
+    size_t power = 1;
+    while( power < value )
+    {
+        power <<= 1;
+    }
+    return power;
+}
+
+
+//! In place complex FFT of length m_halfSize - input in bit reversed order
+template <typename DataType>
+void Fft<DataType>::transform(DataType * real, DataType * imag)
+{
+    for( size_t span = 1; span < m_halfSize; span <<= 1 )
+    {
+        size_t twiddleStep = m_halfSize / (2*span);
+
+        for( size_t start = 0; start < m_halfSize; start += 2*span )
+        {
+            for( size_t j = 0; j < span; j++ )
+            {
+                DataType wr = m_twiddleReal[j * twiddleStep];
+                DataType wi = m_twiddleImag[j * twiddleStep];
+
+                size_t a = start + j;
+                size_t b = a + span;
+
+                DataType tr = wr * real[b] - wi * imag[b];
+                DataType ti = wr * imag[b] + wi * real[b];
+
+                real[b] = real[a] - tr;
+                imag[b] = imag[a] - ti;
+                real[a] = real[a] + tr;
+                imag[a] = imag[a] + ti;
+            }
+        }
+    }
+}
+
+
+#endif // FFT_H
@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FftConvolver.h
+//
+//------------------------------------------------------------------------------
+//
+// Uniformly partitioned overlap-save convolution for long FIR filters.
+//
+// The filter is cut into P partitions of blockSize taps, each zero padded to
+// 2*blockSize and transformed once at construction. Each input block is
+// transformed once and kept in a frequency-domain delay line, and the output
+// block is the inverse transform of sum(X[k-p] * H[p]) with the first half
+// discarded (overlap-save). The cost per sample is two FFTs of 2*blockSize
+// plus P complex multiply-accumulates per bin, instead of (order+1) MACs.
+// http://www.dspguide.com/ch18/2.htm
+//
+// Input is processed in whole blocks of blockSize() with no added latency.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FFTCONVOLVER_H
+#define FFTCONVOLVER_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "Fft.h"
+
+template <typename DataType>
+class FftConvolver
+{
+public:
+
+    //! Constructor
+    //! filter = the filter designed by FilterFactory::createFilter
+    //! blockSize = the number of samples per processed block (rounded up to a 
+    //! power of two)
+    FftConvolver(const BasicFilterHolderType<DataType>& filter, size_t blockSize);
+
+    //! Destructor
+    virtual ~FftConvolver();
+
+    //! Reset the filter state (history) to zero
+    void reset();
+
+    //! Get the block size
+    size_t blockSize();
+
+    //! Get the number of filter partitions
+    size_t partitionCount();
+
+    //! Filter whole blocks of samples. input and output may be the same buffer.
+    //! Returns the number of samples processed - a multiple of blockSize(), 
+    //! any remainder is left untouched. A filter with no taps outputs zeros.
+    size_t processBlock(const DataType * const input, DataType * output, size_t length);
+
+protected:
+
+private:
+    //! Process exactly one block
+    void processOneBlock(const DataType * const input, DataType * output);
+
+    //! Block Size
+    size_t m_blockSize;
+
+    //! Spectrum bins per transform
+    size_t m_binCount;
+
+    //! Number of partitions
+    size_t m_partitionCount;
+
+    //! Transform of length 2*m_blockSize
+    Fft<DataType> m_fft;
+
+    //! Partition spectra - m_partitionCount * m_binCount
+    std::vector<DataType> m_filterReal;
+    std::vector<DataType> m_filterImag;
+
+    //! Frequency-domain delay line of input spectra - m_partitionCount * m_binCount
+    std::vector<DataType> m_delayLineReal;
+    std::vector<DataType> m_delayLineImag;
+
+    //! Delay line slot holding the newest spectrum
+    size_t m_delayLineIndex;
+
+    //! Time domain input: previous block then current block
+    std::vector<DataType> m_inputBuffer;
+
+    //! Accumulated output spectrum
+    std::vector<DataType> m_accumulatorReal;
+    std::vector<DataType> m_accumulatorImag;
+
+    //! Time domain output of the inverse transform
+    std::vector<DataType> m_outputBuffer;
+
+}; // class FftConvolver
+
+
+//! Constructor
+template <typename DataType>
+FftConvolver<DataType>::FftConvolver(const BasicFilterHolderType<DataType>& filter, size_t blockSize)
+    : m_blockSize(Fft<DataType>::nextPowerOfTwo(blockSize < 1 ? 1 : blockSize)),
+      m_binCount(m_blockSize + 1),
+      m_partitionCount((filter.coefficients.size() + m_blockSize - 1) / m_blockSize),
+      m_fft(2*m_blockSize),
+      m_filterReal(m_partitionCount * m_binCount), m_filterImag(m_partitionCount * m_binCount),
+      m_delayLineReal(m_partitionCount * m_binCount, DataType(0)), 
+      m_delayLineImag(m_partitionCount * m_binCount, DataType(0)),
+      m_delayLineIndex(0), m_inputBuffer(2*m_blockSize, DataType(0)),
+      m_accumulatorReal(m_binCount), m_accumulatorImag(m_binCount),
+      m_outputBuffer(2*m_blockSize)
+{
+    std::vector<DataType> partition(2*m_blockSize);
+    size_t tapCount = filter.coefficients.size();
+
+    for( size_t p = 0; p < m_partitionCount; p++ )
+    {
+        for( size_t n = 0; n < 2*m_blockSize; n++ )
+        {
+            size_t tap = p*m_blockSize + n;
+            partition[n] = (n < m_blockSize && tap < tapCount) 
+                ? (DataType)filter.coefficients[tap] : DataType(0);
+        }
+
+        m_fft.forward(&partition[0], &m_filterReal[p*m_binCount], &m_filterImag[p*m_binCount]);
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+FftConvolver<DataType>::~FftConvolver()
+{
+}
+
+
+//! Reset the filter state (history) to zero
+template <typename DataType>
+void FftConvolver<DataType>::reset()
+{
+    std::fill(m_delayLineReal.begin(), m_delayLineReal.end(), DataType(0));
+    std::fill(m_delayLineImag.begin(), m_delayLineImag.end(), DataType(0));
+    std::fill(m_inputBuffer.begin(), m_inputBuffer.end(), DataType(0));
+    m_delayLineIndex = 0;
+}
+
+
+//! Get the block size
+template <typename DataType>
+size_t FftConvolver<DataType>::blockSize()
+{
+    return m_blockSize;
+}
+
+
+//! Get the number of filter partitions
+template <typename DataType>
+size_t FftConvolver<DataType>::partitionCount()
+{
+    return m_partitionCount;
+}
+
+
+//! Filter whole blocks of samples - returns the number of samples processed
+template <typename DataType>
+size_t FftConvolver<DataType>::processBlock(const DataType * const input, DataType * output, size_t length)
+{
+    size_t processed = 0;
+
+    while( (length - processed) >= m_blockSize )
+    {
+        processOneBlock(input + processed, output + processed);
+        processed += m_blockSize;
+    }
+
+    return processed;
+}
+
+
+//! Process exactly one block
+template <typename DataType>
+void FftConvolver<DataType>::processOneBlock(const DataType * const input, DataType * output)
+{
+    // An empty design has no partitions to accumulate
+    if( m_partitionCount == 0 )
+    {
+        std::fill(output, output + m_blockSize, DataType(0));
+        return;
+    }
+
+    // Slide the input window along by one block
+    memcpy(&m_inputBuffer[0], &m_inputBuffer[m_blockSize], m_blockSize*sizeof(DataType));
+    memcpy(&m_inputBuffer[m_blockSize], input, m_blockSize*sizeof(DataType));
+
+    // Newest spectrum into the delay line
+    m_delayLineIndex = (m_delayLineIndex == 0) ? (m_partitionCount - 1) : (m_delayLineIndex - 1);
+    m_fft.forward(&m_inputBuffer[0], 
+                  &m_delayLineReal[m_delayLineIndex*m_binCount], 
+                  &m_delayLineImag[m_delayLineIndex*m_binCount]);
+
+    // Accumulate X[k-p] * H[p]
+    DataType * accReal = &m_accumulatorReal[0];
+    DataType * accImag = &m_accumulatorImag[0];
+    std::fill(m_accumulatorReal.begin(), m_accumulatorReal.end(), DataType(0));
+    std::fill(m_accumulatorImag.begin(), m_accumulatorImag.end(), DataType(0));
+
+    size_t slot = m_delayLineIndex;
+    for( size_t p = 0; p < m_partitionCount; p++ )
+    {
+        const DataType * xr = &m_delayLineReal[slot*m_binCount];
+        const DataType * xi = &m_delayLineImag[slot*m_binCount];
+        const DataType * hr = &m_filterReal[p*m_binCount];
+        const DataType * hi = &m_filterImag[p*m_binCount];
+
+        for( size_t k = 0; k < m_binCount; k++ )
+        {
+            accReal[k] += xr[k] * hr[k] - xi[k] * hi[k];
+            accImag[k] += xr[k] * hi[k] + xi[k] * hr[k];
+        }
+
+        slot++;
+        if( slot == m_partitionCount )
+        {
+            // Wrap around
+            slot = 0;
+        }
+    }
+
+    // Back to the time domain, keeping the valid (second) half
+    m_fft.inverse(accReal, accImag, &m_outputBuffer[0]);
+    memcpy(output, &m_outputBuffer[m_blockSize], m_blockSize*sizeof(DataType));
+}
+
+
+#endif // FFTCONVOLVER_H
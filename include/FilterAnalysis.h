@@ -0,0 +1,331 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FilterAnalysis.h
+//
+//------------------------------------------------------------------------------
+//
+// Frequency response of a designed filter on a dense grid, for validating
+// designs before they are used.
+//
+// H(f) is evaluated at every bin at once with a zero-padded FFT, so a grid of
+// F points costs O(F log F) rather than the O(N.F) of evaluating the sum at
+// each frequency. The transform is sized to the larger of the requested grid
+// and the filter, and is kept between calls so a catalogue of designs can be
+// analysed without re-planning or allocating for each one. It only grows, so
+// after a long filter the grid is finer for the rest of the catalogue too.
+//
+// Group delay uses the derivative property of the transform:
+//   tau(w) = Re{ FFT(n.h[n]) / FFT(h[n]) }
+// which needs a second FFT rather than unwrapping and differentiating the
+// phase. At zeros of H (deep in the stopband) it is undefined, and the value
+// from the previous bin is held.
+//
+// The analysis is done in double whatever the precision of the design.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FILTERANALYSIS_H
+#define FILTERANALYSIS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Fft.h"
+#include "FilterFactory.h"
+
+//! Default number of grid points from DC to Nyquist
+#define FILTERANALYSIS_DEFAULT_POINTS 4097
+
+//! Magnitude below which group delay is held, relative to the peak
+#define FILTERANALYSIS_GROUP_DELAY_FLOOR 1e-6
+
+
+//! Frequency Response struct - DC to Fs/2 on an even grid
+template <typename DataType>
+struct FrequencyResponseType
+{
+    std::vector<DataType> frequency;  //!< In the units of Fs
+    std::vector<DataType> magnitude;  //!< Linear gain |H(f)|
+    std::vector<DataType> phase;      //!< arg H(f) in radians, wrapped to [-pi, pi]
+    std::vector<DataType> groupDelay; //!< In samples
+};
+
+
+template <typename DataType>
+class FilterAnalysis
+{
+public:
+
+    //! Constructor
+    //! pointCount = the minimum number of grid points from DC to Nyquist. 
+    //! Rounded up to suit the FFT, and raised for filters longer than the grid.
+    FilterAnalysis(size_t pointCount = FILTERANALYSIS_DEFAULT_POINTS);
+
+    //! Destructor
+    virtual ~FilterAnalysis();
+
+    //! Get the FFT size - the largest planned so far, which every analysis 
+    //! uses, as the plan grows for longer filters but is never shrunk
+    size_t fftSize();
+
+    //! Frequency Response - magnitude, phase and group delay of a filter with
+    //! sample rate Fs. The response vectors are resized as needed.
+    void frequencyResponse(const BasicFilterHolderType<DataType>& filter, DataType Fs, 
+                           FrequencyResponseType<DataType>& response);
+
+    //! Magnitude Response only - one FFT instead of two
+    void magnitudeResponse(const BasicFilterHolderType<DataType>& filter, 
+                           std::vector<DataType>& magnitude);
+
+    //! Measure Response - passband ripple and stopband attenuation of a filter
+    //! against a specification
+    BasicFilterResponseType<DataType> measureResponse(
+        const BasicFilterHolderType<DataType>& filter,
+        const BasicFilterSpecificationType<DataType>& specification);
+
+    //! Measure Responses - measureResponse for count filters and 
+    //! specifications, reusing the same transform
+    void measureResponses(const BasicFilterHolderType<DataType> * filters, 
+        const BasicFilterSpecificationType<DataType> * specifications, 
+        size_t count, BasicFilterResponseType<DataType> * responses);
+
+protected:
+
+private:
+    //! Not copyable
+    FilterAnalysis(const FilterAnalysis&);
+    FilterAnalysis& operator=(const FilterAnalysis&);
+
+    //! Make sure the FFT is long enough for the grid and the filter
+    void plan(size_t tapCount);
+
+    //! Transform the filter into m_real/m_imag, and n.h[n] into 
+    //! m_rampReal/m_rampImag if withRamp
+    void transform(const BasicFilterHolderType<DataType>& filter, bool withRamp);
+
+    //! Minimum grid points from DC to Nyquist
+    size_t m_pointCount;
+
+    //! Transform - replaced when a longer one is needed
+    Fft<double> * m_fft;
+
+    //! Zero-padded input
+    std::vector<double> m_input;
+
+    //! Spectrum of h[n]
+    std::vector<double> m_real;
+    std::vector<double> m_imag;
+
+    //! Spectrum of n.h[n]
+    std::vector<double> m_rampReal;
+    std::vector<double> m_rampImag;
+
+}; // class FilterAnalysis
+
+
+//! Constructor
+template <typename DataType>
+FilterAnalysis<DataType>::FilterAnalysis(size_t pointCount)
+    : m_pointCount(pointCount < 2 ? 2 : pointCount), m_fft(NULL)
+{
+    plan(0);
+}
+
+
+//! Destructor
+template <typename DataType>
+FilterAnalysis<DataType>::~FilterAnalysis()
+{
+    delete m_fft;
+}
+
+
+//! Get the FFT size - the largest planned so far
+template <typename DataType>
+size_t FilterAnalysis<DataType>::fftSize()
+{
+    return m_fft->size();
+}
+
+
+//! Frequency Response - magnitude, phase and group delay
+template <typename DataType>
+void FilterAnalysis<DataType>::frequencyResponse(const BasicFilterHolderType<DataType>& filter, 
+    DataType Fs, FrequencyResponseType<DataType>& response)
+{
+    transform(filter, true);
+
+    size_t bins = m_fft->spectrumSize();
+    response.frequency.resize(bins);
+    response.magnitude.resize(bins);
+    response.phase.resize(bins);
+    response.groupDelay.resize(bins);
+
+    double peak = 0.0;
+    for( size_t k = 0; k < bins; k++ )
+    {
+        double magnitudeSquared = m_real[k] * m_real[k] + m_imag[k] * m_imag[k];
+        peak = (magnitudeSquared > peak) ? magnitudeSquared : peak;
+    }
+
+    double floor = peak * FILTERANALYSIS_GROUP_DELAY_FLOOR * FILTERANALYSIS_GROUP_DELAY_FLOOR;
+    double delay = 0.5 * (double)filter.order;
+
+    for( size_t k = 0; k < bins; k++ )
+    {
+        double re = m_real[k];
+        double im = m_imag[k];
+        double magnitudeSquared = re * re + im * im;
+
+        response.frequency[k] = (DataType)(0.5 * (double)Fs * (double)k / (double)(bins - 1));
+        response.magnitude[k] = (DataType)sqrt(magnitudeSquared);
+        response.phase[k] = (DataType)atan2(im, re);
+
+        // tau = Re{ R / H } = Re{ R conj(H) } / |H|^2
+        if( magnitudeSquared > floor )
+        {
+            delay = (m_rampReal[k] * re + m_rampImag[k] * im) / magnitudeSquared;
+        }
+        response.groupDelay[k] = (DataType)delay;
+    }
+}
+
+
+//! Magnitude Response only
+template <typename DataType>
+void FilterAnalysis<DataType>::magnitudeResponse(const BasicFilterHolderType<DataType>& filter, 
+    std::vector<DataType>& magnitude)
+{
+    transform(filter, false);
+
+    size_t bins = m_fft->spectrumSize();
+    magnitude.resize(bins);
+
+    for( size_t k = 0; k < bins; k++ )
+    {
+        magnitude[k] = (DataType)sqrt( m_real[k] * m_real[k] + m_imag[k] * m_imag[k] );
+    }
+}
+
+
+//! Measure Response - passband ripple and stopband attenuation
+template <typename DataType>
+BasicFilterResponseType<DataType> FilterAnalysis<DataType>::measureResponse(
+    const BasicFilterHolderType<DataType>& filter,
+    const BasicFilterSpecificationType<DataType>& specification)
+{
+    transform(filter, false);
+
+    // Magnitude in place of the real part
+    size_t bins = m_fft->spectrumSize();
+    for( size_t k = 0; k < bins; k++ )
+    {
+        m_real[k] = sqrt( m_real[k] * m_real[k] + m_imag[k] * m_imag[k] );
+    }
+
+    return BasicFilterFactory<DataType>::measureMagnitude(&m_real[0], bins, 
+                                                          filter.order, specification);
+}
+
+
+//! Measure Responses - measureResponse for count filters and specifications
+template <typename DataType>
+void FilterAnalysis<DataType>::measureResponses(const BasicFilterHolderType<DataType> * filters, 
+    const BasicFilterSpecificationType<DataType> * specifications, 
+    size_t count, BasicFilterResponseType<DataType> * responses)
+{
+    // Plan for the longest filter up front so the transform is made once
+    size_t longest = 0;
+    for( size_t i = 0; i < count; i++ )
+    {
+        longest = (filters[i].coefficients.size() > longest) 
+            ? filters[i].coefficients.size() : longest;
+    }
+    plan(longest);
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        responses[i] = measureResponse(filters[i], specifications[i]);
+    }
+}
+
+
+//! Make sure the FFT is long enough for the grid and the filter
+template <typename DataType>
+void FilterAnalysis<DataType>::plan(size_t tapCount)
+{
+    // pointCount bins from DC to Nyquist needs an FFT of 2*(pointCount-1)
+    size_t size = 2 * (m_pointCount - 1);
+    if( size < tapCount )
+    {
+        size = tapCount;
+    }
+    size = Fft<double>::nextPowerOfTwo(size);
+
+    if( (m_fft != NULL) && (m_fft->size() >= size) )
+    {
+        return;
+    }
+
+    delete m_fft;
+    m_fft = new Fft<double>(size);
+
+    m_input.resize(size);
+    m_real.resize(m_fft->spectrumSize());
+    m_imag.resize(m_fft->spectrumSize());
+    m_rampReal.resize(m_fft->spectrumSize());
+    m_rampImag.resize(m_fft->spectrumSize());
+}
+
+
+//! Transform the filter, and n.h[n] if withRamp
+template <typename DataType>
+void FilterAnalysis<DataType>::transform(const BasicFilterHolderType<DataType>& filter, 
+    bool withRamp)
+{
+    size_t tapCount = filter.coefficients.size();
+    plan(tapCount);
+
+    std::fill(m_input.begin(), m_input.end(), 0.0);
+    for( size_t n = 0; n < tapCount; n++ )
+    {
+        m_input[n] = (double)filter.coefficients[n];
+    }
+    m_fft->forward(&m_input[0], &m_real[0], &m_imag[0]);
+
+    if( withRamp )
+    {
+        for( size_t n = 0; n < tapCount; n++ )
+        {
+            m_input[n] = (double)n * (double)filter.coefficients[n];
+        }
+        m_fft->forward(&m_input[0], &m_rampReal[0], &m_rampImag[0]);
+    }
+}
+
+
+#endif // FILTERANALYSIS_H
@@ -0,0 +1,347 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FilterDesignCache.h
+//
+//------------------------------------------------------------------------------
+//
+// Thread-safe memoizing cache in front of FilterFactory::createFilterWeights.
+//
+// Designs are keyed on (order, window, filter type, Fs, Fc1, Fc2, and the
+// beta for KAISER windows) and returned
+// as shared immutable coefficient buffers, so many streams opening with the 
+// same design share one buffer and only the first pays for the design.
+//
+// The cache holds at most capacity() designs and evicts the least recently 
+// used. A design being calculated is held as a shared_future, so threads that
+// ask for it at the same time wait for the one calculation rather than each 
+// doing their own. The design itself is done outside the lock. If it throws,
+// the waiting threads get the same exception and nothing is cached.
+//
+// Requires C++11.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FILTERDESIGNCACHE_H
+#define FILTERDESIGNCACHE_H
+
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FilterFactory.h"
+
+//! Filter Design Key struct
+struct FilterDesignKey
+{
+    int order;
+    FilterWindowType::Type windowType;
+    FilterType::Type filterType;
+    Float Fs;
+    Float Fc1;
+    Float Fc2;
+    Float kaiserBeta; //!< 0 unless windowType is KAISER
+
+    //! Ordering for use as a map key
+    bool operator<(const FilterDesignKey& other) const;
+};
+
+
+//! Filter Design Cache Statistics struct
+struct FilterDesignCacheStatistics
+{
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t size;
+};
+
+
+//! Filter Design Cache class
+class FilterDesignCache
+{
+public:
+    //! Shared immutable coefficients
+    typedef std::shared_ptr<const std::vector<Float> > CoefficientsPointer;
+
+    //! Constructor
+    //! capacity = the maximum number of designs held
+    FilterDesignCache(size_t capacity = 256);
+
+    //! Destructor
+    virtual ~FilterDesignCache();
+
+    //! Get Filter Weights - from the cache, or designed and cached
+    CoefficientsPointer getFilterWeights(int order, 
+        FilterWindowType::Type windowType, FilterType::Type filterType, 
+        Float Fs = 0, Float Fc1 = 0, Float Fc2 = 0, 
+        Float kaiserBeta = FILTERFACTORY_KAISER_BETA);
+
+    //! Create Filter - a FilterHolderType with a copy of the cached weights
+    FilterHolderType createFilter(int order, 
+        FilterWindowType::Type windowType, FilterType::Type filterType, 
+        Float Fs = 0, Float Fc1 = 0, Float Fc2 = 0, 
+        Float kaiserBeta = FILTERFACTORY_KAISER_BETA);
+
+    //! Get the hit/miss statistics
+    FilterDesignCacheStatistics statistics();
+
+    //! Get the maximum number of designs held
+    size_t capacity();
+
+    //! Set the maximum number of designs held - evicts if needed
+    void setCapacity(size_t capacity);
+
+    //! Remove all designs and reset the statistics
+    void clear();
+
+protected:
+
+private:
+    //! Not copyable
+    FilterDesignCache(const FilterDesignCache&);
+    FilterDesignCache& operator=(const FilterDesignCache&);
+
+    //! A cached (or in progress) design and its place in the LRU list
+    struct Entry
+    {
+        std::shared_future<CoefficientsPointer> coefficients;
+        std::list<FilterDesignKey>::iterator lruPosition;
+        size_t designId;
+    };
+
+    //! Evict least recently used designs down to capacity - lock must be held
+    void evict();
+
+    //! Maximum number of designs held
+    size_t m_capacity;
+
+    //! Designs by key
+    std::map<FilterDesignKey, Entry> m_entries;
+
+    //! Keys, most recently used at the front
+    std::list<FilterDesignKey> m_lru;
+
+    //! Id for the next design, to tell it from a later one with the same key
+    size_t m_nextDesignId;
+
+    //! Statistics
+    FilterDesignCacheStatistics m_statistics;
+
+    //! Guards everything above
+    std::mutex m_mutex;
+
+}; // class FilterDesignCache
+
+
+//! Ordering for use as a map key
+inline bool FilterDesignKey::operator<(const FilterDesignKey& other) const
+{
+    if( order != other.order ) return order < other.order;
+    if( windowType != other.windowType ) return windowType < other.windowType;
+    if( filterType != other.filterType ) return filterType < other.filterType;
+    if( Fs != other.Fs ) return Fs < other.Fs;
+    if( Fc1 != other.Fc1 ) return Fc1 < other.Fc1;
+    if( Fc2 != other.Fc2 ) return Fc2 < other.Fc2;
+    return kaiserBeta < other.kaiserBeta;
+}
+
+
+//! Constructor
+inline FilterDesignCache::FilterDesignCache(size_t capacity)
+    : m_capacity(capacity < 1 ? 1 : capacity), m_nextDesignId(0)
+{
+    m_statistics.hits = 0;
+    m_statistics.misses = 0;
+    m_statistics.evictions = 0;
+    m_statistics.size = 0;
+}
+
+
+//! Destructor
+inline FilterDesignCache::~FilterDesignCache()
+{
+}
+
+
+//! Get Filter Weights - from the cache, or designed and cached
+inline FilterDesignCache::CoefficientsPointer FilterDesignCache::getFilterWeights(int order, 
+    FilterWindowType::Type windowType, FilterType::Type filterType, 
+    Float Fs /* = 0 */, Float Fc1 /* = 0 */, Float Fc2 /* = 0 */, 
+    Float kaiserBeta /* = FILTERFACTORY_KAISER_BETA */)
+{
+    FilterDesignKey key;
+    key.order = order;
+    key.windowType = windowType;
+    key.filterType = filterType;
+    key.Fs = Fs;
+    key.Fc1 = Fc1;
+    key.Fc2 = Fc2;
+    key.kaiserBeta = (windowType == FilterWindowType::KAISER) ? kaiserBeta : 0;
+
+    std::promise<CoefficientsPointer> promise;
+    std::shared_future<CoefficientsPointer> future;
+    bool designHere = false;
+    size_t designId = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<FilterDesignKey, Entry>::iterator found = m_entries.find(key);
+        if( found != m_entries.end() )
+        {
+            // Hit - move to the front
+            m_statistics.hits++;
+            m_lru.splice(m_lru.begin(), m_lru, found->second.lruPosition);
+            future = found->second.coefficients;
+        }
+        else
+        {
+            // Miss - publish the future so other threads wait for this design
+            m_statistics.misses++;
+            m_lru.push_front(key);
+
+            Entry entry;
+            entry.coefficients = promise.get_future().share();
+            entry.lruPosition = m_lru.begin();
+            entry.designId = designId = m_nextDesignId++;
+            m_entries[key] = entry;
+
+            evict();
+            designHere = true;
+        }
+    }
+
+    if( designHere )
+    {
+        // Design outside the lock
+        CoefficientsPointer coefficients;
+        try
+        {
+            FilterFactory filterFactory;
+            filterFactory.setKaiserBeta(kaiserBeta);
+            coefficients.reset(new std::vector<Float>(
+                filterFactory.createFilterWeights(order, windowType, filterType, Fs, Fc1, Fc2)));
+        }
+        catch( ... )
+        {
+            // Waiting threads get the same exception, and the failed design 
+            // is dropped so the next lookup tries again
+            promise.set_exception(std::current_exception());
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::map<FilterDesignKey, Entry>::iterator found = m_entries.find(key);
+            if( (found != m_entries.end()) && (found->second.designId == designId) )
+            {
+                m_lru.erase(found->second.lruPosition);
+                m_entries.erase(found);
+                m_statistics.size = m_entries.size();
+            }
+            throw;
+        }
+
+        promise.set_value(coefficients);
+        return coefficients;
+    }
+
+    return future.get();
+}
+
+
+//! Create Filter - a FilterHolderType with a copy of the cached weights
+inline FilterHolderType FilterDesignCache::createFilter(int order, 
+    FilterWindowType::Type windowType, FilterType::Type filterType, 
+    Float Fs /* = 0 */, Float Fc1 /* = 0 */, Float Fc2 /* = 0 */, 
+    Float kaiserBeta /* = FILTERFACTORY_KAISER_BETA */)
+{
+    FilterHolderType filterHolder;
+
+    filterHolder.order = order;
+    filterHolder.coefficients = *getFilterWeights(order, windowType, filterType, 
+                                                  Fs, Fc1, Fc2, kaiserBeta);
+
+    return filterHolder;
+}
+
+
+//! Get the hit/miss statistics
+inline FilterDesignCacheStatistics FilterDesignCache::statistics()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+
+//! Get the maximum number of designs held
+inline size_t FilterDesignCache::capacity()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+
+//! Set the maximum number of designs held - evicts if needed
+inline void FilterDesignCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = (capacity < 1) ? 1 : capacity;
+    evict();
+}
+
+
+//! Remove all designs and reset the statistics
+inline void FilterDesignCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_statistics.hits = 0;
+    m_statistics.misses = 0;
+    m_statistics.evictions = 0;
+    m_statistics.size = 0;
+}
+
+
+//! Evict least recently used designs down to capacity - lock must be held
+inline void FilterDesignCache::evict()
+{
+    // Evicted designs stay alive for anyone already holding the pointer or
+    // waiting on the future
+    while( m_entries.size() > m_capacity )
+    {
+        m_entries.erase(m_lru.back());
+        m_lru.pop_back();
+        m_statistics.evictions++;
+    }
+
+    m_statistics.size = m_entries.size();
+}
+
+
+#endif // FILTERDESIGNCACHE_H
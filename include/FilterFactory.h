@@ -37,17 +37,62 @@
 // https://en.wikipedia.org/wiki/Window_function#Hamming_window
 // 
 //------------------------------------------------------------------------------
+//
+// The cos() and sin() sequences for the windows, sinc weights and 
+// normalisation all have evenly spaced arguments, so they are generated with a
+// rotating phasor (one complex multiply per tap) instead of a trig call per 
+// tap. The phasor runs in double and is re-seeded with a direct evaluation 
+// every FILTERFACTORY_PHASOR_RESYNC taps, which keeps it within 1e-12 of 
+// cos()/sin() up to order 8192 and beyond. The weights match the direct 
+// evaluation to within the float rounding: the largest difference seen for
+// float, over all window and filter types up to order 8192, was 2e-7 of the
+// largest coefficient.
+//
+// The KAISER window takes a shape parameter beta (setKaiserBeta()), trading
+// main lobe width against sidelobe level. createKaiserFilter() goes the other
+// way: given a ripple, attenuation and transition width it estimates order 
+// and beta with Kaiser's formulas, measures the response actually achieved,
+// and steps the order (in twos, keeping a centre tap) until it has the 
+// smallest order that meets the specification.
+// 
+// Kaiser, J. F. "Nonrecursive Digital Filter Design Using the I0-sinh Window
+// Function", Proc. IEEE Int. Symp. Circuits and Systems, 1974.
+//
+// HALFBAND is a LOWPASS with its cut fixed at Fs/4 (Fc1 is ignored). Every
+// other tap either side of the centre is then exactly zero, and is set to 
+// zero rather than left at the rounding error of the sinc, so that the 
+// HalfbandDecimator can skip them. Use an order of 4k+2 so the end taps are
+// not among the zeros; createKaiserFilter() steps HALFBAND orders in fours.
+//
+// quantiseFilter() converts a design to Q15 or Q31 fixed point for the 
+// integer FixedPointFirFilter, and reports the headroom the coefficients 
+// need: sum|h| is the largest gain any input can see, so with int16 input 
+// the output can grow by up to ceil(log2(sum|h|)) bits. Optionally the 
+// coefficients are scaled down (and truncated towards zero) so that 
+// sum|h| <= 1 and the output can never saturate.
+//
+// The factory and the holder structs are templates on the precision of the
+// design: FilterFactory and FilterHolderType are float, DoubleFilterFactory
+// and DoubleFilterHolderType are double, so long narrow-band designs can be 
+// done in double alongside float designs for the fast paths. A holder 
+// converts to the other precision when passed to a filter of that type.
+// 
+//------------------------------------------------------------------------------
  
 #ifndef FILTERFACTORY_H
 #define FILTERFACTORY_H
  
 // Includes
-#define Float float
+//! Default precision for code that is not templated on it
+typedef float Float;
  
 #include <vector>
 #include <cmath>
+#include <stdint.h>
 #include <vector>
 //#include 
+
+#include "Fft.h"
  
  
 //! Window Type enum container
@@ -59,7 +104,8 @@ struct FilterWindowType
         BARTLETT,
         HANNING,
         HAMMING,
-        BLACKMAN
+        BLACKMAN,
+        KAISER
     } Type;
 };
  
@@ -72,64 +118,265 @@ struct FilterType
         HIGHPASS,
         BANDPASS,
         BANDSTOP,
-        ALLPASS
+        ALLPASS,
+        HALFBAND
     } Type;
 };
  
+//! Taps between direct re-seeds of the Phasor
+#define FILTERFACTORY_PHASOR_RESYNC 1024
+
+//! Default Kaiser window beta - roughly 54dB of stopband attenuation
+#define FILTERFACTORY_KAISER_BETA 5.0
+
+//! Points per tap on the grid used to measure an achieved response
+#define FILTERFACTORY_RESPONSE_GRID 8
+
+
+//! Rotating Phasor - cos/sin of (start + n*step) by complex rotation
+class Phasor
+{
+public:
+    //! Constructor
+    Phasor(double start, double step);
+
+    //! cos(start + n*step)
+    double cosine() const { return m_cos; }
+
+    //! sin(start + n*step)
+    double sine() const { return m_sin; }
+
+    //! Advance n by one
+    void next();
+
+private:
+    double m_start;
+    double m_step;
+    double m_stepCos;
+    double m_stepSin;
+    double m_cos;
+    double m_sin;
+    long m_n;
+};
+
+
 //! Filter Properites Holder struct
-struct FilterHolderType
+template <typename T>
+struct BasicFilterHolderType
 {
+    //! Constructor
+    BasicFilterHolderType() : order(0) {}
+
+    //! Converting Constructor - from a design of another precision
+    template <typename U>
+    BasicFilterHolderType(const BasicFilterHolderType<U>& other)
+        : order(other.order), 
+          coefficients(other.coefficients.begin(), other.coefficients.end()) {}
+
     int order;
-    std::vector<Float> coefficients;
+    std::vector<T> coefficients;
+};
+
+//! Single precision filter
+typedef BasicFilterHolderType<float> FilterHolderType;
+
+//! Double precision filter
+typedef BasicFilterHolderType<double> DoubleFilterHolderType;
+
+
+//! Filter Specification struct - for minimum order designs
+template <typename T>
+struct BasicFilterSpecificationType
+{
+    FilterType::Type filterType;
+    T Fs;
+    T Fc1;
+    T Fc2;
+    T passbandRippleDb;      //!< Peak to peak ripple allowed in the passband
+    T stopbandAttenuationDb; //!< Minimum attenuation in the stopband
+    T transitionWidth;       //!< Width of each transition band, centred on
+                             //!< the cutoff, in the units of Fs
+};
+
+//! Single precision specification
+typedef BasicFilterSpecificationType<float> FilterSpecificationType;
+
+//! Double precision specification
+typedef BasicFilterSpecificationType<double> DoubleFilterSpecificationType;
+
+
+//! Filter Response struct - the response achieved by a design
+template <typename T>
+struct BasicFilterResponseType
+{
+    int order;
+    T kaiserBeta;
+    T passbandRippleDb;      //!< Measured peak to peak passband ripple
+    T stopbandAttenuationDb; //!< Measured minimum stopband attenuation
+    bool meetsSpecification;
+};
+
+//! Single precision response
+typedef BasicFilterResponseType<float> FilterResponseType;
+
+//! Double precision response
+typedef BasicFilterResponseType<double> DoubleFilterResponseType;
+
+
+//! Quantised Filter Holder struct - fixed point coefficients
+struct QuantisedFilterHolderType
+{
+    int order;
+    int fractionalBits;          //!< 15 for Q15, 31 for Q31
+    std::vector<int32_t> coefficients;
+    double scale;                //!< Gain applied before quantising
+    double absoluteSum;          //!< sum|h| of the quantised coefficients
+    int headroomBits;            //!< Bits the output can grow above full scale
+    double maxError;             //!< Largest coefficient error from quantising
 };
  
  
-//! Filter Factory class
-class FilterFactory
+//! Filter Factory class - T is the precision of the design and coefficients
+template <typename T>
+class BasicFilterFactory
 {
 public:
     //! Constructor
-    FilterFactory();
+    BasicFilterFactory();
 
     //! Destructor
-    virtual ~FilterFactory() {}
+    virtual ~BasicFilterFactory() {}
 
     //! Create Filter
-    FilterHolderType createFilter(int order, 
+    BasicFilterHolderType<T> createFilter(int order, 
         FilterWindowType::Type windowType, FilterType::Type filterType, 
-        Float Fs = 0, Float Fc1 = 0, Float Fc2 = 0);
+        T Fs = 0, T Fc1 = 0, T Fc2 = 0);
 
     //! Create Window Weights
-    std::vector<Float> createWindowWeights(int order, 
+    std::vector<T> createWindowWeights(int order, 
         FilterWindowType::Type windowType);
 
     //! Create Sinc Weights
-    std::vector<Float> createSincWeights(int order, 
+    std::vector<T> createSincWeights(int order, 
         FilterType::Type filterType, 
-        Float Fs = 0, Float Fc1 = 0, Float Fc2 = 0);
+        T Fs = 0, T Fc1 = 0, T Fc2 = 0);
 
     //! Create Filter Weights - Combines Sinc and Window Weights
-    std::vector<Float> createFilterWeights(int order, 
+    std::vector<T> createFilterWeights(int order, 
         FilterWindowType::Type windowType, FilterType::Type filterType, 
-        Float Fs = 0, Float Fc1 = 0, Float Fc2 = 0);
+        T Fs = 0, T Fc1 = 0, T Fc2 = 0);
+
+    //! Is Symmetric - True if h[n] == h[order-n] to within a tolerance 
+    //! relative to the largest coefficient (i.e. the filter is linear phase)
+    static bool isSymmetric(const BasicFilterHolderType<T>& filter, 
+        T relativeTolerance = 1e-5);
+
+    //! Set Kaiser Beta - the shape of the KAISER window
+    void setKaiserBeta(T beta) { m_kaiserBeta = beta; }
+
+    //! Get Kaiser Beta
+    T kaiserBeta() const { return m_kaiserBeta; }
+
+    //! Create Kaiser Filter - the minimum order KAISER windowed filter that 
+    //! meets the specification. The achieved response is written to response
+    //! if given. If no order up to maxOrder meets it, returns the maxOrder 
+    //! design with response->meetsSpecification false.
+    BasicFilterHolderType<T> createKaiserFilter(
+        const BasicFilterSpecificationType<T>& specification, 
+        BasicFilterResponseType<T>* response = NULL, int maxOrder = 65536);
+
+    //! Estimate Kaiser Order - Kaiser's formula, rounded up to even
+    static int estimateKaiserOrder(
+        const BasicFilterSpecificationType<T>& specification);
+
+    //! Estimate Kaiser Beta - Kaiser's formula
+    static T estimateKaiserBeta(
+        const BasicFilterSpecificationType<T>& specification);
+
+    //! Measure Response - ripple and attenuation of a filter over the bands of
+    //! a specification, on a grid of FILTERFACTORY_RESPONSE_GRID points per tap
+    static BasicFilterResponseType<T> measureResponse(
+        const BasicFilterHolderType<T>& filter, 
+        const BasicFilterSpecificationType<T>& specification);
+
+    //! Measure Magnitude - ripple and attenuation over the bands of a 
+    //! specification from a magnitude response on an even grid from DC 
+    //! (magnitude[0]) to Fs/2 (magnitude[pointCount-1])
+    static BasicFilterResponseType<T> measureMagnitude(const double * magnitude, 
+        size_t pointCount, int order, 
+        const BasicFilterSpecificationType<T>& specification);
+
+    //! Modified Bessel function of the first kind, order zero
+    static double besselI0(double x);
+
+    //! Quantise Filter - to fixed point with fractionalBits (15 or 31).
+    //! scaleForHeadroom = scale down so that sum|h| <= 1 if it is not already
+    static QuantisedFilterHolderType quantiseFilter(
+        const BasicFilterHolderType<T>& filter, 
+        int fractionalBits = 15, bool scaleForHeadroom = false);
 
 protected:
 
 private:
+    //! Required attenuation in dB - the tighter of the ripple and stopband
+    static double requiredAttenuationDb(
+        const BasicFilterSpecificationType<T>& specification);
+
+    //! Kaiser window beta
+    T m_kaiserBeta;
  
-};
+}; // class BasicFilterFactory
+
+
+//! Single precision Filter Factory
+typedef BasicFilterFactory<float> FilterFactory;
+
+//! Double precision Filter Factory
+typedef BasicFilterFactory<double> DoubleFilterFactory;
+
+
+//! Phasor Constructor
+inline Phasor::Phasor(double start, double step)
+    : m_start(start), m_step(step), m_stepCos(cos(step)), m_stepSin(sin(step)),
+      m_cos(cos(start)), m_sin(sin(start)), m_n(0)
+{
+}
+
+
+//! Advance n by one
+inline void Phasor::next()
+{
+    m_n++;
+
+    if( (m_n % FILTERFACTORY_PHASOR_RESYNC) == 0 )
+    {
+        // Re-seed to stop rounding errors building up
+        double angle = m_start + (double)m_n * m_step;
+        m_cos = cos(angle);
+        m_sin = sin(angle);
+        return;
+    }
+
+    double nextCos = m_cos * m_stepCos - m_sin * m_stepSin;
+    m_sin = m_sin * m_stepCos + m_cos * m_stepSin;
+    m_cos = nextCos;
+}
+
 
 //! Constructor
-FilterFactory::FilterFactory() 
+template <typename T>
+BasicFilterFactory<T>::BasicFilterFactory() 
+    : m_kaiserBeta(FILTERFACTORY_KAISER_BETA)
 {
 }
  
 //! Create Filter
-FilterHolderType FilterFactory::createFilter(int order, 
+template <typename T>
+BasicFilterHolderType<T> BasicFilterFactory<T>::createFilter(int order, 
     FilterWindowType::Type windowType, FilterType::Type filterType, 
-    Float Fs /* = 0 */, Float Fc1 /* = 0 */, Float Fc2 /* = 0 */)
+    T Fs /* = 0 */, T Fc1 /* = 0 */, T Fc2 /* = 0 */)
 {
-    FilterHolderType filterHolder;
+    BasicFilterHolderType<T> filterHolder;
 
     filterHolder.order = order;
     filterHolder.coefficients = createFilterWeights(order, windowType, 
@@ -140,7 +387,8 @@ FilterHolderType FilterFactory::createFilter(int order,
  
  
 //! Create Window Weights
-std::vector<Float> FilterFactory::createWindowWeights(int order, 
+template <typename T>
+std::vector<T> BasicFilterFactory<T>::createWindowWeights(int order, 
     FilterWindowType::Type windowType)
 {
     // Equations from http://www.labbookpages.co.uk/audio/firWindowing.html
@@ -150,7 +398,7 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         case FilterWindowType::RECTANGULAR:
         {
             // w(n) = 1
-            std::vector<Float> window(order+1, 1.0);
+            std::vector<T> window(order+1, 1.0);
             return window;
             break;
         }
@@ -158,12 +406,12 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         case FilterWindowType::BARTLETT:
         {
             // w(n) = 1 - 2|n-M/2|/M
-            std::vector<Float> window(order+1);
+            std::vector<T> window(order+1);
 
             for( int n = 0; n < (order+1); n++ )
             {
             window[n] = 1.0 
-            - (2.0 * fabs( (Float)(n - (order/2)) ) / (Float)order);
+            - (2.0 * fabs( (T)(n - (order/2)) ) / (T)order);
             }
 
             return window;
@@ -173,12 +421,13 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         case FilterWindowType::HANNING:
         {
             // w(n) = 0.5 - 0.5cos(2*PI*n/M)
-            std::vector<Float> window(order+1);
+            std::vector<T> window(order+1);
+            Phasor phasor(0.0, 2.0 * M_PI / (double)order);
 
             for( int n = 0; n < (order+1); n++ )
             {
-                window[n] = 0.5 
-                    - 0.5 * cos( 2.0 * M_PI * ((Float)n / (Float)order) );
+                window[n] = 0.5 - 0.5 * phasor.cosine();
+                phasor.next();
             }
 
             return window;
@@ -188,21 +437,22 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         case FilterWindowType::HAMMING:
         {
             // w(n) = 0.54 - 0.46cos(2*PI*n/M)
-            std::vector<Float> window(order+1);
+            std::vector<T> window(order+1);
+            Phasor phasor(0.0, 2.0 * M_PI / (double)order);
 
             for( int n = 0; n < (order+1); n++ )
             {
                 // Approximation lowers levels of sidelobes - as used in matlab
-                window[n] = 0.54 
-                    - 0.46 * cos( 2.0 * M_PI * ((Float)n / (Float)order) ); 
+                window[n] = 0.54 - 0.46 * phasor.cosine(); 
+                phasor.next();
 
                 // Actual value?
                 //window[n] = (25.0/46.0) 
-                //- (21.0/46.0) * cos( 2.0 * M_PI * ((Float)n / (Float)order) ); 
+                //- (21.0/46.0) * cos( 2.0 * M_PI * ((T)n / (T)order) ); 
 
                 // Approximation to create equirriple?
                 //window[n] = 0.53836 
-                //- 0.46164 * cos( 2.0 * M_PI * ((Float)n / (Float)order) );
+                //- 0.46164 * cos( 2.0 * M_PI * ((T)n / (T)order) );
             }
 
             return window;
@@ -212,13 +462,32 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         case FilterWindowType::BLACKMAN:
         {
             // w(n) = 0.42 - 0.5cos(2*PI*n/M) + 0.08cos(4*PI*n/M)
-            std::vector<Float> window(order+1);
+            std::vector<T> window(order+1);
+            Phasor phasor(0.0, 2.0 * M_PI / (double)order);
 
             for( int n = 0; n < (order+1); n++ )
             {
-                window[n] = 0.42 
-                    - 0.5 * cos( 2.0 * M_PI * ((Float)n / (Float)order) ) 
-                    + 0.08 * cos( 4.0 * M_PI * ((Float)n / (Float)order) );
+                // cos(4*PI*n/M) = 2cos^2(2*PI*n/M) - 1
+                double c = phasor.cosine();
+                window[n] = 0.42 - 0.5 * c + 0.08 * (2.0 * c * c - 1.0);
+                phasor.next();
+            }
+
+            return window;
+            break;
+        }
+
+        case FilterWindowType::KAISER:
+        {
+            // w(n) = I0(beta*sqrt(1 - (2n/M - 1)^2)) / I0(beta)
+            std::vector<T> window(order+1);
+            double scale = 1.0 / besselI0(m_kaiserBeta);
+
+            for( int n = 0; n < (order+1); n++ )
+            {
+                double r = (2.0 * (double)n / (double)order) - 1.0;
+                double s = 1.0 - r * r;
+                window[n] = besselI0(m_kaiserBeta * sqrt(s < 0.0 ? 0.0 : s)) * scale;
             }
 
             return window;
@@ -228,7 +497,7 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
         default: 
         {
             // w(n) = 1 - rectangular
-            std::vector<Float> window(order+1, 1.0);
+            std::vector<T> window(order+1, 1.0);
 
             return window;
             break;
@@ -239,16 +508,18 @@ std::vector<Float> FilterFactory::createWindowWeights(int order,
  
  
 //! Create Sinc Weights
-std::vector<Float> FilterFactory::createSincWeights(int order, 
+template <typename T>
+std::vector<T> BasicFilterFactory<T>::createSincWeights(int order, 
     FilterType::Type filterType, 
-    Float Fs /* = 0 */, Float Fc1 /* = 0 */, Float Fc2 /* = 0 */)
+    T Fs /* = 0 */, T Fc1 /* = 0 */, T Fc2 /* = 0 */)
 {
     switch( filterType )
     {
         case FilterType::LOWPASS:
         {
-            Float Ft = Fc1 / Fs;
-            std::vector<Float> weights(order+1, 0.0);
+            T Ft = Fc1 / Fs;
+            std::vector<T> weights(order+1, 0.0);
+            Phasor phasor(-2.0 * M_PI * Ft * (double)(order/2), 2.0 * M_PI * Ft);
 
             for( int n = 0; n < (order+1); n++ )
             {
@@ -259,9 +530,9 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
                 }
                 else
                 {
-                    weights[n] = sin( 2.0 * M_PI * Ft * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)));
+                    weights[n] = phasor.sine() / (M_PI * (T)(n - (order/2)));
                 }
+                phasor.next();
             }
 
             return weights;
@@ -270,8 +541,9 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
 
         case FilterType::HIGHPASS:
         {
-            Float Ft = Fc1 / Fs;
-            std::vector<Float> weights(order+1, 0.0);
+            T Ft = Fc1 / Fs;
+            std::vector<T> weights(order+1, 0.0);
+            Phasor phasor(-2.0 * M_PI * Ft * (double)(order/2), 2.0 * M_PI * Ft);
 
             for( int n = 0; n < (order+1); n++ )
             {
@@ -282,10 +554,10 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
                 }
                 else
                 {
-                    weights[n] = -1.0 
-                        * sin( 2.0 * M_PI * Ft * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)));
+                    weights[n] = -1.0 * phasor.sine() 
+                        / (M_PI * (T)(n - (order/2)));
                 }
+                phasor.next();
             }
 
             return weights;
@@ -294,9 +566,11 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
 
         case FilterType::BANDPASS:
         {
-            Float Ft1 = Fc1 / Fs;
-            Float Ft2 = Fc2 / Fs;
-            std::vector<Float> weights(order+1, 0.0);
+            T Ft1 = Fc1 / Fs;
+            T Ft2 = Fc2 / Fs;
+            std::vector<T> weights(order+1, 0.0);
+            Phasor phasor1(-2.0 * M_PI * Ft1 * (double)(order/2), 2.0 * M_PI * Ft1);
+            Phasor phasor2(-2.0 * M_PI * Ft2 * (double)(order/2), 2.0 * M_PI * Ft2);
 
             for( int n = 0; n < (order+1); n++ )
             {
@@ -307,11 +581,11 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
                 }
                 else
                 {
-                    weights[n] = sin( 2.0 * M_PI * Ft2 * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)))
-                        - sin( 2.0 * M_PI * Ft1 * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)));
+                    weights[n] = (phasor2.sine() - phasor1.sine()) 
+                        / (M_PI * (T)(n - (order/2)));
                 }
+                phasor1.next();
+                phasor2.next();
             }
 
             return weights;
@@ -320,9 +594,11 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
 
         case FilterType::BANDSTOP:
         {
-            Float Ft1 = Fc1 / Fs;
-            Float Ft2 = Fc2 / Fs;
-            std::vector<Float> weights(order+1, 0.0);
+            T Ft1 = Fc1 / Fs;
+            T Ft2 = Fc2 / Fs;
+            std::vector<T> weights(order+1, 0.0);
+            Phasor phasor1(-2.0 * M_PI * Ft1 * (double)(order/2), 2.0 * M_PI * Ft1);
+            Phasor phasor2(-2.0 * M_PI * Ft2 * (double)(order/2), 2.0 * M_PI * Ft2);
 
             for( int n = 0; n < (order+1); n++ )
             {
@@ -333,11 +609,11 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
                 }
                 else
                 {
-                    weights[n] = sin( 2.0 * M_PI * Ft1 * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)))
-                        - sin( 2.0 * M_PI * Ft2 * (Float)(n - (order/2)) ) 
-                        / (M_PI * (Float)(n - (order/2)));
+                    weights[n] = (phasor1.sine() - phasor2.sine()) 
+                        / (M_PI * (T)(n - (order/2)));
                 }
+                phasor1.next();
+                phasor2.next();
             }
 
         return weights;
@@ -347,16 +623,42 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
         case FilterType::ALLPASS:
         {
             // w(n) = 0 except at M/2 where w(n) = 1
-            std::vector<Float> weights(order+1, 0.0);
+            std::vector<T> weights(order+1, 0.0);
             weights[order/2] = 1.0;
             return weights;
             break;
         }
 
+        case FilterType::HALFBAND:
+        {
+            // LOWPASS at Fs/4: sin(pi*m/2) / (pi*m), exactly zero for even m
+            std::vector<T> weights(order+1, 0.0);
+
+            for( int n = 0; n < (order+1); n++ )
+            {
+                int m = n - (order/2);
+
+                if( m == 0 )
+                {
+                    // Centre
+                    weights[n] = 0.5;
+                }
+                else if( (m % 2) != 0 )
+                {
+                    // sin(pi*m/2) alternates +1, -1 over odd m
+                    T sign = (((m - 1) / 2) % 2 == 0) ? 1.0 : -1.0;
+                    weights[n] = sign / (M_PI * (T)m);
+                }
+            }
+
+            return weights;
+            break;
+        }
+
         default:
         {
             // w(n) = 0 except at M/2 where w(n) = 1
-            std::vector<Float> weights(order+1, 0.0);
+            std::vector<T> weights(order+1, 0.0);
             weights[order/2] = 1.0;
             return weights;
             break;
@@ -366,12 +668,13 @@ std::vector<Float> FilterFactory::createSincWeights(int order,
  
  
 //! Create Filter Weights - Combines Sinc and Window Weights
-std::vector<Float> FilterFactory::createFilterWeights(int order, 
+template <typename T>
+std::vector<T> BasicFilterFactory<T>::createFilterWeights(int order, 
     FilterWindowType::Type windowType, FilterType::Type filterType, 
-    Float Fs /* = 0 */, Float Fc1 /* = 0 */, Float Fc2 /* = 0 */)
+    T Fs /* = 0 */, T Fc1 /* = 0 */, T Fc2 /* = 0 */)
 {
-    std::vector<Float> window = createWindowWeights(order, windowType);
-    std::vector<Float> weights = createSincWeights(order, filterType, 
+    std::vector<T> window = createWindowWeights(order, windowType);
+    std::vector<T> weights = createSincWeights(order, filterType, 
                                                     Fs, Fc1, Fc2);
 
     // Now multiply window weights with sinc weights.
@@ -387,12 +690,13 @@ std::vector<Float> FilterFactory::createFilterWeights(int order,
 
     // H(jw) is frequency response (so calculate complex gain for a given frequency then take magnitude).
 
-    Float FtSelected = 0.0;
+    T FtSelected = 0.0;
 
     switch( filterType )
     {
         case FilterType::LOWPASS:
         case FilterType::BANDSTOP:
+        case FilterType::HALFBAND:
         {
             /*
             // Simplified version to calculate gain at DC.
@@ -418,8 +722,8 @@ std::vector<Float> FilterFactory::createFilterWeights(int order,
         case FilterType::BANDPASS:
         {
             // Select mid-frequency of the pass band
-            Float Ft1 = Fc1 / Fs;
-            Float Ft2 = Fc2 / Fs;
+            T Ft1 = Fc1 / Fs;
+            T Ft2 = Fc2 / Fs;
             FtSelected = (Ft1 + Ft2) / 2.0;
 
             break;
@@ -428,20 +732,19 @@ std::vector<Float> FilterFactory::createFilterWeights(int order,
 
 
     // Calculate the frequency response's complex gain for the given frequency.
-    Float gainReal = 0.0;
-    Float gainImag = 0.0;
+    T gainReal = 0.0;
+    T gainImag = 0.0;
+    Phasor phasor(-2.0 * M_PI * FtSelected * (double)(order/2), 2.0 * M_PI * FtSelected);
 
     for( int n = 0; n < (order+1); n++ )
     {
-        gainReal = gainReal + weights[n] 
-            * cos( 2.0 * M_PI * FtSelected * (Float)(n - (order/2)) );
-
-        gainImag = gainImag - weights[n] 
-            * sin( 2.0 * M_PI * FtSelected * (Float)(n - (order/2)) );
+        gainReal = gainReal + weights[n] * phasor.cosine();
+        gainImag = gainImag - weights[n] * phasor.sine();
+        phasor.next();
     }
 
     // Get the magnitude of the complex gain.
-    Float gain = sqrt( gainReal * gainReal + gainImag * gainImag );
+    T gain = sqrt( gainReal * gainReal + gainImag * gainImag );
 
 
     // Now divide weights by the gain magnitude.
@@ -454,5 +757,384 @@ std::vector<Float> FilterFactory::createFilterWeights(int order,
 }
 
 
+//! Is Symmetric - True if h[n] == h[order-n] to within a tolerance
+template <typename T>
+bool BasicFilterFactory<T>::isSymmetric(const BasicFilterHolderType<T>& filter, 
+    T relativeTolerance /* = 1e-5 */)
+{
+    size_t length = filter.coefficients.size();
+
+    T largest = 0.0;
+    for( size_t n = 0; n < length; n++ )
+    {
+        if( fabs(filter.coefficients[n]) > largest )
+        {
+            largest = fabs(filter.coefficients[n]);
+        }
+    }
+
+    for( size_t n = 0; n < length/2; n++ )
+    {
+        if( fabs(filter.coefficients[n] - filter.coefficients[length-1-n]) 
+            > (relativeTolerance * largest) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//! Create Kaiser Filter - the minimum order filter meeting the specification
+template <typename T>
+BasicFilterHolderType<T> BasicFilterFactory<T>::createKaiserFilter(
+    const BasicFilterSpecificationType<T>& specification, 
+    BasicFilterResponseType<T>* response /* = NULL */, int maxOrder /* = 65536 */)
+{
+    // The design uses its own beta, leaving the one set by the caller alone
+    T savedBeta = m_kaiserBeta;
+    m_kaiserBeta = estimateKaiserBeta(specification);
+
+    if( maxOrder < 2 )
+    {
+        maxOrder = 2;
+    }
+
+    // HALFBAND orders stay at 4k+2
+    int step = (specification.filterType == FilterType::HALFBAND) ? 4 : 2;
+
+    int order = estimateKaiserOrder(specification);
+    if( order > maxOrder )
+    {
+        // The longest allowed order of the right form
+        order = (step == 4) ? maxOrder - ((maxOrder - 2) % 4) : maxOrder - (maxOrder % 2);
+    }
+
+    BasicFilterHolderType<T> filter = createFilter(order, FilterWindowType::KAISER, 
+        specification.filterType, specification.Fs, specification.Fc1, 
+        specification.Fc2);
+    BasicFilterResponseType<T> achieved = measureResponse(filter, specification);
+
+    if( achieved.meetsSpecification )
+    {
+        // Kaiser's estimate is conservative near the band edges - step down 
+        // while the shorter filter still meets the specification
+        while( order > step )
+        {
+            BasicFilterHolderType<T> shorter = createFilter(order - step, 
+                FilterWindowType::KAISER, specification.filterType, 
+                specification.Fs, specification.Fc1, specification.Fc2);
+            BasicFilterResponseType<T> shorterAchieved = measureResponse(shorter, 
+                specification);
+
+            if( !shorterAchieved.meetsSpecification )
+            {
+                break;
+            }
+
+            order -= step;
+            filter = shorter;
+            achieved = shorterAchieved;
+        }
+    }
+    else
+    {
+        // Step up until it does
+        while( !achieved.meetsSpecification && (order + step) <= maxOrder )
+        {
+            order += step;
+            filter = createFilter(order, FilterWindowType::KAISER, 
+                specification.filterType, specification.Fs, 
+                specification.Fc1, specification.Fc2);
+            achieved = measureResponse(filter, specification);
+        }
+    }
+
+    achieved.kaiserBeta = m_kaiserBeta;
+    m_kaiserBeta = savedBeta;
+
+    if( response != NULL )
+    {
+        *response = achieved;
+    }
+
+    return filter;
+}
+
+
+//! Estimate Kaiser Order - Kaiser's formula, rounded up to even
+template <typename T>
+int BasicFilterFactory<T>::estimateKaiserOrder(
+    const BasicFilterSpecificationType<T>& specification)
+{
+    // M = (A - 8) / (2.285 * dw) where dw is the transition width in rad/sample
+    double A = requiredAttenuationDb(specification);
+    double dw = 2.0 * M_PI * specification.transitionWidth / specification.Fs;
+
+    int order = (int)ceil( (A - 8.0) / (2.285 * dw) );
+
+    // Even, so there is a centre tap (needed by HIGHPASS and BANDSTOP)
+    order += (order % 2);
+
+    if( specification.filterType == FilterType::HALFBAND )
+    {
+        // 4k+2, so the end taps are not zeros
+        order += (order % 4 == 0) ? 2 : 0;
+    }
+
+    return (order < 2) ? 2 : order;
+}
+
+
+//! Estimate Kaiser Beta - Kaiser's formula
+template <typename T>
+T BasicFilterFactory<T>::estimateKaiserBeta(
+    const BasicFilterSpecificationType<T>& specification)
+{
+    double A = requiredAttenuationDb(specification);
+
+    if( A > 50.0 )
+    {
+        return 0.1102 * (A - 8.7);
+    }
+    else if( A >= 21.0 )
+    {
+        return 0.5842 * pow(A - 21.0, 0.4) + 0.07886 * (A - 21.0);
+    }
+
+    return 0.0;
+}
+
+
+//! Measure Response - ripple and attenuation over the bands of a specification
+template <typename T>
+BasicFilterResponseType<T> BasicFilterFactory<T>::measureResponse(
+    const BasicFilterHolderType<T>& filter, 
+    const BasicFilterSpecificationType<T>& specification)
+{
+    // H(f) on the grid by a zero-padded FFT - in double whatever T is, so the
+    // measurement is not limited by the precision of the design
+    size_t length = filter.coefficients.size();
+    Fft<double> fft(2 * (length + 1) * FILTERFACTORY_RESPONSE_GRID);
+
+    std::vector<double> input(fft.size(), 0.0);
+    for( size_t n = 0; n < length; n++ )
+    {
+        input[n] = (double)filter.coefficients[n];
+    }
+
+    std::vector<double> real(fft.spectrumSize());
+    std::vector<double> imag(fft.spectrumSize());
+    fft.forward(&input[0], &real[0], &imag[0]);
+
+    for( size_t k = 0; k < real.size(); k++ )
+    {
+        real[k] = sqrt( real[k] * real[k] + imag[k] * imag[k] );
+    }
+
+    return measureMagnitude(&real[0], real.size(), filter.order, specification);
+}
+
+
+//! Measure Magnitude - ripple and attenuation over the bands of a specification
+template <typename T>
+BasicFilterResponseType<T> BasicFilterFactory<T>::measureMagnitude(
+    const double * magnitude, size_t pointCount, int order, 
+    const BasicFilterSpecificationType<T>& specification)
+{
+    // Band edges either side of each cutoff - HALFBAND is always cut at Fs/4
+    double halfWidth = 0.5 * specification.transitionWidth;
+    double nyquist = 0.5 * specification.Fs;
+    double Fc1 = (specification.filterType == FilterType::HALFBAND) 
+        ? 0.25 * specification.Fs : specification.Fc1;
+    double lowEdge1 = Fc1 - halfWidth;
+    double highEdge1 = Fc1 + halfWidth;
+    double lowEdge2 = specification.Fc2 - halfWidth;
+    double highEdge2 = specification.Fc2 + halfWidth;
+
+    double passbandMax = 0.0;
+    double passbandMin = HUGE_VAL;
+    double stopbandMax = 0.0;
+
+    for( size_t k = 0; k < pointCount; k++ )
+    {
+        double f = (pointCount > 1) ? nyquist * (double)k / (double)(pointCount - 1) : 0.0;
+
+        bool passband = false;
+        bool stopband = false;
+
+        switch( specification.filterType )
+        {
+            case FilterType::LOWPASS:
+            case FilterType::HALFBAND:
+                passband = (f <= lowEdge1);
+                stopband = (f >= highEdge1);
+                break;
+
+            case FilterType::HIGHPASS:
+                passband = (f >= highEdge1);
+                stopband = (f <= lowEdge1);
+                break;
+
+            case FilterType::BANDPASS:
+                passband = (f >= highEdge1) && (f <= lowEdge2);
+                stopband = (f <= lowEdge1) || (f >= highEdge2);
+                break;
+
+            case FilterType::BANDSTOP:
+                passband = (f <= lowEdge1) || (f >= highEdge2);
+                stopband = (f >= highEdge1) && (f <= lowEdge2);
+                break;
+
+            default:
+                passband = true;
+                break;
+        }
+
+        double gain = magnitude[k];
+
+        if( passband )
+        {
+            passbandMax = (gain > passbandMax) ? gain : passbandMax;
+            passbandMin = (gain < passbandMin) ? gain : passbandMin;
+        }
+        else if( stopband )
+        {
+            stopbandMax = (gain > stopbandMax) ? gain : stopbandMax;
+        }
+    }
+
+    BasicFilterResponseType<T> response;
+    response.order = order;
+    response.kaiserBeta = 0.0;
+
+    // No passband (or stopband) points on the grid counts as no ripple (or 
+    // infinite attenuation)
+    response.passbandRippleDb = 0.0;
+    if( passbandMin != HUGE_VAL )
+    {
+        response.passbandRippleDb = (passbandMin > 0.0) 
+            ? 20.0 * log10(passbandMax / passbandMin) : HUGE_VAL;
+    }
+
+    response.stopbandAttenuationDb = (stopbandMax > 0.0) 
+        ? -20.0 * log10(stopbandMax) : HUGE_VAL;
+
+    response.meetsSpecification = 
+        (response.passbandRippleDb <= specification.passbandRippleDb) 
+        && (response.stopbandAttenuationDb >= specification.stopbandAttenuationDb);
+
+    return response;
+}
+
+
+//! Modified Bessel function of the first kind, order zero
+template <typename T>
+double BasicFilterFactory<T>::besselI0(double x)
+{
+    // I0(x) = sum ((x/2)^k / k!)^2 - converges for all x, terms stop 
+    // mattering well before k = 100 for the betas used in windows
+    double halfX = 0.5 * x;
+    double term = 1.0;
+    double sum = 1.0;
+
+    for( int k = 1; k < 100; k++ )
+    {
+        term *= halfX / (double)k;
+        double termSquared = term * term;
+        sum += termSquared;
+
+        if( termSquared < sum * 1e-17 )
+        {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+
+//! Quantise Filter - to fixed point with fractionalBits (15 or 31)
+template <typename T>
+QuantisedFilterHolderType BasicFilterFactory<T>::quantiseFilter(
+    const BasicFilterHolderType<T>& filter, 
+    int fractionalBits /* = 15 */, bool scaleForHeadroom /* = false */)
+{
+    fractionalBits = (fractionalBits > 15) ? 31 : 15;
+    double one = ldexp(1.0, fractionalBits);
+
+    double absoluteSum = 0.0;
+    for( size_t n = 0; n < filter.coefficients.size(); n++ )
+    {
+        absoluteSum += fabs(filter.coefficients[n]);
+    }
+
+    QuantisedFilterHolderType quantised;
+    quantised.order = filter.order;
+    quantised.fractionalBits = fractionalBits;
+    quantised.coefficients.resize(filter.coefficients.size());
+    quantised.scale = 1.0;
+    quantised.maxError = 0.0;
+
+    // Truncating towards zero keeps the quantised sum|h| <= 1 - rounding to
+    // nearest can push a sum of exactly 1 (e.g. a lowpass with no negative 
+    // taps) just over
+    bool truncate = scaleForHeadroom;
+    if( scaleForHeadroom && (absoluteSum > 1.0) )
+    {
+        quantised.scale = 1.0 / absoluteSum;
+    }
+
+    double quantisedSum = 0.0;
+    for( size_t n = 0; n < filter.coefficients.size(); n++ )
+    {
+        double value = (double)filter.coefficients[n] * (double)quantised.scale * one;
+        value = truncate ? ((value < 0.0) ? ceil(value) : floor(value)) : floor(value + 0.5);
+
+        // Saturate to the range of the format, [-1, 1)
+        if( value > (one - 1.0) )
+        {
+            value = one - 1.0;
+        }
+        else if( value < -one )
+        {
+            value = -one;
+        }
+
+        quantised.coefficients[n] = (int32_t)value;
+        quantisedSum += fabs(value);
+
+        double error = fabs(value / one 
+            - (double)filter.coefficients[n] * (double)quantised.scale);
+        quantised.maxError = (error > quantised.maxError) ? error : quantised.maxError;
+    }
+
+    quantised.absoluteSum = quantisedSum / one;
+    quantised.headroomBits = (quantised.absoluteSum > 1.0) 
+        ? (int)ceil( log((double)quantised.absoluteSum) / log(2.0) ) : 0;
+
+    return quantised;
+}
+
+
+//! Required attenuation in dB - the tighter of the ripple and stopband
+template <typename T>
+double BasicFilterFactory<T>::requiredAttenuationDb(
+    const BasicFilterSpecificationType<T>& specification)
+{
+    // The Kaiser window gives the same deviation in every band, so design for
+    // the smaller of the passband deviation and the stopband deviation
+    double rippleGain = pow(10.0, specification.passbandRippleDb / 20.0);
+    double passbandDeviation = (rippleGain - 1.0) / (rippleGain + 1.0);
+    double stopbandDeviation = pow(10.0, -specification.stopbandAttenuationDb / 20.0);
+
+    double deviation = (passbandDeviation < stopbandDeviation) 
+        ? passbandDeviation : stopbandDeviation;
+
+    return -20.0 * log10(deviation);
+}
+
+
 
 #endif // FILTERFACTORY_H
@@ -0,0 +1,254 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FirFilter.h
+//
+//------------------------------------------------------------------------------
+//
+// Stateful streaming FIR filter. Runs the coefficients from a FilterFactory
+// design over a MirroredDelayLine so that each output is a single pass over
+// contiguous memory.
+//
+// The delay line holds the most recent (order+1) samples with the oldest at
+// data()[0] and the newest at data()[order]. The coefficients are stored
+// time-reversed so the convolution becomes a straight dot product against
+// data():
+//   y[n] = sum h[k] x[n-k] = sum h[order-j] data()[j]
+// which is handed to the SIMD kernels in DotProduct.h.
+//
+// Linear-phase designs (h[n] == h[order-n]) can be run in a folded mode where
+// the mirrored samples are pre-added and only the first half of the
+// coefficients is multiplied, roughly halving the multiplies per output.
+// This is a clear win for the scalar kernels and long filters. For short and
+// medium filters on AVX2 the extra reversing loads can cost more than the
+// multiplies saved, so it is opt-in.
+//
+// The delay line is a template parameter: MirroredDelayLine by default, or
+// LinearDelayLine, which holds N+B samples instead of 2N and replaces the 
+// second store of each append with a block copy every B appends.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FIRFILTER_H
+#define FIRFILTER_H
+
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+#include "LinearDelayLine.h"
+#include "MirroredDelayLine.h"
+
+//! FIR Symmetry enum container
+struct FirSymmetry
+{
+    typedef enum
+    {
+        NONE = 0,   // Full convolution
+        SYMMETRIC,  // Folded convolution - asserts the coefficients are 
+                    // symmetric, full convolution if they are not
+        AUTO        // Folded if FilterFactory::isSymmetric(), else full
+    } Type;
+};
+
+
+template <typename DataType, typename DelayLineType = MirroredDelayLine<DataType> >
+class FirFilter
+{
+public:
+
+    //! Constructor
+    //! filter = the filter designed by FilterFactory::createFilter
+    //! symmetry = whether to use the folded symmetric kernel
+    FirFilter(const BasicFilterHolderType<DataType>& filter, 
+              FirSymmetry::Type symmetry = FirSymmetry::NONE);
+
+    //! Destructor
+    virtual ~FirFilter();
+
+    //! Reset the filter state (history) to zero
+    void reset();
+
+    //! Get the number of taps (order+1)
+    size_t length();
+
+    //! Get the filter order
+    int order();
+
+    //! Is the folded symmetric kernel in use
+    bool isFolded();
+
+    //! Filter a single sample - returns the filtered sample (0 for a filter
+    //! with no taps)
+    DataType processOne(const DataType& input);
+
+    //! Filter a block of samples. input and output may be the same buffer.
+    //! No allocations are made.
+    void processBlock(const DataType * const input, DataType * output, size_t length);
+
+protected:
+
+private:
+    //! Filter Order
+    int m_order;
+
+    //! Number of taps
+    size_t m_tapCount;
+
+    //! Folded symmetric kernel in use
+    bool m_folded;
+
+    //! Time-reversed coefficients to match the delay line layout
+    std::vector<DataType> m_coefficients;
+
+    //! Input history
+    DelayLineType m_delayLine;
+
+}; // class FirFilter
+
+
+//! Constructor
+template <typename DataType, typename DelayLineType>
+FirFilter<DataType, DelayLineType>::FirFilter(const BasicFilterHolderType<DataType>& filter, 
+                               FirSymmetry::Type symmetry)
+    : m_order(filter.order), m_tapCount(filter.coefficients.size()),
+      m_folded(false), m_coefficients(m_tapCount), 
+      m_delayLine(m_tapCount, DataType(0))
+{
+    for( size_t j = 0; j < m_tapCount; j++ )
+    {
+        m_coefficients[j] = (DataType)filter.coefficients[m_tapCount - 1 - j];
+    }
+
+    switch( symmetry )
+    {
+        case FirSymmetry::SYMMETRIC:
+        {
+            // Folding averages the mirrored pairs, which would quietly turn
+            // an asymmetric design into a different filter
+            m_folded = BasicFilterFactory<DataType>::isSymmetric(filter);
+            assert(m_folded);
+            break;
+        }
+
+        case FirSymmetry::AUTO:
+        {
+            m_folded = BasicFilterFactory<DataType>::isSymmetric(filter);
+            break;
+        }
+
+        default:
+        {
+            m_folded = false;
+            break;
+        }
+    }
+
+    if( m_folded )
+    {
+        // Average the mirrored pairs so any rounding asymmetry is shared
+        for( size_t j = 0; j < m_tapCount/2; j++ )
+        {
+            DataType average = (m_coefficients[j] + m_coefficients[m_tapCount - 1 - j]) / DataType(2);
+            m_coefficients[j] = average;
+            m_coefficients[m_tapCount - 1 - j] = average;
+        }
+    }
+}
+
+
+//! Destructor
+template <typename DataType, typename DelayLineType>
+FirFilter<DataType, DelayLineType>::~FirFilter()
+{
+}
+
+
+//! Reset the filter state (history) to zero
+template <typename DataType, typename DelayLineType>
+void FirFilter<DataType, DelayLineType>::reset()
+{
+    m_delayLine.clear(DataType(0));
+}
+
+
+//! Get the number of taps (order+1)
+template <typename DataType, typename DelayLineType>
+size_t FirFilter<DataType, DelayLineType>::length()
+{
+    return m_tapCount;
+}
+
+
+//! Get the filter order
+template <typename DataType, typename DelayLineType>
+int FirFilter<DataType, DelayLineType>::order()
+{
+    return m_order;
+}
+
+
+//! Is the folded symmetric kernel in use
+template <typename DataType, typename DelayLineType>
+bool FirFilter<DataType, DelayLineType>::isFolded()
+{
+    return m_folded;
+}
+
+
+//! Filter a single sample - returns the filtered sample
+template <typename DataType, typename DelayLineType>
+DataType FirFilter<DataType, DelayLineType>::processOne(const DataType& input)
+{
+    // An empty design has no delay line to append to
+    if( m_tapCount == 0 )
+    {
+        return DataType(0);
+    }
+
+    m_delayLine.append(input);
+
+    if( m_folded )
+    {
+        return DotProduct::foldedDot(m_delayLine.data(), &m_coefficients[0], m_tapCount);
+    }
+
+    return DotProduct::dot(m_delayLine.data(), &m_coefficients[0], m_tapCount);
+}
+
+
+//! Filter a block of samples. input and output may be the same buffer.
+template <typename DataType, typename DelayLineType>
+void FirFilter<DataType, DelayLineType>::processBlock(const DataType * const input, DataType * output, size_t length)
+{
+    for( size_t i = 0; i < length; i++ )
+    {
+        output[i] = processOne(input[i]);
+    }
+}
+
+
+#endif // FIRFILTER_H
@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FirFilterBank.h
+//
+//------------------------------------------------------------------------------
+//
+// Multi-channel streaming FIR filter for many channels run through the same
+// FilterFactory design, e.g. an array of hydrophones.
+//
+// Rather than one MirroredDelayLine per channel, the history is held 
+// structure-of-arrays: row j holds sample j of every channel, padded to a
+// multiple of FIRFILTERBANK_LANE_PAD channels. The rows are mirrored the same
+// way as MirroredDelayLine, so the newest (order+1) rows are always contiguous
+// with the oldest first. Each output frame is then one DotProduct::laneDot,
+// where every coefficient is loaded once and applied to a full vector of 
+// channels at a time.
+//
+// Input and output blocks may be interleaved (frame by frame, channels 
+// adjacent) or planar (one buffer per channel).
+//
+//------------------------------------------------------------------------------
+
+#ifndef FIRFILTERBANK_H
+#define FIRFILTERBANK_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+
+//! Channels in each history row are padded to a multiple of this
+#define FIRFILTERBANK_LANE_PAD 16
+
+
+template <typename DataType>
+class FirFilterBank
+{
+public:
+
+    //! Constructor
+    //! filter = the filter designed by FilterFactory::createFilter
+    //! channelCount = the number of channels, each filtered independently
+    FirFilterBank(const BasicFilterHolderType<DataType>& filter, size_t channelCount);
+
+    //! Destructor
+    virtual ~FirFilterBank();
+
+    //! Reset the filter state (history of every channel) to zero
+    void reset();
+
+    //! Get the number of taps (order+1)
+    size_t length();
+
+    //! Get the filter order
+    int order();
+
+    //! Get the number of channels
+    size_t channelCount();
+
+    //! Filter one frame - one sample for each channel. input and output may 
+    //! be the same buffer. A filter with no taps outputs zeros.
+    void processFrame(const DataType * const input, DataType * output);
+
+    //! Filter a block of interleaved frames - input[frame*channelCount + c].
+    //! input and output may be the same buffer. No allocations are made.
+    void processInterleaved(const DataType * const input, DataType * output, 
+                            size_t frameCount);
+
+    //! Filter a block of planar frames - input[c][frame]. input and output 
+    //! may be the same buffers. No allocations are made.
+    void processPlanar(const DataType * const * input, DataType * const * output, 
+                       size_t frameCount);
+
+protected:
+
+private:
+    //! Write one row of history and advance
+    void appendRow();
+
+    //! Filter Order
+    int m_order;
+
+    //! Number of taps
+    size_t m_tapCount;
+
+    //! Number of channels
+    size_t m_channelCount;
+
+    //! Distance between history rows (channelCount rounded up)
+    size_t m_stride;
+
+    //! Row the next frame is written to (and its mirror at + tapCount)
+    size_t m_position;
+
+    //! Time-reversed coefficients to match the history layout
+    std::vector<DataType> m_coefficients;
+
+    //! Mirrored history - 2 * tapCount rows of stride samples
+    std::vector<DataType> m_history;
+
+    //! Staging row for planar input and output
+    std::vector<DataType> m_frame;
+
+}; // class FirFilterBank
+
+
+//! Constructor
+template <typename DataType>
+FirFilterBank<DataType>::FirFilterBank(const BasicFilterHolderType<DataType>& filter, 
+                                       size_t channelCount)
+    : m_order(filter.order), m_tapCount(filter.coefficients.size()),
+      m_channelCount(channelCount), 
+      m_stride(((channelCount + FIRFILTERBANK_LANE_PAD - 1) / FIRFILTERBANK_LANE_PAD) 
+               * FIRFILTERBANK_LANE_PAD),
+      m_position(0), m_coefficients(m_tapCount), 
+      m_history(2 * m_tapCount * m_stride, DataType(0)),
+      m_frame(m_stride, DataType(0))
+{
+    for( size_t j = 0; j < m_tapCount; j++ )
+    {
+        m_coefficients[j] = (DataType)filter.coefficients[m_tapCount - 1 - j];
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+FirFilterBank<DataType>::~FirFilterBank()
+{
+}
+
+
+//! Reset the filter state (history of every channel) to zero
+template <typename DataType>
+void FirFilterBank<DataType>::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), DataType(0));
+    m_position = 0;
+}
+
+
+//! Get the number of taps (order+1)
+template <typename DataType>
+size_t FirFilterBank<DataType>::length()
+{
+    return m_tapCount;
+}
+
+
+//! Get the filter order
+template <typename DataType>
+int FirFilterBank<DataType>::order()
+{
+    return m_order;
+}
+
+
+//! Get the number of channels
+template <typename DataType>
+size_t FirFilterBank<DataType>::channelCount()
+{
+    return m_channelCount;
+}
+
+
+//! Filter one frame - one sample for each channel
+template <typename DataType>
+void FirFilterBank<DataType>::processFrame(const DataType * const input, DataType * output)
+{
+    // An empty design has no history to append to
+    if( m_tapCount == 0 )
+    {
+        std::fill(output, output + m_channelCount, DataType(0));
+        return;
+    }
+
+    memcpy(&m_frame[0], input, m_channelCount * sizeof(DataType));
+    appendRow();
+
+    // Oldest row first, newest last
+    DotProduct::laneDot(&m_history[m_position * m_stride], m_stride, 
+                        &m_coefficients[0], m_tapCount, output, m_channelCount);
+}
+
+
+//! Filter a block of interleaved frames
+template <typename DataType>
+void FirFilterBank<DataType>::processInterleaved(const DataType * const input, 
+    DataType * output, size_t frameCount)
+{
+    for( size_t frame = 0; frame < frameCount; frame++ )
+    {
+        processFrame(input + frame * m_channelCount, output + frame * m_channelCount);
+    }
+}
+
+
+//! Filter a block of planar frames
+template <typename DataType>
+void FirFilterBank<DataType>::processPlanar(const DataType * const * input, 
+    DataType * const * output, size_t frameCount)
+{
+    // An empty design has no history to append to
+    if( m_tapCount == 0 )
+    {
+        for( size_t c = 0; c < m_channelCount; c++ )
+        {
+            std::fill(output[c], output[c] + frameCount, DataType(0));
+        }
+        return;
+    }
+
+    for( size_t frame = 0; frame < frameCount; frame++ )
+    {
+        // Gather
+        for( size_t c = 0; c < m_channelCount; c++ )
+        {
+            m_frame[c] = input[c][frame];
+        }
+        appendRow();
+
+        DotProduct::laneDot(&m_history[m_position * m_stride], m_stride, 
+                            &m_coefficients[0], m_tapCount, &m_frame[0], m_channelCount);
+
+        // Scatter
+        for( size_t c = 0; c < m_channelCount; c++ )
+        {
+            output[c][frame] = m_frame[c];
+        }
+    }
+}
+
+
+//! Write one row of history and advance
+template <typename DataType>
+void FirFilterBank<DataType>::appendRow()
+{
+    // Write the row and its mirror
+    memcpy(&m_history[m_position * m_stride], &m_frame[0], 
+           m_channelCount * sizeof(DataType));
+    memcpy(&m_history[(m_position + m_tapCount) * m_stride], &m_frame[0], 
+           m_channelCount * sizeof(DataType));
+
+    m_position++;
+    if( m_position == m_tapCount )
+    {
+        m_position = 0;
+    }
+}
+
+
+#endif // FIRFILTERBANK_H
@@ -0,0 +1,273 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FixedPointFirFilter.h
+//
+//------------------------------------------------------------------------------
+//
+// Streaming FIR filter for int16 PCM with fixed point coefficients from 
+// FilterFactory::quantiseFilter, so int16 input from WavWriter::readWav16 can
+// be filtered and written back without converting each sample to Float.
+//
+// Q15 coefficients run through the int16 DotProduct kernels (pmaddwd on x86),
+// which accumulate in 32 bits. The sum is exact as long as it fits in 32 bits,
+// i.e. sum|h| < 2, which quantiseFilter reports. Q31 coefficients, or Q15 
+// coefficients with sum|h| >= 2, use a scalar 64-bit accumulator instead.
+//
+// The accumulator is rounded to nearest, shifted back down by the number of 
+// fractional bits and saturated to int16. Saturated outputs are counted so
+// that a lack of headroom shows up.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FIXEDPOINTFIRFILTER_H
+#define FIXEDPOINTFIRFILTER_H
+
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+#include "MirroredDelayLine.h"
+
+class FixedPointFirFilter
+{
+public:
+
+    //! Constructor
+    //! filter = the filter quantised by FilterFactory::quantiseFilter
+    FixedPointFirFilter(const QuantisedFilterHolderType& filter);
+
+    //! Destructor
+    virtual ~FixedPointFirFilter();
+
+    //! Reset the filter state (history) and the saturation count to zero
+    void reset();
+
+    //! Get the number of taps (order+1)
+    size_t length();
+
+    //! Get the filter order
+    int order();
+
+    //! Get the number of fractional bits of the coefficients
+    int fractionalBits();
+
+    //! Is the 64-bit accumulator in use
+    bool isWide();
+
+    //! Get the number of outputs saturated since the last reset
+    size_t saturationCount();
+
+    //! Filter a single sample - returns the filtered sample (0 for a filter
+    //! with no taps)
+    int16_t processOne(int16_t input);
+
+    //! Filter a block of samples. input and output may be the same buffer.
+    //! No allocations are made.
+    void processBlock(const int16_t * const input, int16_t * output, size_t length);
+
+protected:
+
+private:
+    //! Round, shift down and saturate an accumulator to int16
+    int16_t saturate(int64_t accumulator);
+
+    //! Filter Order
+    int m_order;
+
+    //! Number of taps
+    size_t m_tapCount;
+
+    //! Fractional bits of the coefficients
+    int m_fractionalBits;
+
+    //! 64-bit accumulator in use
+    bool m_wide;
+
+    //! Outputs saturated since the last reset
+    size_t m_saturationCount;
+
+    //! Time-reversed Q15 coefficients for the 32-bit path
+    std::vector<int16_t> m_coefficients16;
+
+    //! Time-reversed coefficients for the 64-bit path
+    std::vector<int32_t> m_coefficients32;
+
+    //! Input history
+    MirroredDelayLine<int16_t> m_delayLine;
+
+}; // class FixedPointFirFilter
+
+
+//! Constructor
+inline FixedPointFirFilter::FixedPointFirFilter(const QuantisedFilterHolderType& filter)
+    : m_order(filter.order), m_tapCount(filter.coefficients.size()),
+      m_fractionalBits(filter.fractionalBits), 
+      m_wide((filter.fractionalBits > 15) || (filter.absoluteSum >= 2.0)),
+      m_saturationCount(0), m_delayLine(m_tapCount, 0)
+{
+    if( m_wide )
+    {
+        m_coefficients32.resize(m_tapCount);
+        for( size_t j = 0; j < m_tapCount; j++ )
+        {
+            m_coefficients32[j] = filter.coefficients[m_tapCount - 1 - j];
+        }
+    }
+    else
+    {
+        m_coefficients16.resize(m_tapCount);
+        for( size_t j = 0; j < m_tapCount; j++ )
+        {
+            m_coefficients16[j] = (int16_t)filter.coefficients[m_tapCount - 1 - j];
+        }
+    }
+}
+
+
+//! Destructor
+inline FixedPointFirFilter::~FixedPointFirFilter()
+{
+}
+
+
+//! Reset the filter state (history) and the saturation count to zero
+inline void FixedPointFirFilter::reset()
+{
+    m_delayLine.clear(0);
+    m_saturationCount = 0;
+}
+
+
+//! Get the number of taps (order+1)
+inline size_t FixedPointFirFilter::length()
+{
+    return m_tapCount;
+}
+
+
+//! Get the filter order
+inline int FixedPointFirFilter::order()
+{
+    return m_order;
+}
+
+
+//! Get the number of fractional bits of the coefficients
+inline int FixedPointFirFilter::fractionalBits()
+{
+    return m_fractionalBits;
+}
+
+
+//! Is the 64-bit accumulator in use
+inline bool FixedPointFirFilter::isWide()
+{
+    return m_wide;
+}
+
+
+//! Get the number of outputs saturated since the last reset
+inline size_t FixedPointFirFilter::saturationCount()
+{
+    return m_saturationCount;
+}
+
+
+//! Filter a single sample - returns the filtered sample
+inline int16_t FixedPointFirFilter::processOne(int16_t input)
+{
+    // An empty design has no delay line to append to
+    if( m_tapCount == 0 )
+    {
+        return 0;
+    }
+
+    m_delayLine.append(input);
+    const int16_t * x = m_delayLine.data();
+
+    if( !m_wide )
+    {
+        return saturate(DotProduct::dot(x, &m_coefficients16[0], m_tapCount));
+    }
+
+    // Independent accumulators so the multiplies overlap
+    const int32_t * h = &m_coefficients32[0];
+    int64_t accumulator0 = 0;
+    int64_t accumulator1 = 0;
+    int64_t accumulator2 = 0;
+    int64_t accumulator3 = 0;
+
+    size_t j = 0;
+    for( ; j + 4 <= m_tapCount; j += 4 )
+    {
+        accumulator0 += (int64_t)x[j] * (int64_t)h[j];
+        accumulator1 += (int64_t)x[j + 1] * (int64_t)h[j + 1];
+        accumulator2 += (int64_t)x[j + 2] * (int64_t)h[j + 2];
+        accumulator3 += (int64_t)x[j + 3] * (int64_t)h[j + 3];
+    }
+    for( ; j < m_tapCount; j++ )
+    {
+        accumulator0 += (int64_t)x[j] * (int64_t)h[j];
+    }
+
+    return saturate((accumulator0 + accumulator1) + (accumulator2 + accumulator3));
+}
+
+
+//! Filter a block of samples. input and output may be the same buffer.
+inline void FixedPointFirFilter::processBlock(const int16_t * const input, 
+    int16_t * output, size_t length)
+{
+    for( size_t i = 0; i < length; i++ )
+    {
+        output[i] = processOne(input[i]);
+    }
+}
+
+
+//! Round, shift down and saturate an accumulator to int16
+inline int16_t FixedPointFirFilter::saturate(int64_t accumulator)
+{
+    int64_t value = (accumulator + ((int64_t)1 << (m_fractionalBits - 1))) >> m_fractionalBits;
+
+    if( value > 32767 )
+    {
+        m_saturationCount++;
+        return 32767;
+    }
+
+    if( value < -32768 )
+    {
+        m_saturationCount++;
+        return -32768;
+    }
+
+    return (int16_t)value;
+}
+
+
+#endif // FIXEDPOINTFIRFILTER_H
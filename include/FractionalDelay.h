@@ -0,0 +1,597 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// FractionalDelay.h
+//
+//------------------------------------------------------------------------------
+//
+// Many fractional-sample reads from one delay line in a single call, e.g. the
+// steering delays of a beamformer. A FractionalTapSet is set up once from a 
+// list of delays (in samples, 0 = the newest sample) and then read against 
+// the current window of a MirroredDelayLine or LinearDelayLine every block.
+//
+// Each delay d is read at window position p = length-1-d, split into an 
+// integer i and a fraction f, and interpolated from K neighbouring samples:
+//   LINEAR   K = 2, (1-f, f)
+//   LAGRANGE K = 4, cubic through x[i-1] .. x[i+2]
+//   SINC     K = FRACTIONALDELAY_SINC_POINTS, sinc(x) with a Kaiser window, 
+//            normalised to unit gain at DC
+// https://ccrma.stanford.edu/~jos/Interpolation/
+//
+// The weights and indices are worked out when the delays are set and held 
+// structure-of-arrays: one array of first indices and K arrays of weights, 
+// each tapCount long. A read is then K passes of 
+//   output[t] += weight[k][t] * x[index[t] + k]
+// across all taps, which the AVX2 and AVX-512 kernels do with gathers, a 
+// vector of taps at a time. The kernels follow the level selected by 
+// DotProduct.
+//
+// The interpolator needs K/2 samples either side of p, so delays are clamped 
+// to [minimumDelay(), maximumDelay()]: minimumDelay() is the latency the 
+// interpolation adds (0 for LINEAR, 1 for LAGRANGE, K/2-1 for SINC). The line
+// must be at least K samples long; a shorter one asserts, and reads zeros 
+// when assertions are off.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FRACTIONALDELAY_H
+#define FRACTIONALDELAY_H
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+
+//! Points either side of the windowed sinc, K
+#define FRACTIONALDELAY_SINC_POINTS 8
+
+//! Kaiser window beta for the windowed sinc
+#define FRACTIONALDELAY_SINC_BETA 5.0
+
+//! Tap arrays are padded to a multiple of this for the vector kernels
+#define FRACTIONALDELAY_LANE_PAD 16
+
+
+//! Interpolation Type enum container
+struct InterpolationType
+{
+    typedef enum
+    {
+        LINEAR = 0,
+        LAGRANGE,
+        SINC
+    } Type;
+};
+
+
+//! Fractional Tap Kernels - output[t] = sum_k weights[k*stride + t] * x[indices[t] + k]
+class FractionalTapKernels
+{
+public:
+    //! Read using the level selected by DotProduct - float
+    static void read(const float * x, const int32_t * indices, const float * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, float * output);
+
+    //! Read using the level selected by DotProduct - double
+    static void read(const double * x, const int32_t * indices, const double * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, double * output);
+
+    //! Read for any other type - scalar only
+    template <typename DataType>
+    static void read(const DataType * x, const int32_t * indices, const DataType * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, DataType * output);
+
+    //! Scalar kernel
+    template <typename DataType>
+    static void readScalar(const DataType * x, const int32_t * indices, const DataType * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, DataType * output);
+
+#if DOTPRODUCT_X86_DISPATCH
+    //! AVX2 gather kernels
+    static void readAvx2(const float * x, const int32_t * indices, const float * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, float * output);
+    static void readAvx2(const double * x, const int32_t * indices, const double * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, double * output);
+
+    //! AVX-512 gather kernels
+    static void readAvx512(const float * x, const int32_t * indices, const float * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, float * output);
+    static void readAvx512(const double * x, const int32_t * indices, const double * weights, 
+        size_t stride, size_t pointCount, size_t tapCount, double * output);
+#endif
+
+}; // class FractionalTapKernels
+
+
+template <typename DataType>
+class FractionalTapSet
+{
+public:
+
+    //! Constructor
+    //! interpolation = how to read between samples
+    //! lineLength = the length of the delay lines that will be read, at 
+    //! least pointCount() for the interpolation
+    FractionalTapSet(InterpolationType::Type interpolation, size_t lineLength);
+
+    //! Destructor
+    virtual ~FractionalTapSet();
+
+    //! Set the delays in samples, clamped to [minimumDelay(), maximumDelay()].
+    //! No allocations are made unless count is more than any count before.
+    void setDelays(const double * const delays, size_t count);
+
+    //! Get the number of taps
+    size_t tapCount();
+
+    //! Get the number of points each tap is interpolated from (K)
+    size_t pointCount();
+
+    //! Get the interpolation type
+    InterpolationType::Type interpolation();
+
+    //! Get the smallest delay that can be read (the interpolation latency)
+    double minimumDelay();
+
+    //! Get the largest delay that can be read
+    double maximumDelay();
+
+    //! Read every tap from a window of lineLength samples, oldest first 
+    //! (e.g. MirroredDelayLine::data()). output holds tapCount() samples.
+    void read(const DataType * const window, DataType * output);
+
+    //! Read every tap from a delay line - delayLine.length() must be 
+    //! lineLength
+    template <typename DelayLineType>
+    void read(DelayLineType& delayLine, DataType * output)
+    {
+        assert(delayLine.length() == m_lineLength);
+        read(delayLine.data(), output);
+    }
+
+protected:
+
+private:
+    //! Weights for fraction f - pointCount values, first point at i-K/2+1
+    void createWeights(double f, double * weights);
+
+    //! Interpolation
+    InterpolationType::Type m_interpolation;
+
+    //! Delay line length
+    size_t m_lineLength;
+
+    //! Points per tap (K)
+    size_t m_pointCount;
+
+    //! Number of taps
+    size_t m_tapCount;
+
+    //! Tap count padded to FRACTIONALDELAY_LANE_PAD - the weight stride
+    size_t m_stride;
+
+    //! First window index of each tap
+    std::vector<int32_t> m_indices;
+
+    //! Weights - pointCount rows of stride
+    std::vector<DataType> m_weights;
+
+    //! Scratch for one tap's weights
+    std::vector<double> m_scratch;
+
+}; // class FractionalTapSet
+
+
+//! Constructor
+template <typename DataType>
+FractionalTapSet<DataType>::FractionalTapSet(InterpolationType::Type interpolation, size_t lineLength)
+    : m_interpolation(interpolation), m_lineLength(lineLength), 
+      m_pointCount((interpolation == InterpolationType::SINC) ? FRACTIONALDELAY_SINC_POINTS 
+                   : ((interpolation == InterpolationType::LAGRANGE) ? 4 : 2)),
+      m_tapCount(0), m_stride(0), m_scratch(m_pointCount)
+{
+    assert(m_lineLength >= m_pointCount);
+}
+
+
+//! Destructor
+template <typename DataType>
+FractionalTapSet<DataType>::~FractionalTapSet()
+{
+}
+
+
+//! Set the delays in samples
+template <typename DataType>
+void FractionalTapSet<DataType>::setDelays(const double * const delays, size_t count)
+{
+    size_t stride = ((count + FRACTIONALDELAY_LANE_PAD - 1) / FRACTIONALDELAY_LANE_PAD) 
+        * FRACTIONALDELAY_LANE_PAD;
+
+    if( stride != m_stride )
+    {
+        m_stride = stride;
+        m_indices.resize(m_stride);
+        m_weights.resize(m_pointCount * m_stride);
+    }
+    m_tapCount = count;
+
+    double minimum = minimumDelay();
+    double maximum = maximumDelay();
+    size_t half = m_pointCount / 2;
+
+    for( size_t t = 0; t < m_stride; t++ )
+    {
+        // Padding reads the first point with zero weight, as does everything 
+        // when the line is too short to interpolate
+        if( (t >= count) || (m_lineLength < m_pointCount) )
+        {
+            m_indices[t] = 0;
+            for( size_t k = 0; k < m_pointCount; k++ )
+            {
+                m_weights[k * m_stride + t] = DataType(0);
+            }
+            continue;
+        }
+
+        double delay = delays[t];
+        delay = (delay < minimum) ? minimum : delay;
+        delay = (delay > maximum) ? maximum : delay;
+
+        double position = (double)(m_lineLength - 1) - delay;
+        double whole = floor(position);
+        size_t i = (size_t)whole;
+
+        // At the newest end the last point has zero weight, keep it in range
+        if( i + half > m_lineLength - 1 )
+        {
+            i = m_lineLength - 1 - half;
+        }
+
+        createWeights(position - (double)i, &m_scratch[0]);
+
+        m_indices[t] = (int32_t)(i + 1 - half);
+        for( size_t k = 0; k < m_pointCount; k++ )
+        {
+            m_weights[k * m_stride + t] = (DataType)m_scratch[k];
+        }
+    }
+}
+
+
+//! Get the number of taps
+template <typename DataType>
+size_t FractionalTapSet<DataType>::tapCount()
+{
+    return m_tapCount;
+}
+
+
+//! Get the number of points each tap is interpolated from (K)
+template <typename DataType>
+size_t FractionalTapSet<DataType>::pointCount()
+{
+    return m_pointCount;
+}
+
+
+//! Get the interpolation type
+template <typename DataType>
+InterpolationType::Type FractionalTapSet<DataType>::interpolation()
+{
+    return m_interpolation;
+}
+
+
+//! Get the smallest delay that can be read (the interpolation latency)
+template <typename DataType>
+double FractionalTapSet<DataType>::minimumDelay()
+{
+    return (double)(m_pointCount / 2 - 1);
+}
+
+
+//! Get the largest delay that can be read
+template <typename DataType>
+double FractionalTapSet<DataType>::maximumDelay()
+{
+    double maximum = (double)m_lineLength - (double)(m_pointCount / 2);
+    return (maximum > minimumDelay()) ? maximum : minimumDelay();
+}
+
+
+//! Read every tap from a window of lineLength samples
+template <typename DataType>
+void FractionalTapSet<DataType>::read(const DataType * const window, DataType * output)
+{
+    if( m_tapCount == 0 )
+    {
+        return;
+    }
+
+    if( m_lineLength < m_pointCount )
+    {
+        // Too short to interpolate - the indices would run off the window
+        for( size_t t = 0; t < m_tapCount; t++ )
+        {
+            output[t] = DataType(0);
+        }
+        return;
+    }
+
+    FractionalTapKernels::read(window, &m_indices[0], &m_weights[0], m_stride, 
+                               m_pointCount, m_tapCount, output);
+}
+
+
+//! Weights for fraction f - first point at i-K/2+1
+template <typename DataType>
+void FractionalTapSet<DataType>::createWeights(double f, double * weights)
+{
+    switch( m_interpolation )
+    {
+        case InterpolationType::LAGRANGE:
+        {
+            // Cubic through the points at -1, 0, 1, 2
+            weights[0] = -f * (f - 1.0) * (f - 2.0) / 6.0;
+            weights[1] = (f + 1.0) * (f - 1.0) * (f - 2.0) / 2.0;
+            weights[2] = -(f + 1.0) * f * (f - 2.0) / 2.0;
+            weights[3] = (f + 1.0) * f * (f - 1.0) / 6.0;
+            break;
+        }
+
+        case InterpolationType::SINC:
+        {
+            double half = (double)(m_pointCount / 2);
+            double i0Beta = BasicFilterFactory<double>::besselI0(FRACTIONALDELAY_SINC_BETA);
+            double sum = 0.0;
+
+            for( size_t k = 0; k < m_pointCount; k++ )
+            {
+                // Distance of the point from the read position
+                double x = (double)k - (half - 1.0) - f;
+                double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+
+                double r = x / half;
+                double window = (fabs(r) < 1.0) 
+                    ? BasicFilterFactory<double>::besselI0(FRACTIONALDELAY_SINC_BETA * sqrt(1.0 - r * r)) / i0Beta
+                    : 1.0 / i0Beta;
+
+                weights[k] = sinc * window;
+                sum += weights[k];
+            }
+
+            for( size_t k = 0; k < m_pointCount; k++ )
+            {
+                weights[k] /= sum;
+            }
+            break;
+        }
+
+        case InterpolationType::LINEAR:
+        default:
+        {
+            weights[0] = 1.0 - f;
+            weights[1] = f;
+            break;
+        }
+    }
+}
+
+
+//! Read using the level selected by DotProduct - float
+inline void FractionalTapKernels::read(const float * x, const int32_t * indices, 
+    const float * weights, size_t stride, size_t pointCount, size_t tapCount, float * output)
+{
+#if DOTPRODUCT_X86_DISPATCH
+    switch( DotProduct::simdLevel() )
+    {
+        case SimdLevel::AVX512:
+            readAvx512(x, indices, weights, stride, pointCount, tapCount, output);
+            return;
+        case SimdLevel::AVX2:
+            readAvx2(x, indices, weights, stride, pointCount, tapCount, output);
+            return;
+        default:
+            break;
+    }
+#endif
+    readScalar(x, indices, weights, stride, pointCount, tapCount, output);
+}
+
+
+//! Read using the level selected by DotProduct - double
+inline void FractionalTapKernels::read(const double * x, const int32_t * indices, 
+    const double * weights, size_t stride, size_t pointCount, size_t tapCount, double * output)
+{
+#if DOTPRODUCT_X86_DISPATCH
+    switch( DotProduct::simdLevel() )
+    {
+        case SimdLevel::AVX512:
+            readAvx512(x, indices, weights, stride, pointCount, tapCount, output);
+            return;
+        case SimdLevel::AVX2:
+            readAvx2(x, indices, weights, stride, pointCount, tapCount, output);
+            return;
+        default:
+            break;
+    }
+#endif
+    readScalar(x, indices, weights, stride, pointCount, tapCount, output);
+}
+
+
+//! Read for any other type - scalar only
+template <typename DataType>
+void FractionalTapKernels::read(const DataType * x, const int32_t * indices, 
+    const DataType * weights, size_t stride, size_t pointCount, size_t tapCount, DataType * output)
+{
+    readScalar(x, indices, weights, stride, pointCount, tapCount, output);
+}
+
+
+//! Scalar kernel - one tap at a time, its points adjacent in x
+template <typename DataType>
+void FractionalTapKernels::readScalar(const DataType * x, const int32_t * indices, 
+    const DataType * weights, size_t stride, size_t pointCount, size_t tapCount, DataType * output)
+{
+    for( size_t t = 0; t < tapCount; t++ )
+    {
+        const DataType * points = x + indices[t];
+        DataType sum = DataType(0);
+
+        for( size_t k = 0; k < pointCount; k++ )
+        {
+            sum += weights[k * stride + t] * points[k];
+        }
+
+        output[t] = sum;
+    }
+}
+
+
+#if DOTPRODUCT_X86_DISPATCH
+
+//! AVX2 gather kernel - float, 8 taps per vector. The arrays are padded to a
+//! multiple of 16 so the last vector is read whole and stored partially.
+DOTPRODUCT_TARGET("avx2,fma")
+inline void FractionalTapKernels::readAvx2(const float * x, const int32_t * indices, 
+    const float * weights, size_t stride, size_t pointCount, size_t tapCount, float * output)
+{
+    for( size_t t = 0; t < tapCount; t += 8 )
+    {
+        __m256i index = _mm256_loadu_si256((const __m256i *)(indices + t));
+        __m256 sum = _mm256_setzero_ps();
+
+        for( size_t k = 0; k < pointCount; k++ )
+        {
+            __m256 points = _mm256_i32gather_ps(x + k, index, 4);
+            sum = _mm256_fmadd_ps(_mm256_loadu_ps(weights + k * stride + t), points, sum);
+        }
+
+        if( t + 8 <= tapCount )
+        {
+            _mm256_storeu_ps(output + t, sum);
+        }
+        else
+        {
+            float partial[8];
+            _mm256_storeu_ps(partial, sum);
+            for( size_t j = 0; t + j < tapCount; j++ )
+            {
+                output[t + j] = partial[j];
+            }
+        }
+    }
+}
+
+
+//! AVX2 gather kernel - double, 4 taps per vector
+DOTPRODUCT_TARGET("avx2,fma")
+inline void FractionalTapKernels::readAvx2(const double * x, const int32_t * indices, 
+    const double * weights, size_t stride, size_t pointCount, size_t tapCount, double * output)
+{
+    for( size_t t = 0; t < tapCount; t += 4 )
+    {
+        __m128i index = _mm_loadu_si128((const __m128i *)(indices + t));
+        __m256d sum = _mm256_setzero_pd();
+
+        for( size_t k = 0; k < pointCount; k++ )
+        {
+            __m256d points = _mm256_i32gather_pd(x + k, index, 8);
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(weights + k * stride + t), points, sum);
+        }
+
+        if( t + 4 <= tapCount )
+        {
+            _mm256_storeu_pd(output + t, sum);
+        }
+        else
+        {
+            double partial[4];
+            _mm256_storeu_pd(partial, sum);
+            for( size_t j = 0; t + j < tapCount; j++ )
+            {
+                output[t + j] = partial[j];
+            }
+        }
+    }
+}
+
+
+//! AVX-512 gather kernel - float, 16 taps per vector, masked last store
+DOTPRODUCT_TARGET("avx512f")
+inline void FractionalTapKernels::readAvx512(const float * x, const int32_t * indices, 
+    const float * weights, size_t stride, size_t pointCount, size_t tapCount, float * output)
+{
+    for( size_t t = 0; t < tapCount; t += 16 )
+    {
+        __m512i index = _mm512_loadu_si512((const void *)(indices + t));
+        __m512 sum = _mm512_setzero_ps();
+
+        for( size_t k = 0; k < pointCount; k++ )
+        {
+            __m512 points = _mm512_i32gather_ps(index, x + k, 4);
+            sum = _mm512_fmadd_ps(_mm512_loadu_ps(weights + k * stride + t), points, sum);
+        }
+
+        size_t remaining = tapCount - t;
+        __mmask16 mask = (remaining >= 16) ? (__mmask16)0xFFFF 
+                                           : (__mmask16)((1u << remaining) - 1u);
+        _mm512_mask_storeu_ps(output + t, mask, sum);
+    }
+}
+
+
+//! AVX-512 gather kernel - double, 8 taps per vector, masked last store
+DOTPRODUCT_TARGET("avx512f")
+inline void FractionalTapKernels::readAvx512(const double * x, const int32_t * indices, 
+    const double * weights, size_t stride, size_t pointCount, size_t tapCount, double * output)
+{
+    for( size_t t = 0; t < tapCount; t += 8 )
+    {
+        __m256i index = _mm256_loadu_si256((const __m256i *)(indices + t));
+        __m512d sum = _mm512_setzero_pd();
+
+        for( size_t k = 0; k < pointCount; k++ )
+        {
+            __m512d points = _mm512_i32gather_pd(index, x + k, 8);
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(weights + k * stride + t), points, sum);
+        }
+
+        size_t remaining = tapCount - t;
+        __mmask8 mask = (remaining >= 8) ? (__mmask8)0xFF 
+                                         : (__mmask8)((1u << remaining) - 1u);
+        _mm512_mask_storeu_pd(output + t, mask, sum);
+    }
+}
+
+#endif // DOTPRODUCT_X86_DISPATCH
+
+
+#endif // FRACTIONALDELAY_H
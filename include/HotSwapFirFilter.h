@@ -0,0 +1,377 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// HotSwapFirFilter.h
+//
+//------------------------------------------------------------------------------
+//
+// Streaming FIR filter whose coefficients can be replaced while it runs.
+//
+// A control thread hands a new design over with setFilter() and the audio 
+// thread picks it up at the start of its next processOne() or processBlock().
+// Neither side takes a lock and the audio thread never allocates: all the
+// coefficient sets and the history are sized for maxLength() taps up front.
+//
+// The handoff is a triple buffer with one extra slot. The control thread 
+// owns a back slot which it fills, then exchanges with the shared middle slot
+// in one atomic operation that also sets a fresh flag. The audio thread, when
+// it sees the flag, exchanges the middle slot for the set it ran before the 
+// current one. It keeps the current set as the previous set, which is what
+// lets it crossfade: for crossfadeLength samples after a swap it runs both
+// sets over the same history and ramps linearly from the old output to the 
+// new. A design that arrives during a crossfade waits for it to finish, and 
+// if several arrive before the audio thread looks, only the latest is used.
+//
+// The history is kept across a swap, so no samples are dropped or repeated, 
+// and designs of different orders can be swapped in (up to maxLength()). 
+// setFilter() must only be called from one thread at a time.
+//
+// Requires C++11.
+//
+//------------------------------------------------------------------------------
+
+#ifndef HOTSWAPFIRFILTER_H
+#define HOTSWAPFIRFILTER_H
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+#include "MirroredDelayLine.h"
+
+//! Number of coefficient sets - back, middle, current and previous
+#define HOTSWAPFIRFILTER_SLOTS 4
+
+//! Flag on the middle slot index for a set not yet picked up
+#define HOTSWAPFIRFILTER_FRESH 0x8u
+
+
+template <typename DataType>
+class HotSwapFirFilter
+{
+public:
+
+    //! Constructor
+    //! filter = the initial design
+    //! maxLength = the most taps any later design may have (at least the 
+    //! initial design's, and at least 1)
+    //! crossfadeLength = samples to crossfade over after a swap, 0 for none
+    HotSwapFirFilter(const BasicFilterHolderType<DataType>& filter, 
+                     size_t maxLength = 0, size_t crossfadeLength = 0);
+
+    //! Destructor
+    virtual ~HotSwapFirFilter();
+
+    //! Control thread: hand over a new design. Never blocks. Returns false 
+    //! (and leaves the filter as it is) if it has more than maxLength() taps.
+    bool setFilter(const BasicFilterHolderType<DataType>& filter);
+
+    //! Reset the filter state (history and any crossfade) to zero
+    void reset();
+
+    //! Get the number of taps (order+1) of the design in use
+    size_t length();
+
+    //! Get the order of the design in use
+    int order();
+
+    //! Get the most taps a design may have
+    size_t maxLength();
+
+    //! Get the crossfade length in samples
+    size_t crossfadeLength();
+
+    //! Is a crossfade in progress
+    bool isCrossfading();
+
+    //! Number of designs picked up since construction
+    size_t swapCount();
+
+    //! Filter a single sample - returns the filtered sample
+    DataType processOne(const DataType& input);
+
+    //! Filter a block of samples. input and output may be the same buffer.
+    //! A new design is only picked up at the start of the block.
+    void processBlock(const DataType * const input, DataType * output, size_t length);
+
+protected:
+
+private:
+    //! Not copyable
+    HotSwapFirFilter(const HotSwapFirFilter&);
+    HotSwapFirFilter& operator=(const HotSwapFirFilter&);
+
+    //! Coefficient Set struct
+    struct CoefficientSet
+    {
+        int order;
+        size_t tapCount;
+        std::vector<DataType> coefficients;  //!< Time-reversed, maxLength long
+    };
+
+    //! Copy a design into a set, time-reversed
+    void load(CoefficientSet& set, const BasicFilterHolderType<DataType>& filter);
+
+    //! Audio thread: pick up a fresh design if there is one
+    void acquire();
+
+    //! One output from the current set(s)
+    DataType filterOne(const DataType& input);
+
+    //! Output of one set over the newest samples of the history
+    DataType dot(const CoefficientSet& set);
+
+    //! Most taps
+    size_t m_maxLength;
+
+    //! Crossfade length
+    size_t m_crossfadeLength;
+
+    //! Samples into the crossfade, m_crossfadeLength when not crossfading
+    size_t m_crossfadePosition;
+
+    //! Coefficient sets
+    CoefficientSet m_sets[HOTSWAPFIRFILTER_SLOTS];
+
+    //! Control thread's set
+    unsigned m_back;
+
+    //! Shared set, with HOTSWAPFIRFILTER_FRESH when not yet picked up
+    std::atomic<unsigned> m_middle;
+
+    //! Audio thread's sets
+    unsigned m_current;
+    unsigned m_previous;
+
+    //! Designs picked up
+    size_t m_swapCount;
+
+    //! Input history, maxLength long
+    MirroredDelayLine<DataType> m_delayLine;
+
+}; // class HotSwapFirFilter
+
+
+//! Constructor
+template <typename DataType>
+HotSwapFirFilter<DataType>::HotSwapFirFilter(const BasicFilterHolderType<DataType>& filter, 
+                                             size_t maxLength, size_t crossfadeLength)
+    : m_maxLength(maxLength < filter.coefficients.size() ? filter.coefficients.size() 
+                  : (maxLength > 0 ? maxLength : 1)),
+      m_crossfadeLength(crossfadeLength), m_crossfadePosition(crossfadeLength),
+      m_back(3), m_middle(2), m_current(0), m_previous(1), m_swapCount(0),
+      m_delayLine(m_maxLength, DataType(0))
+{
+    // maxLength is at least 1 so an empty design still has a delay line and
+    // coefficients to point at - it has a zero length dot product
+    for( size_t i = 0; i < HOTSWAPFIRFILTER_SLOTS; i++ )
+    {
+        m_sets[i].coefficients.assign(m_maxLength, DataType(0));
+        load(m_sets[i], filter);
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+HotSwapFirFilter<DataType>::~HotSwapFirFilter()
+{
+}
+
+
+//! Control thread: hand over a new design
+template <typename DataType>
+bool HotSwapFirFilter<DataType>::setFilter(const BasicFilterHolderType<DataType>& filter)
+{
+    if( filter.coefficients.size() > m_maxLength )
+    {
+        return false;
+    }
+
+    load(m_sets[m_back], filter);
+
+    // Publish the filled set and take whichever set was in the middle - 
+    // either one never picked up, or one the audio thread has finished with
+    unsigned previous = m_middle.exchange(m_back | HOTSWAPFIRFILTER_FRESH, 
+                                          std::memory_order_acq_rel);
+    m_back = previous & ~HOTSWAPFIRFILTER_FRESH;
+
+    return true;
+}
+
+
+//! Reset the filter state (history and any crossfade) to zero
+template <typename DataType>
+void HotSwapFirFilter<DataType>::reset()
+{
+    m_delayLine.clear(DataType(0));
+    m_crossfadePosition = m_crossfadeLength;
+}
+
+
+//! Get the number of taps (order+1) of the design in use
+template <typename DataType>
+size_t HotSwapFirFilter<DataType>::length()
+{
+    return m_sets[m_current].tapCount;
+}
+
+
+//! Get the order of the design in use
+template <typename DataType>
+int HotSwapFirFilter<DataType>::order()
+{
+    return m_sets[m_current].order;
+}
+
+
+//! Get the most taps a design may have
+template <typename DataType>
+size_t HotSwapFirFilter<DataType>::maxLength()
+{
+    return m_maxLength;
+}
+
+
+//! Get the crossfade length in samples
+template <typename DataType>
+size_t HotSwapFirFilter<DataType>::crossfadeLength()
+{
+    return m_crossfadeLength;
+}
+
+
+//! Is a crossfade in progress
+template <typename DataType>
+bool HotSwapFirFilter<DataType>::isCrossfading()
+{
+    return m_crossfadePosition < m_crossfadeLength;
+}
+
+
+//! Number of designs picked up since construction
+template <typename DataType>
+size_t HotSwapFirFilter<DataType>::swapCount()
+{
+    return m_swapCount;
+}
+
+
+//! Filter a single sample - returns the filtered sample
+template <typename DataType>
+DataType HotSwapFirFilter<DataType>::processOne(const DataType& input)
+{
+    acquire();
+    return filterOne(input);
+}
+
+
+//! Filter a block of samples. input and output may be the same buffer.
+template <typename DataType>
+void HotSwapFirFilter<DataType>::processBlock(const DataType * const input, DataType * output, 
+                                              size_t length)
+{
+    acquire();
+
+    for( size_t i = 0; i < length; i++ )
+    {
+        output[i] = filterOne(input[i]);
+    }
+}
+
+
+//! Copy a design into a set, time-reversed
+template <typename DataType>
+void HotSwapFirFilter<DataType>::load(CoefficientSet& set, 
+                                      const BasicFilterHolderType<DataType>& filter)
+{
+    set.order = filter.order;
+    set.tapCount = filter.coefficients.size();
+
+    for( size_t j = 0; j < set.tapCount; j++ )
+    {
+        set.coefficients[j] = filter.coefficients[set.tapCount - 1 - j];
+    }
+}
+
+
+//! Audio thread: pick up a fresh design if there is one
+template <typename DataType>
+void HotSwapFirFilter<DataType>::acquire()
+{
+    // Let a crossfade finish first, so only two sets are ever mixed
+    if( isCrossfading() )
+    {
+        return;
+    }
+
+    if( (m_middle.load(std::memory_order_relaxed) & HOTSWAPFIRFILTER_FRESH) == 0 )
+    {
+        return;
+    }
+
+    // Give back the set before the current one, keep the current one to 
+    // crossfade from
+    unsigned fresh = m_middle.exchange(m_previous, std::memory_order_acq_rel);
+    m_previous = m_current;
+    m_current = fresh & ~HOTSWAPFIRFILTER_FRESH;
+    m_crossfadePosition = 0;
+    m_swapCount++;
+}
+
+
+//! One output from the current set(s)
+template <typename DataType>
+DataType HotSwapFirFilter<DataType>::filterOne(const DataType& input)
+{
+    m_delayLine.append(input);
+
+    DataType output = dot(m_sets[m_current]);
+
+    if( m_crossfadePosition < m_crossfadeLength )
+    {
+        // Linear ramp from the previous set's output, reaching the current 
+        // set's one sample after the end of the crossfade
+        m_crossfadePosition++;
+        DataType gain = (DataType)m_crossfadePosition / (DataType)(m_crossfadeLength + 1);
+        DataType fading = dot(m_sets[m_previous]);
+        output = fading + gain * (output - fading);
+    }
+
+    return output;
+}
+
+
+//! Output of one set over the newest samples of the history
+template <typename DataType>
+DataType HotSwapFirFilter<DataType>::dot(const CoefficientSet& set)
+{
+    return DotProduct::dot(m_delayLine.data() + (m_maxLength - set.tapCount), 
+                           &set.coefficients[0], set.tapCount);
+}
+
+
+#endif // HOTSWAPFIRFILTER_H
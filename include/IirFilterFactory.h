@@ -0,0 +1,785 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// IirFilterFactory.h
+//
+//------------------------------------------------------------------------------
+//
+// Butterworth, Chebyshev (type I) and elliptic IIR designs for the FilterType
+// set LOWPASS, HIGHPASS, BANDPASS and BANDSTOP, as a cascade of second order 
+// sections (biquads) for the BiquadFilterBank. Where linear phase is not 
+// needed a low order IIR does the work of a long FIR for a few multiplies 
+// per sample: 5 per section.
+//
+// The design is the classic analogue route, all in double:
+//  1. Poles and zeros of the normalised lowpass prototype, with its passband
+//     edge at 1 rad/s (for Butterworth, the point where the gain has fallen 
+//     by the passband ripple - 3.01 dB by default).
+//  2. Lowpass to lowpass/highpass/bandpass/bandstop transform onto the band
+//     edges, prewarped by 2.Fs.tan(pi.f/Fs).
+//  3. Bilinear transform to the z plane, with the zeros at infinity moved 
+//     to z = -1.
+//  4. Poles and zeros gathered into conjugate pairs. The pole pairs are 
+//     ordered from the furthest from the unit circle to the closest (the 
+//     highest Q last), and each takes the nearest remaining zero pair.
+//  5. Each section is scaled to unit gain at a reference frequency in the 
+//     passband (DC, Fs/2 or the band centre) and the first section is then
+//     set to the passband gain of the prototype there, so the passband 
+//     peaks at 0 dB.
+//
+// The elliptic prototype uses the Landen transformations to evaluate the 
+// Jacobi elliptic functions, which converge to double precision in a few 
+// steps.
+// S. J. Orfanidis, "Lecture Notes on Elliptic Filter Design", 2006.
+// http://www.ece.rutgers.edu/~orfanidi/ece521/notes.pdf
+//
+// As with createKaiserFilter() a FilterSpecificationType can be given instead
+// of an order: the passband edges are placed half a transition width inside
+// each cutoff and the order is stepped up until the measured response meets 
+// the specification. Order here is the order of the prototype; a BANDPASS 
+// or BANDSTOP design has twice that many poles.
+//
+//------------------------------------------------------------------------------
+
+#ifndef IIRFILTERFACTORY_H
+#define IIRFILTERFACTORY_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+
+#include "FilterFactory.h"
+
+//! Default passband ripple (Chebyshev, elliptic) in dB
+#define IIRFILTERFACTORY_RIPPLE_DB 1.0
+
+//! Default stopband attenuation (elliptic) in dB
+#define IIRFILTERFACTORY_ATTENUATION_DB 60.0
+
+//! Largest prototype order tried for a specification
+#define IIRFILTERFACTORY_MAX_ORDER 32
+
+//! Points on the grid used to measure a response, DC to Fs/2
+#define IIRFILTERFACTORY_RESPONSE_POINTS 16385
+
+//! Landen transformations for the elliptic functions
+#define IIRFILTERFACTORY_LANDEN_STEPS 8
+
+
+//! IIR Prototype enum container
+struct IirPrototypeType
+{
+    typedef enum
+    {
+        BUTTERWORTH = 0,
+        CHEBYSHEV,
+        ELLIPTIC
+    } Type;
+};
+
+
+//! Biquad struct - one second order section, a0 = 1
+//! H(z) = (b0 + b1.z^-1 + b2.z^-2) / (1 + a1.z^-1 + a2.z^-2)
+template <typename T>
+struct BasicBiquadType
+{
+    T b0;
+    T b1;
+    T b2;
+    T a1;
+    T a2;
+};
+
+
+//! Biquad Cascade Holder struct
+template <typename T>
+struct BasicBiquadCascadeType
+{
+    //! Constructor
+    BasicBiquadCascadeType() : order(0) {}
+
+    //! Converting Constructor - from a design of another precision
+    template <typename U>
+    BasicBiquadCascadeType(const BasicBiquadCascadeType<U>& other)
+        : order(other.order), sections(other.sections.size())
+    {
+        for( size_t s = 0; s < sections.size(); s++ )
+        {
+            sections[s].b0 = (T)other.sections[s].b0;
+            sections[s].b1 = (T)other.sections[s].b1;
+            sections[s].b2 = (T)other.sections[s].b2;
+            sections[s].a1 = (T)other.sections[s].a1;
+            sections[s].a2 = (T)other.sections[s].a2;
+        }
+    }
+
+    int order;                                  //!< Number of poles
+    std::vector< BasicBiquadType<T> > sections;
+};
+
+//! Single precision cascade
+typedef BasicBiquadCascadeType<float> BiquadCascadeType;
+
+//! Double precision cascade
+typedef BasicBiquadCascadeType<double> DoubleBiquadCascadeType;
+
+
+//! IIR Filter Factory class - T is the precision of the coefficients
+template <typename T>
+class BasicIirFilterFactory
+{
+public:
+    //! Create Filter - a prototype of the given order. Fc1 (and Fc2 for 
+    //! BANDPASS and BANDSTOP) are the passband edges. passbandRippleDb is 
+    //! the ripple of CHEBYSHEV and ELLIPTIC, and stopbandAttenuationDb the 
+    //! stopband of ELLIPTIC; BUTTERWORTH is always 3.01 dB down at the edge.
+    static BasicBiquadCascadeType<T> createFilter(IirPrototypeType::Type prototype, 
+        int order, FilterType::Type filterType, T Fs, T Fc1, T Fc2 = 0, 
+        T passbandRippleDb = IIRFILTERFACTORY_RIPPLE_DB, 
+        T stopbandAttenuationDb = IIRFILTERFACTORY_ATTENUATION_DB);
+
+    //! Create Filter - the minimum order design of the given prototype that 
+    //! meets the specification. The achieved response is written to response
+    //! if given. If no order up to maxOrder meets it, returns the maxOrder 
+    //! design with response->meetsSpecification false.
+    static BasicBiquadCascadeType<T> createFilter(IirPrototypeType::Type prototype, 
+        const BasicFilterSpecificationType<T>& specification, 
+        BasicFilterResponseType<T>* response = NULL, 
+        int maxOrder = IIRFILTERFACTORY_MAX_ORDER);
+
+    //! Magnitude Response - |H| on pointCount evenly spaced frequencies from
+    //! DC (magnitude[0]) to Fs/2 (magnitude[pointCount-1])
+    static void magnitudeResponse(const BasicBiquadCascadeType<T>& cascade, 
+        size_t pointCount, std::vector<double>& magnitude);
+
+    //! Measure Response - ripple and attenuation of a cascade over the bands
+    //! of a specification, on IIRFILTERFACTORY_RESPONSE_POINTS points
+    static BasicFilterResponseType<T> measureResponse(
+        const BasicBiquadCascadeType<T>& cascade, 
+        const BasicFilterSpecificationType<T>& specification);
+
+protected:
+
+private:
+    typedef std::complex<double> Complex;
+
+    //! Design from passband edges in Hz, all in double
+    static BasicBiquadCascadeType<T> design(IirPrototypeType::Type prototype, 
+        int order, FilterType::Type filterType, double Fs, double Fp1, double Fp2, 
+        double passbandRippleDb, double stopbandAttenuationDb);
+
+    //! Normalised lowpass prototype - returns the gain at DC
+    static double createPrototype(IirPrototypeType::Type prototype, int order, 
+        double passbandRippleDb, double stopbandAttenuationDb, 
+        std::vector<Complex>& zeros, std::vector<Complex>& poles);
+
+    //! Pair roots into quadratics 1 + c1.z^-1 + c2.z^-2 - conjugate pairs 
+    //! ordered by distance from the unit circle, then the real roots in twos
+    static void pairRoots(const std::vector<Complex>& roots, 
+        std::vector<Complex>& first, std::vector<Complex>& second, 
+        std::vector<int>& rootCount);
+
+    //! Sort order for keyed roots - largest distance first
+    static bool furtherFromCircle(const std::pair<double, Complex>& a, 
+        const std::pair<double, Complex>& b) { return a.first > b.first; }
+
+    //! Gain of one section at z = exp(j.w)
+    static double sectionGain(const BasicBiquadType<double>& section, double w);
+
+    //! Descending Landen sequence of moduli
+    static void landen(double k, double * sequence);
+
+    //! Jacobi cd(u.K, k) of a complex argument
+    static Complex cde(Complex u, double k);
+
+    //! Jacobi sn(u.K, k) of a complex argument
+    static Complex sne(Complex u, double k);
+
+    //! Inverse of sn, in units of K
+    static Complex asne(Complex w, double k);
+
+    //! Complex arc cosine - not in C++98 <complex>
+    static Complex arcCos(Complex w);
+
+}; // class BasicIirFilterFactory
+
+//! Single precision factory
+typedef BasicIirFilterFactory<float> IirFilterFactory;
+
+//! Double precision factory
+typedef BasicIirFilterFactory<double> DoubleIirFilterFactory;
+
+
+//! Create Filter - a prototype of the given order
+template <typename T>
+BasicBiquadCascadeType<T> BasicIirFilterFactory<T>::createFilter(
+    IirPrototypeType::Type prototype, int order, FilterType::Type filterType, 
+    T Fs, T Fc1, T Fc2 /* = 0 */, 
+    T passbandRippleDb /* = IIRFILTERFACTORY_RIPPLE_DB */, 
+    T stopbandAttenuationDb /* = IIRFILTERFACTORY_ATTENUATION_DB */)
+{
+    double rippleDb = (prototype == IirPrototypeType::BUTTERWORTH) 
+        ? 10.0 * log10(2.0) : (double)passbandRippleDb;
+
+    return design(prototype, order, filterType, Fs, Fc1, Fc2, rippleDb, 
+                  stopbandAttenuationDb);
+}
+
+
+//! Create Filter - the minimum order design that meets the specification
+template <typename T>
+BasicBiquadCascadeType<T> BasicIirFilterFactory<T>::createFilter(
+    IirPrototypeType::Type prototype, 
+    const BasicFilterSpecificationType<T>& specification, 
+    BasicFilterResponseType<T>* response /* = NULL */, 
+    int maxOrder /* = IIRFILTERFACTORY_MAX_ORDER */)
+{
+    // Passband edges half a transition inside each cutoff
+    double halfWidth = 0.5 * specification.transitionWidth;
+    double Fp1 = specification.Fc1;
+    double Fp2 = specification.Fc2;
+
+    switch( specification.filterType )
+    {
+        case FilterType::LOWPASS:
+            Fp1 -= halfWidth;
+            break;
+        case FilterType::HIGHPASS:
+            Fp1 += halfWidth;
+            break;
+        case FilterType::BANDPASS:
+            Fp1 += halfWidth;
+            Fp2 -= halfWidth;
+            break;
+        case FilterType::BANDSTOP:
+            Fp1 -= halfWidth;
+            Fp2 += halfWidth;
+            break;
+        default:
+            break;
+    }
+
+    // The designs sit exactly on the ripple at the edge (and the elliptic 
+    // exactly on the attenuation across the stopband), so aim just inside
+    double rippleDb = 0.999 * specification.passbandRippleDb;
+    double attenuationDb = 1.001 * specification.stopbandAttenuationDb;
+
+    BasicBiquadCascadeType<T> cascade;
+    BasicFilterResponseType<T> achieved;
+    achieved.order = 0;
+    achieved.kaiserBeta = 0.0;
+    achieved.passbandRippleDb = 0.0;
+    achieved.stopbandAttenuationDb = 0.0;
+    achieved.meetsSpecification = false;
+
+    for( int order = 1; order <= maxOrder; order++ )
+    {
+        cascade = design(prototype, order, specification.filterType, 
+                         specification.Fs, Fp1, Fp2, rippleDb, attenuationDb);
+        achieved = measureResponse(cascade, specification);
+
+        if( achieved.meetsSpecification )
+        {
+            break;
+        }
+    }
+
+    if( response != NULL )
+    {
+        *response = achieved;
+    }
+
+    return cascade;
+}
+
+
+//! Magnitude Response - |H| from DC to Fs/2
+template <typename T>
+void BasicIirFilterFactory<T>::magnitudeResponse(const BasicBiquadCascadeType<T>& cascade, 
+    size_t pointCount, std::vector<double>& magnitude)
+{
+    magnitude.assign(pointCount, 1.0);
+
+    BasicBiquadCascadeType<double> sections(cascade);
+
+    for( size_t k = 0; k < pointCount; k++ )
+    {
+        double w = (pointCount > 1) ? M_PI * (double)k / (double)(pointCount - 1) : 0.0;
+
+        for( size_t s = 0; s < sections.sections.size(); s++ )
+        {
+            magnitude[k] *= sectionGain(sections.sections[s], w);
+        }
+    }
+}
+
+
+//! Measure Response - ripple and attenuation over the bands of a specification
+template <typename T>
+BasicFilterResponseType<T> BasicIirFilterFactory<T>::measureResponse(
+    const BasicBiquadCascadeType<T>& cascade, 
+    const BasicFilterSpecificationType<T>& specification)
+{
+    std::vector<double> magnitude;
+    magnitudeResponse(cascade, IIRFILTERFACTORY_RESPONSE_POINTS, magnitude);
+
+    return BasicFilterFactory<T>::measureMagnitude(&magnitude[0], magnitude.size(), 
+                                                   cascade.order, specification);
+}
+
+
+//! Design from passband edges in Hz
+template <typename T>
+BasicBiquadCascadeType<T> BasicIirFilterFactory<T>::design(IirPrototypeType::Type prototype, 
+    int order, FilterType::Type filterType, double Fs, double Fp1, double Fp2, 
+    double passbandRippleDb, double stopbandAttenuationDb)
+{
+    BasicBiquadCascadeType<T> result;
+
+    if( (order < 1) || (Fs <= 0.0) )
+    {
+        return result;
+    }
+
+    std::vector<Complex> zeros;
+    std::vector<Complex> poles;
+    double gain = createPrototype(prototype, order, passbandRippleDb, 
+                                  stopbandAttenuationDb, zeros, poles);
+
+    // Prewarped band edges
+    double fs2 = 2.0 * Fs;
+    double w1 = fs2 * tan(M_PI * Fp1 / Fs);
+    double w2 = fs2 * tan(M_PI * Fp2 / Fs);
+    double w0 = sqrt(fabs(w1 * w2));
+    double halfBandwidth = 0.5 * (w2 - w1);
+
+    // Zeros at infinity in the prototype
+    size_t infinite = poles.size() - zeros.size();
+
+    std::vector<Complex> analogZeros;
+    std::vector<Complex> analogPoles;
+
+    // Reference frequency (radians per sample) for the gain
+    double reference = 0.0;
+
+    switch( filterType )
+    {
+        case FilterType::HIGHPASS:
+            // s -> w1 / s, the zeros at infinity move to DC
+            for( size_t i = 0; i < zeros.size(); i++ )
+            {
+                analogZeros.push_back(w1 / zeros[i]);
+            }
+            for( size_t i = 0; i < poles.size(); i++ )
+            {
+                analogPoles.push_back(w1 / poles[i]);
+            }
+            analogZeros.insert(analogZeros.end(), infinite, Complex(0.0, 0.0));
+            reference = M_PI;
+            break;
+
+        case FilterType::BANDPASS:
+            // s -> (s^2 + w0^2) / (2.halfBandwidth.s) - each root splits in 
+            // two, the zeros at infinity go half to DC, half stay at infinity
+            for( size_t i = 0; i < zeros.size(); i++ )
+            {
+                Complex a = zeros[i] * halfBandwidth;
+                Complex b = std::sqrt(a * a - w0 * w0);
+                analogZeros.push_back(a + b);
+                analogZeros.push_back(a - b);
+            }
+            for( size_t i = 0; i < poles.size(); i++ )
+            {
+                Complex a = poles[i] * halfBandwidth;
+                Complex b = std::sqrt(a * a - w0 * w0);
+                analogPoles.push_back(a + b);
+                analogPoles.push_back(a - b);
+            }
+            analogZeros.insert(analogZeros.end(), infinite, Complex(0.0, 0.0));
+            reference = 2.0 * atan(w0 / fs2);
+            break;
+
+        case FilterType::BANDSTOP:
+            // s -> 2.halfBandwidth.s / (s^2 + w0^2) - the zeros at infinity 
+            // move to +-j.w0
+            for( size_t i = 0; i < zeros.size(); i++ )
+            {
+                Complex a = halfBandwidth / zeros[i];
+                Complex b = std::sqrt(a * a - w0 * w0);
+                analogZeros.push_back(a + b);
+                analogZeros.push_back(a - b);
+            }
+            for( size_t i = 0; i < poles.size(); i++ )
+            {
+                Complex a = halfBandwidth / poles[i];
+                Complex b = std::sqrt(a * a - w0 * w0);
+                analogPoles.push_back(a + b);
+                analogPoles.push_back(a - b);
+            }
+            for( size_t i = 0; i < infinite; i++ )
+            {
+                analogZeros.push_back(Complex(0.0, w0));
+                analogZeros.push_back(Complex(0.0, -w0));
+            }
+            reference = 0.0;
+            break;
+
+        case FilterType::LOWPASS:
+        default:
+            // s -> s / w1
+            for( size_t i = 0; i < zeros.size(); i++ )
+            {
+                analogZeros.push_back(zeros[i] * w1);
+            }
+            for( size_t i = 0; i < poles.size(); i++ )
+            {
+                analogPoles.push_back(poles[i] * w1);
+            }
+            reference = 0.0;
+            break;
+    }
+
+    // Bilinear transform - the remaining zeros at infinity go to z = -1
+    std::vector<Complex> digitalZeros;
+    std::vector<Complex> digitalPoles;
+    for( size_t i = 0; i < analogZeros.size(); i++ )
+    {
+        digitalZeros.push_back((fs2 + analogZeros[i]) / (fs2 - analogZeros[i]));
+    }
+    for( size_t i = 0; i < analogPoles.size(); i++ )
+    {
+        digitalPoles.push_back((fs2 + analogPoles[i]) / (fs2 - analogPoles[i]));
+    }
+    digitalZeros.insert(digitalZeros.end(), digitalPoles.size() - digitalZeros.size(), 
+                        Complex(-1.0, 0.0));
+
+    // Second order sections
+    std::vector<Complex> poleFirst;
+    std::vector<Complex> poleSecond;
+    std::vector<int> poleCount;
+    pairRoots(digitalPoles, poleFirst, poleSecond, poleCount);
+
+    std::vector<Complex> zeroFirst;
+    std::vector<Complex> zeroSecond;
+    std::vector<int> zeroCount;
+    pairRoots(digitalZeros, zeroFirst, zeroSecond, zeroCount);
+
+    std::vector<bool> used(zeroFirst.size(), false);
+
+    result.order = (int)digitalPoles.size();
+    result.sections.resize(poleFirst.size());
+
+    for( size_t s = 0; s < poleFirst.size(); s++ )
+    {
+        // Nearest unused zero group with the same number of roots if there
+        // is one, otherwise the nearest of any
+        size_t nearest = 0;
+        double nearestDistance = HUGE_VAL;
+        for( int pass = 0; (pass < 2) && (nearestDistance == HUGE_VAL); pass++ )
+        {
+            for( size_t z = 0; z < zeroFirst.size(); z++ )
+            {
+                if( used[z] || ((pass == 0) && (zeroCount[z] != poleCount[s])) )
+                {
+                    continue;
+                }
+
+                double distance = std::abs(zeroFirst[z] - poleFirst[s]);
+                if( distance < nearestDistance )
+                {
+                    nearestDistance = distance;
+                    nearest = z;
+                }
+            }
+        }
+        used[nearest] = true;
+
+        BasicBiquadType<double> section;
+        section.b0 = 1.0;
+        section.b1 = -std::real(zeroFirst[nearest] + zeroSecond[nearest]);
+        section.b2 = std::real(zeroFirst[nearest] * zeroSecond[nearest]);
+        section.a1 = -std::real(poleFirst[s] + poleSecond[s]);
+        section.a2 = std::real(poleFirst[s] * poleSecond[s]);
+
+        // Unit gain at the reference, the prototype's gain on the first
+        double scale = 1.0 / sectionGain(section, reference);
+        if( s == 0 )
+        {
+            scale *= gain;
+        }
+
+        result.sections[s].b0 = (T)(section.b0 * scale);
+        result.sections[s].b1 = (T)(section.b1 * scale);
+        result.sections[s].b2 = (T)(section.b2 * scale);
+        result.sections[s].a1 = (T)section.a1;
+        result.sections[s].a2 = (T)section.a2;
+    }
+
+    return result;
+}
+
+
+//! Normalised lowpass prototype - returns the gain at DC
+template <typename T>
+double BasicIirFilterFactory<T>::createPrototype(IirPrototypeType::Type prototype, 
+    int order, double passbandRippleDb, double stopbandAttenuationDb, 
+    std::vector<Complex>& zeros, std::vector<Complex>& poles)
+{
+    zeros.clear();
+    poles.clear();
+
+    double epsilon = sqrt(pow(10.0, 0.1 * passbandRippleDb) - 1.0);
+    double dcGain = 1.0;
+
+    switch( prototype )
+    {
+        case IirPrototypeType::CHEBYSHEV:
+        {
+            double mu = log(1.0 / epsilon + sqrt(1.0 / (epsilon * epsilon) + 1.0)) 
+                / (double)order;
+            for( int k = 0; k < order; k++ )
+            {
+                double theta = M_PI * (double)(2 * k + 1) / (double)(2 * order);
+                poles.push_back(Complex(-sinh(mu) * sin(theta), cosh(mu) * cos(theta)));
+            }
+
+            // Even orders start at the bottom of the ripple
+            if( (order % 2) == 0 )
+            {
+                dcGain = 1.0 / sqrt(1.0 + epsilon * epsilon);
+            }
+            break;
+        }
+
+        case IirPrototypeType::ELLIPTIC:
+        {
+            // Selectivity k from the discrimination k1 by the degree equation
+            double epsilonStop = sqrt(pow(10.0, 0.1 * stopbandAttenuationDb) - 1.0);
+            double k1 = epsilon / epsilonStop;
+            double k1Prime = sqrt(1.0 - k1 * k1);
+
+            int pairs = order / 2;
+            double kPrime = pow(k1Prime, (double)order);
+            for( int i = 1; i <= pairs; i++ )
+            {
+                double u = (double)(2 * i - 1) / (double)order;
+                kPrime *= pow(std::real(sne(Complex(u, 0.0), k1Prime)), 4.0);
+            }
+            double k = sqrt(1.0 - kPrime * kPrime);
+
+            // Poles from the line Im(u) = v0
+            double v0 = std::real(Complex(0.0, -1.0) 
+                * asne(Complex(0.0, 1.0 / epsilon), k1)) / (double)order;
+
+            for( int i = 1; i <= pairs; i++ )
+            {
+                double u = (double)(2 * i - 1) / (double)order;
+                Complex zeta = cde(Complex(u, 0.0), k);
+                Complex zero = Complex(0.0, 1.0) / (k * zeta);
+                zeros.push_back(zero);
+                zeros.push_back(std::conj(zero));
+
+                Complex pole = Complex(0.0, 1.0) * cde(Complex(u, -v0), k);
+                poles.push_back(pole);
+                poles.push_back(std::conj(pole));
+            }
+
+            if( (order % 2) == 1 )
+            {
+                poles.push_back(Complex(0.0, 1.0) * sne(Complex(0.0, v0), k));
+            }
+            else
+            {
+                dcGain = 1.0 / sqrt(1.0 + epsilon * epsilon);
+            }
+            break;
+        }
+
+        case IirPrototypeType::BUTTERWORTH:
+        default:
+        {
+            // On a circle of radius epsilon^(-1/order), so that the gain at 
+            // 1 rad/s is down by the ripple
+            double radius = pow(epsilon, -1.0 / (double)order);
+            for( int k = 0; k < order; k++ )
+            {
+                double theta = M_PI * (double)(2 * k + order + 1) / (double)(2 * order);
+                poles.push_back(std::polar(radius, theta));
+            }
+            break;
+        }
+    }
+
+    return dcGain;
+}
+
+
+//! Pair roots into quadratics
+template <typename T>
+void BasicIirFilterFactory<T>::pairRoots(const std::vector<Complex>& roots, 
+    std::vector<Complex>& first, std::vector<Complex>& second, 
+    std::vector<int>& rootCount)
+{
+    // Roots this close to the real axis are treated as real
+    const double tolerance = 1e-10;
+
+    std::vector< std::pair<double, Complex> > complexRoots;
+    std::vector<double> realRoots;
+
+    for( size_t i = 0; i < roots.size(); i++ )
+    {
+        if( fabs(std::imag(roots[i])) <= tolerance * (1.0 + std::abs(roots[i])) )
+        {
+            realRoots.push_back(std::real(roots[i]));
+        }
+        else if( std::imag(roots[i]) > 0.0 )
+        {
+            // One of each conjugate pair, keyed by distance from the circle
+            complexRoots.push_back(std::make_pair(fabs(1.0 - std::abs(roots[i])), roots[i]));
+        }
+    }
+
+    // Furthest from the unit circle first
+    std::sort(complexRoots.begin(), complexRoots.end(), furtherFromCircle);
+    std::sort(realRoots.begin(), realRoots.end());
+
+    first.clear();
+    second.clear();
+    rootCount.clear();
+
+    for( size_t i = 0; i < realRoots.size(); i += 2 )
+    {
+        first.push_back(Complex(realRoots[i], 0.0));
+        if( i + 1 < realRoots.size() )
+        {
+            second.push_back(Complex(realRoots[i + 1], 0.0));
+            rootCount.push_back(2);
+        }
+        else
+        {
+            second.push_back(Complex(0.0, 0.0));
+            rootCount.push_back(1);
+        }
+    }
+
+    for( size_t i = 0; i < complexRoots.size(); i++ )
+    {
+        first.push_back(complexRoots[i].second);
+        second.push_back(std::conj(complexRoots[i].second));
+        rootCount.push_back(2);
+    }
+}
+
+
+//! Gain of one section at z = exp(j.w)
+template <typename T>
+double BasicIirFilterFactory<T>::sectionGain(const BasicBiquadType<double>& section, double w)
+{
+    Complex z1 = std::polar(1.0, -w);
+    Complex z2 = z1 * z1;
+
+    Complex numerator = section.b0 + section.b1 * z1 + section.b2 * z2;
+    Complex denominator = 1.0 + section.a1 * z1 + section.a2 * z2;
+
+    return std::abs(numerator / denominator);
+}
+
+
+//! Descending Landen sequence of moduli
+template <typename T>
+void BasicIirFilterFactory<T>::landen(double k, double * sequence)
+{
+    for( int n = 0; n < IIRFILTERFACTORY_LANDEN_STEPS; n++ )
+    {
+        double kPrime = sqrt(1.0 - k * k);
+        k = (k / (1.0 + kPrime)) * (k / (1.0 + kPrime));
+        sequence[n] = k;
+    }
+}
+
+
+//! Jacobi cd(u.K, k) of a complex argument
+template <typename T>
+typename BasicIirFilterFactory<T>::Complex BasicIirFilterFactory<T>::cde(Complex u, double k)
+{
+    double sequence[IIRFILTERFACTORY_LANDEN_STEPS];
+    landen(k, sequence);
+
+    Complex w = std::cos(u * (M_PI / 2.0));
+    for( int n = IIRFILTERFACTORY_LANDEN_STEPS - 1; n >= 0; n-- )
+    {
+        w = (1.0 + sequence[n]) * w / (1.0 + sequence[n] * w * w);
+    }
+
+    return w;
+}
+
+
+//! Jacobi sn(u.K, k) of a complex argument
+template <typename T>
+typename BasicIirFilterFactory<T>::Complex BasicIirFilterFactory<T>::sne(Complex u, double k)
+{
+    double sequence[IIRFILTERFACTORY_LANDEN_STEPS];
+    landen(k, sequence);
+
+    Complex w = std::sin(u * (M_PI / 2.0));
+    for( int n = IIRFILTERFACTORY_LANDEN_STEPS - 1; n >= 0; n-- )
+    {
+        w = (1.0 + sequence[n]) * w / (1.0 + sequence[n] * w * w);
+    }
+
+    return w;
+}
+
+
+//! Inverse of sn, in units of K - asne(w) = 1 - acde(w)
+template <typename T>
+typename BasicIirFilterFactory<T>::Complex BasicIirFilterFactory<T>::asne(Complex w, double k)
+{
+    double sequence[IIRFILTERFACTORY_LANDEN_STEPS];
+    landen(k, sequence);
+
+    double previous = k;
+    for( int n = 0; n < IIRFILTERFACTORY_LANDEN_STEPS; n++ )
+    {
+        w = w / (1.0 + std::sqrt(1.0 - w * w * (previous * previous))) 
+            * (2.0 / (1.0 + sequence[n]));
+        previous = sequence[n];
+    }
+
+    return 1.0 - arcCos(w) * (2.0 / M_PI);
+}
+
+
+//! Complex arc cosine - acos(w) = -j.log(w + j.sqrt(1 - w^2))
+template <typename T>
+typename BasicIirFilterFactory<T>::Complex BasicIirFilterFactory<T>::arcCos(Complex w)
+{
+    return Complex(0.0, -1.0) * std::log(w + Complex(0.0, 1.0) * std::sqrt(1.0 - w * w));
+}
+
+
+#endif // IIRFILTERFACTORY_H
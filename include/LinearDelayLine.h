@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// LinearDelayLine.h
+//
+//------------------------------------------------------------------------------
+//
+// A delay line with the same interface as MirroredDelayLine (data() is the
+// whole line, oldest first, in contiguous memory) in N+B samples rather than
+// 2N. Appends are a single store to the end of a linear buffer. Once B 
+// samples have been appended the line is moved back to the start in one 
+// copy, so each append costs one store plus N/B samples of copying on 
+// average, against two stores for the mirrored layout.
+//
+// A small block length B saves memory on long lines at the price of more 
+// copying; B = N copies about one sample per append in the same memory as 
+// the mirrored layout. FirFilter takes either as its delay line type.
+//
+// The buffer comes from the Allocator, as for MirroredDelayLine.
+//
+//------------------------------------------------------------------------------
+
+#ifndef LINEARDELAYLINE_H
+#define LINEARDELAYLINE_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "AlignedAllocator.h"
+
+//! Default appends between copies
+#define LINEARDELAYLINE_DEFAULT_BLOCK 1024
+
+
+template <typename DataType, typename Allocator = AlignedAllocator<DataType> >
+class LinearDelayLine
+{
+public:
+
+    //! Constructor 
+    //! delayLineLength = the length of the delay line
+    //! clearValue = the value to initialise the contents to.
+    //! blockLength = appends between copies (at least 1)
+    LinearDelayLine(size_t delayLineLength, const DataType& clearValue = DataType(), 
+                    size_t blockLength = LINEARDELAYLINE_DEFAULT_BLOCK);
+    
+    //! Copy Constructor - a new delay line with the same contents
+    LinearDelayLine(const LinearDelayLine& other);
+
+    //! Assignment - takes the length and contents of other
+    LinearDelayLine& operator=(const LinearDelayLine& other);
+
+    //! Destructor
+    virtual ~LinearDelayLine();
+    
+    //! Clear the delay line
+    //! clearValue = the value to initialise the contents to.
+    void clear(const DataType& clearValue);
+    
+    //! Get the length of the delay line
+    size_t length();
+
+    //! Get the block length - appends between copies
+    size_t blockLength();
+    
+    //! Get a pointer to the current head of the delay line
+    const DataType * const data();
+    
+    //! Append data to end of delay line (and lose the first item)
+    void append(const DataType &data);
+    
+    //! Array Subscript Operator Overload
+    const DataType& operator[](size_t index);
+    
+    //! Debug: Print the contents to std::cout 
+    void debug_printContents();
+    
+protected:
+
+private:	
+    //! Move the line back to the start of the storage
+    void rewind();
+
+    //! Usable Delay Line Length
+    size_t m_delayLineLength;
+
+    //! Appends between copies
+    size_t m_blockLength;
+    
+    //! Storage Vector - delayLineLength + blockLength
+    std::vector<DataType, Allocator> m_storage;
+
+    //! Start of m_storage
+    DataType * m_data;
+    
+    //! Index of the oldest sample
+    size_t m_index;
+
+}; // class LinearDelayLine
+
+
+//! Constructor
+template <typename DataType, typename Allocator>
+LinearDelayLine<DataType, Allocator>::LinearDelayLine(size_t delayLineLength, 
+    const DataType& clearValue /* = DataType() */, 
+    size_t blockLength /* = LINEARDELAYLINE_DEFAULT_BLOCK */)
+    : m_delayLineLength(delayLineLength), m_blockLength((blockLength > 0) ? blockLength : 1), 
+      m_storage(m_delayLineLength + m_blockLength, clearValue), 
+      m_data(&m_storage[0]), m_index(0)
+{
+}
+
+
+//! Copy Constructor - a new delay line with the same contents
+template <typename DataType, typename Allocator>
+LinearDelayLine<DataType, Allocator>::LinearDelayLine(const LinearDelayLine& other)
+    : m_delayLineLength(other.m_delayLineLength), m_blockLength(other.m_blockLength), 
+      m_storage(other.m_storage), m_data(&m_storage[0]), m_index(other.m_index)
+{
+}
+
+
+//! Assignment - takes the length and contents of other
+template <typename DataType, typename Allocator>
+LinearDelayLine<DataType, Allocator>& LinearDelayLine<DataType, Allocator>::operator=(const LinearDelayLine& other)
+{
+    m_delayLineLength = other.m_delayLineLength;
+    m_blockLength = other.m_blockLength;
+    m_storage = other.m_storage;
+    m_data = &m_storage[0];
+    m_index = other.m_index;
+
+    return *this;
+}
+
+
+//! Destructor
+template <typename DataType, typename Allocator>
+LinearDelayLine<DataType, Allocator>::~LinearDelayLine() 
+{
+}
+
+
+//! Clear the delay line
+template <typename DataType, typename Allocator>
+void LinearDelayLine<DataType, Allocator>::clear(const DataType& clearValue) 
+{
+    m_index = 0;
+    std::fill(m_storage.begin(), m_storage.end(), clearValue);
+}
+
+
+//! Get the length of the delay line
+template <typename DataType, typename Allocator>
+size_t LinearDelayLine<DataType, Allocator>::length()
+{
+    return m_delayLineLength;
+}
+
+
+//! Get the block length - appends between copies
+template <typename DataType, typename Allocator>
+size_t LinearDelayLine<DataType, Allocator>::blockLength()
+{
+    return m_blockLength;
+}
+
+
+//! Get a pointer to the current head of the delay line
+template <typename DataType, typename Allocator>
+const DataType * const LinearDelayLine<DataType, Allocator>::data()
+{
+    return m_data + m_index;
+}
+
+
+//! Append data to end of delay line (and lose the first item)
+template <typename DataType, typename Allocator>
+void LinearDelayLine<DataType, Allocator>::append(const DataType &data)
+{
+    if( m_index == m_blockLength )
+    {
+        rewind();
+    }
+
+    m_data[m_index + m_delayLineLength] = data;
+    m_index++;
+}
+
+
+//! Array Subscript Operator Overload - read only
+template <typename DataType, typename Allocator>
+const DataType& LinearDelayLine<DataType, Allocator>::operator[](size_t index)
+{
+    return m_data[index + m_index];
+}
+
+
+//! Debug: Print the contents to std::cout 
+template <typename DataType, typename Allocator>
+void LinearDelayLine<DataType, Allocator>::debug_printContents()
+{
+    std::cout << "[";
+    
+    for( size_t i = 0; i < m_delayLineLength; i++ )
+    {
+        std::cout << m_data[m_index+i];
+        
+        if( i < (m_delayLineLength-1) )
+        {
+            std::cout << ", ";
+        }
+    }
+    
+    std::cout << "]" << std::endl;
+}
+
+
+//! Move the line back to the start of the storage - kept out of append() 
+//! so that append() stays small enough to inline
+template <typename DataType, typename Allocator>
+void LinearDelayLine<DataType, Allocator>::rewind()
+{
+    std::copy(m_data + m_index, m_data + m_index + m_delayLineLength, m_data);
+    m_index = 0;
+}
+
+
+#endif // LINEARDELAYLINE_H
@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// MinimumPhase.h
+//
+//------------------------------------------------------------------------------
+//
+// Converts a FilterFactory design to the minimum-phase filter with the same
+// magnitude response, for paths that cannot wait order/2 samples for the 
+// linear-phase delay.
+//
+// The conversion is the homomorphic (cepstral) method. The real cepstrum of
+// h, c = IFFT(log|H|), is even; the minimum-phase filter has the causal 
+// cepstrum 
+//   c_min[0] = c[0], c_min[n] = 2c[n] for 0 < n < N/2, c_min[N/2] = c[N/2]
+// so H_min = exp(FFT(c_min)) and h_min = IFFT(H_min). The energy of h_min is
+// packed at the front of the impulse response.
+// https://en.wikipedia.org/wiki/Minimum_phase
+// Oppenheim and Schafer, Discrete-Time Signal Processing, ch. 13
+//
+// The cepstrum is aliased by the finite FFT, so the transform is 
+// MINIMUMPHASE_OVERSAMPLE times the filter length, and the magnitude is 
+// floored MINIMUMPHASE_FLOOR_DB below its peak so that the exact zeros of a
+// stopband do not take log(0). The result is cut back to the original 
+// number of taps.
+//
+// The report compares the two: group delay in the passband, where the energy
+// is, and how closely the magnitude was kept.
+//
+//------------------------------------------------------------------------------
+
+#ifndef MINIMUMPHASE_H
+#define MINIMUMPHASE_H
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Fft.h"
+#include "FilterAnalysis.h"
+#include "FilterFactory.h"
+
+//! Transform length as a multiple of the filter length
+#define MINIMUMPHASE_OVERSAMPLE 16
+
+//! Magnitude floor below the peak, in dB, before taking the log
+#define MINIMUMPHASE_FLOOR_DB 200.0
+
+//! Band below the peak, in dB, over which the magnitude error is reported
+#define MINIMUMPHASE_REPORT_RANGE_DB 60.0
+
+
+//! Minimum Phase Report struct - latencies in samples, and in seconds where
+//! a sample rate was given
+struct MinimumPhaseReportType
+{
+    double linearPhaseDelay;      //!< order/2 - the delay of the original design
+    double groupDelay;            //!< Of the minimum-phase filter, at its peak gain
+    double groupDelaySeconds;     //!< groupDelay / Fs, 0 if Fs was not given
+    size_t peakIndex;             //!< Tap with the largest magnitude
+    size_t energyIndex;           //!< Taps holding 99% of the energy
+    double magnitudeErrorDb;      //!< Largest |dB| difference within 
+                                  //!< MINIMUMPHASE_REPORT_RANGE_DB of the peak
+};
+
+
+template <typename T>
+class MinimumPhase
+{
+public:
+    //! Convert - the minimum-phase filter with the magnitude response of 
+    //! filter and the same number of taps. A report is written if given; Fs 
+    //! is only used for the latencies in seconds.
+    static BasicFilterHolderType<T> convert(const BasicFilterHolderType<T>& filter, 
+        MinimumPhaseReportType * report = NULL, double Fs = 0.0);
+
+    //! Report - compare a design and its minimum-phase version
+    static MinimumPhaseReportType createReport(const BasicFilterHolderType<T>& original, 
+        const BasicFilterHolderType<T>& minimumPhase, double Fs = 0.0);
+
+}; // class MinimumPhase
+
+
+//! Convert - the minimum-phase filter with the magnitude response of filter
+template <typename T>
+BasicFilterHolderType<T> MinimumPhase<T>::convert(const BasicFilterHolderType<T>& filter, 
+    MinimumPhaseReportType * report /* = NULL */, double Fs /* = 0.0 */)
+{
+    size_t length = filter.coefficients.size();
+
+    BasicFilterHolderType<T> result;
+    result.order = filter.order;
+    result.coefficients.assign(length, T(0));
+
+    if( length == 0 )
+    {
+        return result;
+    }
+
+    Fft<double> fft(MINIMUMPHASE_OVERSAMPLE * length);
+    size_t size = fft.size();
+    size_t bins = fft.spectrumSize();
+
+    std::vector<double> samples(size, 0.0);
+    std::vector<double> real(bins);
+    std::vector<double> imag(bins);
+
+    for( size_t n = 0; n < length; n++ )
+    {
+        samples[n] = (double)filter.coefficients[n];
+    }
+    fft.forward(&samples[0], &real[0], &imag[0]);
+
+    // log|H|, floored below the peak
+    double peak = 0.0;
+    for( size_t k = 0; k < bins; k++ )
+    {
+        real[k] = sqrt( real[k] * real[k] + imag[k] * imag[k] );
+        peak = (real[k] > peak) ? real[k] : peak;
+    }
+
+    double floor = peak * pow(10.0, -MINIMUMPHASE_FLOOR_DB / 20.0);
+    if( floor <= 0.0 )
+    {
+        // All zero - nothing to move
+        return result;
+    }
+
+    for( size_t k = 0; k < bins; k++ )
+    {
+        real[k] = log( (real[k] > floor) ? real[k] : floor );
+        imag[k] = 0.0;
+    }
+
+    // Real cepstrum, folded onto the causal side
+    fft.inverse(&real[0], &imag[0], &samples[0]);
+
+    for( size_t n = 1; n < size / 2; n++ )
+    {
+        samples[n] *= 2.0;
+    }
+    for( size_t n = size / 2 + 1; n < size; n++ )
+    {
+        samples[n] = 0.0;
+    }
+
+    // H_min = exp(FFT(c_min))
+    fft.forward(&samples[0], &real[0], &imag[0]);
+
+    for( size_t k = 0; k < bins; k++ )
+    {
+        double magnitude = exp(real[k]);
+        double phase = imag[k];
+        real[k] = magnitude * cos(phase);
+        imag[k] = magnitude * sin(phase);
+    }
+
+    fft.inverse(&real[0], &imag[0], &samples[0]);
+
+    for( size_t n = 0; n < length; n++ )
+    {
+        result.coefficients[n] = (T)samples[n];
+    }
+
+    if( report != NULL )
+    {
+        *report = createReport(filter, result, Fs);
+    }
+
+    return result;
+}
+
+
+//! Report - compare a design and its minimum-phase version
+template <typename T>
+MinimumPhaseReportType MinimumPhase<T>::createReport(const BasicFilterHolderType<T>& original, 
+    const BasicFilterHolderType<T>& minimumPhase, double Fs /* = 0.0 */)
+{
+    MinimumPhaseReportType report;
+    report.linearPhaseDelay = 0.5 * (double)original.order;
+    report.groupDelay = 0.0;
+    report.groupDelaySeconds = 0.0;
+    report.peakIndex = 0;
+    report.energyIndex = 0;
+    report.magnitudeErrorDb = 0.0;
+
+    // Where the energy is in the impulse response
+    size_t length = minimumPhase.coefficients.size();
+    double totalEnergy = 0.0;
+    double largest = 0.0;
+    for( size_t n = 0; n < length; n++ )
+    {
+        double value = (double)minimumPhase.coefficients[n];
+        totalEnergy += value * value;
+
+        if( fabs(value) > largest )
+        {
+            largest = fabs(value);
+            report.peakIndex = n;
+        }
+    }
+
+    double energy = 0.0;
+    for( size_t n = 0; n < length; n++ )
+    {
+        double value = (double)minimumPhase.coefficients[n];
+        energy += value * value;
+
+        if( energy >= 0.99 * totalEnergy )
+        {
+            report.energyIndex = n + 1;
+            break;
+        }
+    }
+
+    // Group delay at the peak gain, and the magnitude error near it
+    FilterAnalysis<double> analysis;
+    FrequencyResponseType<double> originalResponse;
+    FrequencyResponseType<double> minimumResponse;
+    analysis.frequencyResponse(BasicFilterHolderType<double>(original), 1.0, originalResponse);
+    analysis.frequencyResponse(BasicFilterHolderType<double>(minimumPhase), 1.0, minimumResponse);
+
+    size_t bins = originalResponse.magnitude.size();
+    size_t peakBin = 0;
+    for( size_t k = 0; k < bins; k++ )
+    {
+        if( originalResponse.magnitude[k] > originalResponse.magnitude[peakBin] )
+        {
+            peakBin = k;
+        }
+    }
+
+    report.groupDelay = minimumResponse.groupDelay[peakBin];
+    report.groupDelaySeconds = (Fs > 0.0) ? (report.groupDelay / Fs) : 0.0;
+
+    double threshold = originalResponse.magnitude[peakBin] 
+        * pow(10.0, -MINIMUMPHASE_REPORT_RANGE_DB / 20.0);
+    for( size_t k = 0; k < bins; k++ )
+    {
+        if( (originalResponse.magnitude[k] >= threshold) && (minimumResponse.magnitude[k] > 0.0) )
+        {
+            double error = fabs( 20.0 * log10(minimumResponse.magnitude[k] / originalResponse.magnitude[k]) );
+            report.magnitudeErrorDb = (error > report.magnitudeErrorDb) ? error : report.magnitudeErrorDb;
+        }
+    }
+
+    return report;
+}
+
+
+#endif // MINIMUMPHASE_H
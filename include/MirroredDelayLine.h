@@ -37,16 +37,97 @@
 // https://fgiesen.wordpress.com/2012/07/21/the-magic-ring-buffer/
 // 
 //------------------------------------------------------------------------------
+//
+// On Linux, when the delay line is a whole number of pages long, the mapped 
+// memory version is used instead: the pages of one memfd are mapped twice, 
+// back to back, so each append is a single store that shows up in both 
+// halves, and only one copy is resident. Other lengths (see pageLength()), 
+// other platforms, or a failed mapping fall back to the copy in a vector. 
+// isMapped() tells which one is in use. As the mapped elements are never 
+// constructed, only types marked plain data by MirroredDelayLinePlainData 
+// (the arithmetic types and their std::complex) are mapped; specialise it 
+// for other plain types.
+//
+//------------------------------------------------------------------------------
+//
+// The vector comes from the Allocator, by default an AlignedAllocator so the
+// storage starts on a 64 byte boundary. Only the default allocator uses the
+// mapped version; any other Allocator always gets the vector, so e.g. 
+// HugePageAllocator backs long lines with huge pages (see AlignedAllocator.h)
+// at the cost of the second copy.
+//
+//------------------------------------------------------------------------------
 
 #ifndef MIRROREDDELAYLINE_H
 #define MIRROREDDELAYLINE_H
 
+#include <algorithm>
+#include <complex>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <vector>
 
+#include "AlignedAllocator.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+#define MIRROREDDELAYLINE_MEMFD 1
+#else
+#define MIRROREDDELAYLINE_MEMFD 0
+#endif
+
+//! Plain Data trait - true for types that can be used without construction
 template <typename DataType>
+struct MirroredDelayLinePlainData
+{
+    static const bool value = false;
+};
+
+#define MIRROREDDELAYLINE_PLAIN_DATA(Type) \
+    template <> struct MirroredDelayLinePlainData<Type> { static const bool value = true; };
+
+MIRROREDDELAYLINE_PLAIN_DATA(bool)
+MIRROREDDELAYLINE_PLAIN_DATA(char)
+MIRROREDDELAYLINE_PLAIN_DATA(signed char)
+MIRROREDDELAYLINE_PLAIN_DATA(unsigned char)
+MIRROREDDELAYLINE_PLAIN_DATA(wchar_t)
+MIRROREDDELAYLINE_PLAIN_DATA(short)
+MIRROREDDELAYLINE_PLAIN_DATA(unsigned short)
+MIRROREDDELAYLINE_PLAIN_DATA(int)
+MIRROREDDELAYLINE_PLAIN_DATA(unsigned int)
+MIRROREDDELAYLINE_PLAIN_DATA(long)
+MIRROREDDELAYLINE_PLAIN_DATA(unsigned long)
+MIRROREDDELAYLINE_PLAIN_DATA(long long)
+MIRROREDDELAYLINE_PLAIN_DATA(unsigned long long)
+MIRROREDDELAYLINE_PLAIN_DATA(float)
+MIRROREDDELAYLINE_PLAIN_DATA(double)
+MIRROREDDELAYLINE_PLAIN_DATA(long double)
+MIRROREDDELAYLINE_PLAIN_DATA(std::complex<float>)
+MIRROREDDELAYLINE_PLAIN_DATA(std::complex<double>)
+MIRROREDDELAYLINE_PLAIN_DATA(std::complex<long double>)
+
+
+//! Same Type trait - the mapped version is only for the default allocator
+template <typename A, typename B>
+struct MirroredDelayLineSameType
+{
+    static const bool value = false;
+};
+
+template <typename A>
+struct MirroredDelayLineSameType<A, A>
+{
+    static const bool value = true;
+};
+
+
+template <typename DataType, typename Allocator = AlignedAllocator<DataType> >
 class MirroredDelayLine
 {
 public:
@@ -60,6 +141,12 @@ public:
     //! clearValue = the value to initialise the contents to.
     MirroredDelayLine(size_t delayLineLength, const DataType& clearValue);
     
+    //! Copy Constructor - a new delay line with the same contents
+    MirroredDelayLine(const MirroredDelayLine& other);
+
+    //! Assignment - takes the length and contents of other
+    MirroredDelayLine& operator=(const MirroredDelayLine& other);
+
     //! Destructor
     virtual ~MirroredDelayLine();
     
@@ -75,10 +162,24 @@ public:
     
     //! Append data to end of delay line (and lose the first item)
     void append(const DataType &data);
+
+    //! Append a block of data to the end of the delay line (and lose the 
+    //! first length items). Only the last length() items are kept if length
+    //! is longer than the delay line. data() is then the window ending at 
+    //! data[length-1], e.g. for the next output of a decimating FIR.
+    void appendBlock(const DataType * const data, size_t length);
     
     //! Array Subscript Operator Overload
     const DataType& operator[](size_t index);
     
+    //! Is Mapped - true if the halves are one set of pages mapped twice
+    bool isMapped() const;
+
+    //! Page Length - delay lines a multiple of this long can be mapped 
+    //! (0 if the mapped version is not available on this platform, for this
+    //! type, or with this Allocator)
+    static size_t pageLength();
+
 
     //! Debug: Print the contents to std::cout 
     void debug_printContents();
@@ -86,14 +187,26 @@ public:
 protected:
 
 private:	
+    //! Allocate the storage for m_delayLineLength, mapped if possible
+    void allocate();
+
+    //! Release the storage
+    void release();
+
     //! Usable Delay Line Length
     size_t m_delayLineLength;
     
     //! Total Storage Length
     size_t m_totalStorageLength;
 	
-    //! Storage Vector
-    std::vector<DataType> m_storage;
+    //! Storage Vector - empty when mapped
+    std::vector<DataType, Allocator> m_storage;
+    
+    //! Start of the 2 * m_delayLineLength elements, in m_storage or mapped
+    DataType * m_data;
+
+    //! Storage is mapped
+    bool m_mapped;
     
     //! Index 
     size_t m_index;
@@ -102,64 +215,104 @@ private:
 
 
 //! Constructor
-template <typename DataType>
-MirroredDelayLine<DataType>::MirroredDelayLine(size_t delayLineLength)
+template <typename DataType, typename Allocator>
+MirroredDelayLine<DataType, Allocator>::MirroredDelayLine(size_t delayLineLength)
     : m_delayLineLength(delayLineLength), m_totalStorageLength(2*m_delayLineLength), 
-      m_storage(m_totalStorageLength), m_index(0)
+      m_data(NULL), m_mapped(false), m_index(0)
 {
+    allocate();
+    clear(DataType());
 }
 
 
 //! Constructor 
 //! delayLineLength = the length of the delay line.
 //! clearValue = the value to initialise the contents to.
-template <typename DataType>
-MirroredDelayLine<DataType>::MirroredDelayLine(size_t delayLineLength, const DataType& clearValue)
+template <typename DataType, typename Allocator>
+MirroredDelayLine<DataType, Allocator>::MirroredDelayLine(size_t delayLineLength, const DataType& clearValue)
     : m_delayLineLength(delayLineLength), m_totalStorageLength(2*m_delayLineLength), 
-      m_storage(m_totalStorageLength, clearValue), m_index(0)
+      m_data(NULL), m_mapped(false), m_index(0)
+{
+    allocate();
+    clear(clearValue);
+}
+
+
+//! Copy Constructor - a new delay line with the same contents
+template <typename DataType, typename Allocator>
+MirroredDelayLine<DataType, Allocator>::MirroredDelayLine(const MirroredDelayLine& other)
+    : m_delayLineLength(other.m_delayLineLength), m_totalStorageLength(other.m_totalStorageLength), 
+      m_data(NULL), m_mapped(false), m_index(other.m_index)
 {
+    allocate();
+    std::copy(other.m_data, other.m_data + m_totalStorageLength, m_data);
+}
+
+
+//! Assignment - takes the length and contents of other
+template <typename DataType, typename Allocator>
+MirroredDelayLine<DataType, Allocator>& MirroredDelayLine<DataType, Allocator>::operator=(const MirroredDelayLine& other)
+{
+    if( this != &other )
+    {
+        release();
+        m_delayLineLength = other.m_delayLineLength;
+        m_totalStorageLength = other.m_totalStorageLength;
+        m_index = other.m_index;
+        allocate();
+        std::copy(other.m_data, other.m_data + m_totalStorageLength, m_data);
+    }
+
+    return *this;
 }
 
 
 //! Destructor
-template <typename DataType>
-MirroredDelayLine<DataType>::~MirroredDelayLine() 
+template <typename DataType, typename Allocator>
+MirroredDelayLine<DataType, Allocator>::~MirroredDelayLine() 
 {
+    release();
 }
 
 
 //! Clear the delay line
 //! clearValue = the value to initialise the contents to.
-template <typename DataType>
-void MirroredDelayLine<DataType>::clear(const DataType& clearValue) 
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::clear(const DataType& clearValue) 
 {
     m_index = 0;
-    memset(&m_storage[0], clearValue, m_totalStorageLength*sizeof(DataType));
+
+    // Mapped, the second half is the first
+    std::fill(m_data, m_data + (m_mapped ? m_delayLineLength : m_totalStorageLength), 
+              clearValue);
 }
 
 
 //! Get the length of the delay line
-template <typename DataType>
-size_t MirroredDelayLine<DataType>::length()
+template <typename DataType, typename Allocator>
+size_t MirroredDelayLine<DataType, Allocator>::length()
 {
     return m_delayLineLength;
 }
 
 
 //! Get a pointer to the current head of the  delay line
-template <typename DataType>
-const DataType * const MirroredDelayLine<DataType>::data()
+template <typename DataType, typename Allocator>
+const DataType * const MirroredDelayLine<DataType, Allocator>::data()
 {
-    return &m_storage[m_index];
+    return m_data + m_index;
 }
 
 
 //! Append data to end of delay line (and lose the first item)
-template <typename DataType>
-void MirroredDelayLine<DataType>::append(const DataType &data)
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::append(const DataType &data)
 {
-    m_storage[m_index] = data;
-    m_storage[m_index+m_delayLineLength] = data;
+    m_data[m_index] = data;
+    if( !m_mapped )
+    {
+        m_data[m_index+m_delayLineLength] = data;
+    }
     
     m_index++;
     if( m_index == m_delayLineLength )
@@ -170,23 +323,102 @@ void MirroredDelayLine<DataType>::append(const DataType &data)
 }
 
 
+//! Append a block of data to the end of delay line (and lose the first length items)
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::appendBlock(const DataType * const data, size_t length)
+{
+    const DataType * source = data;
+    size_t count = length;
+
+    if( count >= m_delayLineLength )
+    {
+        // Only the tail survives
+        source = data + (count - m_delayLineLength);
+        count = m_delayLineLength;
+        m_index = 0;
+    }
+
+    if( count == 0 )
+    {
+        return;
+    }
+
+    if( m_mapped )
+    {
+        // One write covers both halves, and runs on into the second half 
+        // rather than wrapping
+        memcpy(m_data + m_index, source, count * sizeof(DataType));
+    }
+    else
+    {
+        // Up to the end of the first half, then the rest from the start - 
+        // each written to both halves. std::copy is a memmove for plain data
+        // and assigns any other type.
+        size_t first = m_delayLineLength - m_index;
+        first = (count < first) ? count : first;
+        size_t second = count - first;
+
+        std::copy(source, source + first, m_data + m_index);
+        std::copy(source, source + first, m_data + m_index + m_delayLineLength);
+
+        if( second > 0 )
+        {
+            std::copy(source + first, source + count, m_data);
+            std::copy(source + first, source + count, m_data + m_delayLineLength);
+        }
+    }
+
+    m_index += count;
+    if( m_index >= m_delayLineLength )
+    {
+        // Wrap around
+        m_index -= m_delayLineLength;
+    }
+}
+
+
 //! Array Subscript Operator Overload - read only
-template <typename DataType>
-const DataType& MirroredDelayLine<DataType>::operator[](size_t index)
+template <typename DataType, typename Allocator>
+const DataType& MirroredDelayLine<DataType, Allocator>::operator[](size_t index)
+{
+    return m_data[index + m_index];
+}
+
+
+//! Is Mapped - true if the halves are one set of pages mapped twice
+template <typename DataType, typename Allocator>
+bool MirroredDelayLine<DataType, Allocator>::isMapped() const
+{
+    return m_mapped;
+}
+
+
+//! Page Length - delay lines a multiple of this long can be mapped
+template <typename DataType, typename Allocator>
+size_t MirroredDelayLine<DataType, Allocator>::pageLength()
 {
-    return m_storage[index + m_index];
+#if MIRROREDDELAYLINE_MEMFD
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    if( MirroredDelayLinePlainData<DataType>::value 
+        && MirroredDelayLineSameType<Allocator, AlignedAllocator<DataType> >::value
+        && ((pageSize % sizeof(DataType)) == 0) )
+    {
+        return pageSize / sizeof(DataType);
+    }
+#endif
+    return 0;
 }
 
 
 //! Debug: Print the contents to std::cout 
-template <typename DataType>
-void MirroredDelayLine<DataType>::debug_printContents()
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::debug_printContents()
 {
     std::cout << "[";
     
     for( size_t i = 0; i < m_delayLineLength; i++ )
     {
-        std::cout << m_storage[m_index+i];
+        std::cout << m_data[m_index+i];
         
         if( i < (m_delayLineLength-1) )
         {
@@ -198,6 +430,78 @@ void MirroredDelayLine<DataType>::debug_printContents()
 }
 
 
+//! Allocate the storage for m_delayLineLength, mapped if possible
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::allocate()
+{
+    m_mapped = false;
+
+#if MIRROREDDELAYLINE_MEMFD
+    size_t pages = pageLength();
+    if( (pages > 0) && (m_delayLineLength > 0) && ((m_delayLineLength % pages) == 0) )
+    {
+        size_t bytes = m_delayLineLength * sizeof(DataType);
+
+        int fd = (int)syscall(SYS_memfd_create, "MirroredDelayLine", 1u /* MFD_CLOEXEC */);
+        if( fd >= 0 )
+        {
+            // Reserve both halves, then map the one file over each
+            void * reserved = MAP_FAILED;
+            if( ftruncate(fd, (off_t)bytes) == 0 )
+            {
+                reserved = mmap(NULL, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            }
+
+            if( reserved != MAP_FAILED )
+            {
+                char * base = (char *)reserved;
+                void * first = mmap(base, bytes, PROT_READ | PROT_WRITE, 
+                                    MAP_SHARED | MAP_FIXED, fd, 0);
+                void * second = mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, 
+                                     MAP_SHARED | MAP_FIXED, fd, 0);
+
+                if( (first == base) && (second == base + bytes) )
+                {
+                    m_data = (DataType *)base;
+                    m_mapped = true;
+                }
+                else
+                {
+                    munmap(reserved, 2 * bytes);
+                }
+            }
+
+            // The mappings keep the file alive
+            close(fd);
+        }
+    }
+#endif
+
+    if( !m_mapped )
+    {
+        m_storage.assign(m_totalStorageLength, DataType());
+        m_data = m_storage.empty() ? NULL : &m_storage[0];
+    }
+}
+
+
+//! Release the storage
+template <typename DataType, typename Allocator>
+void MirroredDelayLine<DataType, Allocator>::release()
+{
+#if MIRROREDDELAYLINE_MEMFD
+    if( m_mapped )
+    {
+        munmap(m_data, m_totalStorageLength * sizeof(DataType));
+    }
+#endif
+
+    std::vector<DataType, Allocator>().swap(m_storage);
+    m_data = NULL;
+    m_mapped = false;
+}
+
+
 #endif // MIRROREDDELAYLINE_H
 
 
@@ -41,6 +41,11 @@
 // https://fgiesen.wordpress.com/2012/07/21/the-magic-ring-buffer/
 // 
 //------------------------------------------------------------------------------
+//
+// The storage comes from the Allocator, by default an AlignedAllocator so it
+// starts on a 64 byte boundary (see AlignedAllocator.h).
+//
+//------------------------------------------------------------------------------
 
 #ifndef MIRROREDFIFO_H
 #define MIRROREDFIFO_H
@@ -50,7 +55,9 @@
 #include <iostream>
 #include <vector>
 
-template <typename DataType>
+#include "AlignedAllocator.h"
+
+template <typename DataType, typename Allocator = AlignedAllocator<DataType> >
 class MirroredFifo
 {
 public:
@@ -100,7 +107,7 @@ private:
     size_t m_totalStorageLength;
 	
     //! Storage Vector
-    std::vector<DataType> m_storage;
+    std::vector<DataType, Allocator> m_storage;
     
     //! Head Index (Read from the head)
     volatile size_t m_headIndex;
@@ -112,30 +119,30 @@ private:
 
 
 //! Constructor
-template <typename DataType>
-MirroredFifo<DataType>::MirroredFifo(size_t fifoLength)
+template <typename DataType, typename Allocator>
+MirroredFifo<DataType, Allocator>::MirroredFifo(size_t fifoLength)
     : m_fifoLength(fifoLength+1), m_totalStorageLength(2*m_fifoLength), 
       m_storage(m_totalStorageLength), m_headIndex(0), m_tailIndex(0)
 {
 }
 
 //! Destructor
-template <typename DataType>
-MirroredFifo<DataType>::~MirroredFifo() 
+template <typename DataType, typename Allocator>
+MirroredFifo<DataType, Allocator>::~MirroredFifo() 
 {
 }
 
 //! Clear the fifo
-template <typename DataType>
-void MirroredFifo<DataType>::clear() 
+template <typename DataType, typename Allocator>
+void MirroredFifo<DataType, Allocator>::clear() 
 {
     m_headIndex = 0;
     m_tailIndex = 0;
 }
 
 //! How many values we can read from the fifo.
-template <typename DataType>
-size_t MirroredFifo<DataType>::canRead() 
+template <typename DataType, typename Allocator>
+size_t MirroredFifo<DataType, Allocator>::canRead() 
 {
     size_t canRead = 0;
     if( m_headIndex == m_tailIndex ) {
@@ -149,8 +156,8 @@ size_t MirroredFifo<DataType>::canRead()
 }
 
 //! How many values we can write to the fifo.
-template <typename DataType>
-size_t MirroredFifo<DataType>::canWrite() 
+template <typename DataType, typename Allocator>
+size_t MirroredFifo<DataType, Allocator>::canWrite() 
 {
     //size_t canRead = 0;
     size_t canWrite = 0;
@@ -171,8 +178,8 @@ size_t MirroredFifo<DataType>::canWrite()
 
 
 //! Write data to fifo - array
-template <typename DataType>
-size_t MirroredFifo<DataType>::write( size_t length, const DataType * const data, bool overwrite )
+template <typename DataType, typename Allocator>
+size_t MirroredFifo<DataType, Allocator>::write( size_t length, const DataType * const data, bool overwrite )
 {
     size_t canWriteCount = canWrite();
     
@@ -226,8 +233,8 @@ size_t MirroredFifo<DataType>::write( size_t length, const DataType * const data
 }
     
 //! Write data to fifo - single item
-template <typename DataType>
-size_t MirroredFifo<DataType>::writeOne( const DataType &data, bool overwrite )
+template <typename DataType, typename Allocator>
+size_t MirroredFifo<DataType, Allocator>::writeOne( const DataType &data, bool overwrite )
 {
     size_t canWriteCount = canWrite();
     
@@ -264,8 +271,8 @@ size_t MirroredFifo<DataType>::writeOne( const DataType &data, bool overwrite )
 
 
 //! Read data from the fifo - array - returns number of items read
-template <typename DataType>
-size_t MirroredFifo<DataType>::read( size_t length, DataType * data )
+template <typename DataType, typename Allocator>
+size_t MirroredFifo<DataType, Allocator>::read( size_t length, DataType * data )
 {
     size_t canReadCount = canRead();
     
@@ -297,8 +304,8 @@ size_t MirroredFifo<DataType>::read( size_t length, DataType * data )
 
 
 //! Read data from the fifo - array - returns number of items read
-template <typename DataType>
-DataType MirroredFifo<DataType>::readOne()
+template <typename DataType, typename Allocator>
+DataType MirroredFifo<DataType, Allocator>::readOne()
 {
     // Read from the head
     DataType thing = m_storage[m_headIndex];
@@ -316,8 +323,8 @@ DataType MirroredFifo<DataType>::readOne()
 }
 
 //! Debug: Print the contents to std::cout 
-template <typename DataType>
-void MirroredFifo<DataType>::debug_printContents()
+template <typename DataType, typename Allocator>
+void MirroredFifo<DataType, Allocator>::debug_printContents()
 {
     size_t canReadCount = canRead();
     
@@ -0,0 +1,487 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// MultistageDecimator.h
+//
+//------------------------------------------------------------------------------
+//
+// Large integer decimation ratios as a cascade of PolyphaseDecimators and
+// HalfbandDecimators, with a planner that chooses the stages.
+//
+// A single stage decimating by M needs a transition band that is narrow 
+// relative to the input rate, so its order grows with M and every output 
+// costs order+1 MACs at the highest rate. Splitting M = M1.M2...MK lets the 
+// early stages run with very wide transitions: stage i only has to stop the 
+// bands that would alias into the final band of interest, so its stopband 
+// starts at Fo_i - Fstop where Fo_i is its output rate. Only the last stage 
+// needs the narrow transition, and by then the rate is low.
+// (Crochiere and Rabiner, Multirate Digital Signal Processing, ch. 5)
+//
+// The planner tries every ordered factorisation of M into at most maxStages 
+// factors, estimates each stage order with Kaiser's formula, and keeps the 
+// one with the fewest MACs per output sample. The passband ripple is split 
+// evenly between the stages. The chosen stages are then designed with 
+// FilterFactory::createKaiserFilter at their minimum orders.
+//
+// A stage decimating by 2 can be a HALFBAND design when its passband edge 
+// mirrored about Fs/4 still starts the stopband in time. The transition is
+// then centred on Fs/4, which can be narrower than the stage needs, but with
+// every other tap zero it costs about half the MACs; the planner takes 
+// whichever of the two is cheaper.
+//
+//------------------------------------------------------------------------------
+
+#ifndef MULTISTAGEDECIMATOR_H
+#define MULTISTAGEDECIMATOR_H
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "FilterFactory.h"
+#include "Polyphase.h"
+
+//! Default limit on the number of stages the planner considers
+#define MULTISTAGEDECIMATOR_MAX_STAGES 4
+
+//! Input samples processed through the cascade at a time
+#define MULTISTAGEDECIMATOR_BLOCK 256
+
+
+//! Decimation Stage struct - one stage of a plan
+struct DecimationStageType
+{
+    size_t factor;               //!< Decimation ratio of this stage
+    double inputRate;            //!< Sample rate into this stage
+    double passbandEdge;         //!< Passband edge in Hz
+    double stopbandEdge;         //!< Stopband edge in Hz
+    DoubleFilterHolderType filter;
+    bool halfband;               //!< A HALFBAND design, run with HalfbandDecimator
+    bool meetsSpecification;     //!< Whether the design met its stage specification
+};
+
+//! Decimation Plan struct - the stages and what they cost
+struct DecimationPlanType
+{
+    std::vector<DecimationStageType> stages;  //!< Empty if no plan was possible
+    double macsPerOutput;                     //!< Of the designed stages
+    double singleStageMacsPerOutput;          //!< Estimated, for comparison
+    bool meetsSpecification;                  //!< All stages met their specification
+};
+
+
+template <typename DataType>
+class MultistageDecimator
+{
+public:
+
+    //! Plan - choose and design the stages for decimating inputRate to 
+    //! outputRate, keeping passbandEdge (Hz) within passbandRippleDb and 
+    //! attenuating from stopbandEdge (Hz, at most outputRate/2) by at least 
+    //! stopbandAttenuationDb. inputRate/outputRate must be an integer; if it
+    //! is not, or the bands do not fit, the plan has no stages.
+    static DecimationPlanType plan(double inputRate, double outputRate, 
+        double passbandEdge, double stopbandEdge, double passbandRippleDb, 
+        double stopbandAttenuationDb, size_t maxStages = MULTISTAGEDECIMATOR_MAX_STAGES);
+
+    //! Constructor - runs the stages of a plan
+    MultistageDecimator(const DecimationPlanType& plan);
+
+    //! Destructor
+    virtual ~MultistageDecimator();
+
+    //! Reset the state of every stage
+    void reset();
+
+    //! Get the overall decimation ratio
+    size_t factor();
+
+    //! Get the number of stages
+    size_t stageCount();
+
+    //! Decimate a block - returns the number of output samples written
+    size_t process(const DataType * const input, size_t inputLength, DataType * output);
+
+protected:
+
+private:
+    //! Not copyable
+    MultistageDecimator(const MultistageDecimator&);
+    MultistageDecimator& operator=(const MultistageDecimator&);
+
+    //! Stage specification for a factor at a given input rate - LOWPASS, or
+    //! HALFBAND where that is cheaper
+    static DoubleFilterSpecificationType stageSpecification(double inputRate, 
+        size_t factor, bool lastStage, double passbandEdge, double stopbandEdge, 
+        double passbandRippleDb, double stopbandAttenuationDb);
+
+    //! MACs for each output of a stage of the given type and order
+    static double stageMacs(FilterType::Type filterType, int order);
+
+    //! Search the factorisations of remaining - depth first
+    static void search(size_t remaining, double inputRate, size_t maxStages, 
+        double passbandEdge, double stopbandEdge, double passbandRippleDb, 
+        double stopbandAttenuationDb, double outputRate, 
+        std::vector<size_t>& factors, std::vector<size_t>& bestFactors, 
+        double& bestMacs);
+
+    //! Estimated MACs per output of a factorisation, or a negative value if
+    //! any stage is infeasible
+    static double estimateMacs(const std::vector<size_t>& factors, double inputRate, 
+        double outputRate, double passbandEdge, double stopbandEdge, 
+        double passbandRippleDb, double stopbandAttenuationDb);
+
+    //! Overall decimation ratio
+    size_t m_factor;
+
+    //! Stages in processing order - one of the two is set for each
+    std::vector<PolyphaseDecimator<DataType>*> m_stages;
+    std::vector<HalfbandDecimator<DataType>*> m_halfbandStages;
+
+    //! Intermediate samples - each stage after the first runs in place
+    std::vector<DataType> m_scratch;
+
+}; // class MultistageDecimator
+
+
+//! Plan - choose and design the stages
+template <typename DataType>
+DecimationPlanType MultistageDecimator<DataType>::plan(double inputRate, double outputRate, 
+    double passbandEdge, double stopbandEdge, double passbandRippleDb, 
+    double stopbandAttenuationDb, size_t maxStages /* = MULTISTAGEDECIMATOR_MAX_STAGES */)
+{
+    DecimationPlanType plan;
+    plan.macsPerOutput = 0.0;
+    plan.singleStageMacsPerOutput = 0.0;
+    plan.meetsSpecification = false;
+
+    if( (outputRate <= 0.0) || (inputRate < outputRate) || (passbandEdge <= 0.0) || 
+        (stopbandEdge <= passbandEdge) || (stopbandEdge > 0.5 * outputRate) )
+    {
+        return plan;
+    }
+
+    size_t factor = (size_t)floor(inputRate / outputRate + 0.5);
+    if( fabs((double)factor * outputRate - inputRate) > 1e-9 * inputRate )
+    {
+        return plan;
+    }
+
+    std::vector<size_t> single(1, factor);
+    plan.singleStageMacsPerOutput = estimateMacs(single, inputRate, outputRate, 
+        passbandEdge, stopbandEdge, passbandRippleDb, stopbandAttenuationDb);
+
+    // Rank the factorisations by estimate, then design only the winner
+    std::vector<size_t> factors;
+    std::vector<size_t> bestFactors;
+    double bestMacs = -1.0;
+    search(factor, inputRate, (maxStages < 1) ? 1 : maxStages, passbandEdge, 
+           stopbandEdge, passbandRippleDb, stopbandAttenuationDb, outputRate, 
+           factors, bestFactors, bestMacs);
+
+    if( bestFactors.empty() )
+    {
+        return plan;
+    }
+
+    DoubleFilterFactory filterFactory;
+    double rate = inputRate;
+    plan.meetsSpecification = true;
+
+    for( size_t i = 0; i < bestFactors.size(); i++ )
+    {
+        bool lastStage = (i == (bestFactors.size() - 1));
+        DoubleFilterSpecificationType specification = stageSpecification(rate, 
+            bestFactors[i], lastStage, passbandEdge, stopbandEdge, 
+            passbandRippleDb / (double)bestFactors.size(), stopbandAttenuationDb);
+
+        DoubleFilterResponseType response;
+
+        DecimationStageType stage;
+        stage.factor = bestFactors[i];
+        stage.inputRate = rate;
+        stage.passbandEdge = passbandEdge;
+        stage.stopbandEdge = specification.Fc1 + 0.5 * specification.transitionWidth;
+        stage.filter = filterFactory.createKaiserFilter(specification, &response);
+        stage.halfband = (specification.filterType == FilterType::HALFBAND);
+        stage.meetsSpecification = response.meetsSpecification;
+        plan.stages.push_back(stage);
+
+        rate /= (double)bestFactors[i];
+        plan.macsPerOutput += stageMacs(specification.filterType, stage.filter.order) 
+            * rate / outputRate;
+        plan.meetsSpecification = plan.meetsSpecification && stage.meetsSpecification;
+    }
+
+    return plan;
+}
+
+
+//! Constructor - runs the stages of a plan
+template <typename DataType>
+MultistageDecimator<DataType>::MultistageDecimator(const DecimationPlanType& plan)
+    : m_factor(1), m_scratch(MULTISTAGEDECIMATOR_BLOCK)
+{
+    for( size_t i = 0; i < plan.stages.size(); i++ )
+    {
+        BasicFilterHolderType<DataType> filter(plan.stages[i].filter);
+
+        if( plan.stages[i].halfband )
+        {
+            m_stages.push_back(NULL);
+            m_halfbandStages.push_back(new HalfbandDecimator<DataType>(filter));
+        }
+        else
+        {
+            m_stages.push_back(new PolyphaseDecimator<DataType>(filter, plan.stages[i].factor));
+            m_halfbandStages.push_back(NULL);
+        }
+        m_factor *= plan.stages[i].factor;
+    }
+}
+
+
+//! Destructor
+template <typename DataType>
+MultistageDecimator<DataType>::~MultistageDecimator()
+{
+    for( size_t i = 0; i < m_stages.size(); i++ )
+    {
+        delete m_stages[i];
+        delete m_halfbandStages[i];
+    }
+}
+
+
+//! Reset the state of every stage
+template <typename DataType>
+void MultistageDecimator<DataType>::reset()
+{
+    for( size_t i = 0; i < m_stages.size(); i++ )
+    {
+        if( m_stages[i] != NULL )
+        {
+            m_stages[i]->reset();
+        }
+        else
+        {
+            m_halfbandStages[i]->reset();
+        }
+    }
+}
+
+
+//! Get the overall decimation ratio
+template <typename DataType>
+size_t MultistageDecimator<DataType>::factor()
+{
+    return m_factor;
+}
+
+
+//! Get the number of stages
+template <typename DataType>
+size_t MultistageDecimator<DataType>::stageCount()
+{
+    return m_stages.size();
+}
+
+
+//! Decimate a block - returns the number of output samples written
+template <typename DataType>
+size_t MultistageDecimator<DataType>::process(const DataType * const input, size_t inputLength, 
+                                              DataType * output)
+{
+    if( m_stages.empty() )
+    {
+        return 0;
+    }
+
+    size_t outputLength = 0;
+    size_t lastStage = m_stages.size() - 1;
+
+    for( size_t offset = 0; offset < inputLength; offset += MULTISTAGEDECIMATOR_BLOCK )
+    {
+        size_t length = inputLength - offset;
+        if( length > MULTISTAGEDECIMATOR_BLOCK )
+        {
+            length = MULTISTAGEDECIMATOR_BLOCK;
+        }
+
+        // Neither decimator writes ahead of what it has read, so every stage 
+        // after the first can work in place on the scratch
+        const DataType * source = input + offset;
+        for( size_t i = 0; i < m_stages.size(); i++ )
+        {
+            DataType * destination = (i == lastStage) ? (output + outputLength) : &m_scratch[0];
+            length = (m_stages[i] != NULL) 
+                ? m_stages[i]->process(source, length, destination)
+                : m_halfbandStages[i]->process(source, length, destination);
+            source = destination;
+        }
+
+        outputLength += length;
+    }
+
+    return outputLength;
+}
+
+
+//! Stage specification for a factor at a given input rate
+template <typename DataType>
+DoubleFilterSpecificationType MultistageDecimator<DataType>::stageSpecification(
+    double inputRate, size_t factor, bool lastStage, double passbandEdge, 
+    double stopbandEdge, double passbandRippleDb, double stopbandAttenuationDb)
+{
+    // Earlier stages may alias into the band above stopbandEdge, which later
+    // stages remove. Only what would land below stopbandEdge must be stopped:
+    // from Fo - stopbandEdge.
+    double stageOutputRate = inputRate / (double)factor;
+    double stageStopbandEdge = lastStage ? stopbandEdge : (stageOutputRate - stopbandEdge);
+
+    DoubleFilterSpecificationType specification;
+    specification.filterType = FilterType::LOWPASS;
+    specification.Fs = inputRate;
+    specification.Fc1 = 0.5 * (passbandEdge + stageStopbandEdge);
+    specification.Fc2 = 0.0;
+    specification.passbandRippleDb = passbandRippleDb;
+    specification.stopbandAttenuationDb = stopbandAttenuationDb;
+    specification.transitionWidth = stageStopbandEdge - passbandEdge;
+
+    if( (factor == 2) && (specification.transitionWidth > 0.0) )
+    {
+        // Symmetric about Fs/4: the stopband edge mirrors the passband edge,
+        // and must be no later than the stage needs
+        double halfbandStopbandEdge = 0.5 * inputRate - passbandEdge;
+        if( halfbandStopbandEdge > stageStopbandEdge )
+        {
+            halfbandStopbandEdge = stageStopbandEdge;
+        }
+
+        DoubleFilterSpecificationType halfband = specification;
+        halfband.filterType = FilterType::HALFBAND;
+        halfband.Fc1 = 0.25 * inputRate;
+        halfband.transitionWidth = 2.0 * (halfbandStopbandEdge - 0.25 * inputRate);
+
+        if( (halfband.transitionWidth > 0.0) && 
+            (stageMacs(FilterType::HALFBAND, DoubleFilterFactory::estimateKaiserOrder(halfband)) < 
+             stageMacs(FilterType::LOWPASS, DoubleFilterFactory::estimateKaiserOrder(specification))) )
+        {
+            return halfband;
+        }
+    }
+
+    return specification;
+}
+
+
+//! MACs for each output of a stage of the given type and order
+template <typename DataType>
+double MultistageDecimator<DataType>::stageMacs(FilterType::Type filterType, int order)
+{
+    if( filterType == FilterType::HALFBAND )
+    {
+        // Branch of about order/2+1 taps, plus the centre tap
+        return (double)(order / 2 + 2);
+    }
+    return (double)(order + 1);
+}
+
+
+//! Search the factorisations of remaining - depth first
+template <typename DataType>
+void MultistageDecimator<DataType>::search(size_t remaining, double inputRate, 
+    size_t maxStages, double passbandEdge, double stopbandEdge, 
+    double passbandRippleDb, double stopbandAttenuationDb, double outputRate, 
+    std::vector<size_t>& factors, std::vector<size_t>& bestFactors, double& bestMacs)
+{
+    if( remaining == 1 )
+    {
+        if( factors.empty() )
+        {
+            return;
+        }
+
+        double macs = estimateMacs(factors, inputRate, outputRate, passbandEdge, 
+            stopbandEdge, passbandRippleDb, stopbandAttenuationDb);
+
+        if( (macs >= 0.0) && ((bestMacs < 0.0) || (macs < bestMacs)) )
+        {
+            bestMacs = macs;
+            bestFactors = factors;
+        }
+        return;
+    }
+
+    if( factors.size() == maxStages )
+    {
+        return;
+    }
+
+    for( size_t factor = 2; factor <= remaining; factor++ )
+    {
+        if( (remaining % factor) == 0 )
+        {
+            factors.push_back(factor);
+            search(remaining / factor, inputRate, maxStages, passbandEdge, 
+                   stopbandEdge, passbandRippleDb, stopbandAttenuationDb, outputRate, 
+                   factors, bestFactors, bestMacs);
+            factors.pop_back();
+        }
+    }
+}
+
+
+//! Estimated MACs per output of a factorisation
+template <typename DataType>
+double MultistageDecimator<DataType>::estimateMacs(const std::vector<size_t>& factors, 
+    double inputRate, double outputRate, double passbandEdge, double stopbandEdge, 
+    double passbandRippleDb, double stopbandAttenuationDb)
+{
+    double macs = 0.0;
+    double rate = inputRate;
+
+    for( size_t i = 0; i < factors.size(); i++ )
+    {
+        DoubleFilterSpecificationType specification = stageSpecification(rate, 
+            factors[i], (i == (factors.size() - 1)), passbandEdge, stopbandEdge, 
+            passbandRippleDb / (double)factors.size(), stopbandAttenuationDb);
+
+        if( specification.transitionWidth <= 0.0 )
+        {
+            return -1.0;
+        }
+
+        int order = DoubleFilterFactory::estimateKaiserOrder(specification);
+
+        // Each stage computes only its outputs
+        rate /= (double)factors[i];
+        macs += stageMacs(specification.filterType, order) * rate / outputRate;
+    }
+
+    return macs;
+}
+
+
+#endif // MULTISTAGEDECIMATOR_H
@@ -0,0 +1,811 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// Polyphase.h
+//
+//------------------------------------------------------------------------------
+//
+// Integer ratio polyphase decimator and interpolator built on FilterFactory 
+// LOWPASS designs.
+//
+// PolyphaseDecimator
+// Filtering then keeping one sample in M wastes (M-1)/M of the outputs. Here
+// the dot product is only evaluated for the samples that are kept. This is the
+// commutated form of the polyphase decimator: the M branches h[kM+p] share one
+// history, and the cost is (order+1)/M MACs per input sample.
+// The input is copied a block at a time after the last order samples of 
+// history, and each kept output is a dot product straight out of that linear
+// buffer. Appending one sample at a time and then reading it back with vector
+// loads stalls on store forwarding, which for short filters cost more than 
+// the MACs themselves.
+//
+// PolyphaseInterpolator
+// Zero stuffing then filtering multiplies mostly by zeros. Here the design is
+// split into L branches g_p[k] = h[kL+p], each applied to the un-stuffed input,
+// so every output costs (order+1)/L MACs. The coefficients are scaled by L to
+// keep unity passband gain.
+// https://en.wikipedia.org/wiki/Polyphase_quadrature_filter
+// http://www.dspguru.com/dsp/faqs/multirate/interpolation
+//
+// HalfbandDecimator
+// Decimation by 2 with a HALFBAND design. Every other tap is zero apart from
+// the centre, so the input is split into its two phases: one phase sees only
+// the non-zero side taps (a branch of about order/2+1 taps) and the other 
+// only the centre tap, a pure delay, so each output costs about half the 
+// MACs of PolyphaseDecimator with the same design. The branch is not folded:
+// at the lengths half-band stages have, the folded kernels spend more on 
+// reversing and tails than they save in multiplies.
+//
+// All of them work on raw buffers or between MirroredFifo blocks, and none
+// allocates after construction.
+//
+//------------------------------------------------------------------------------
+
+#ifndef POLYPHASE_H
+#define POLYPHASE_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+#include "MirroredDelayLine.h"
+#include "MirroredFifo.h"
+
+//! Scratch block size used when moving data between MirroredFifos
+#define POLYPHASE_FIFO_BLOCK 256
+
+
+template <typename DataType>
+class PolyphaseDecimator
+{
+public:
+
+    //! Constructor
+    //! filter = a LOWPASS design with its cut at or below Fs/(2*factor)
+    //! factor = the decimation ratio M
+    PolyphaseDecimator(const BasicFilterHolderType<DataType>& filter, size_t factor);
+
+    //! Constructor - designs the anti-aliasing LOWPASS filter
+    //! factor = the decimation ratio M
+    //! order = the filter order
+    //! windowType = the window for the design
+    PolyphaseDecimator(size_t factor, int order, 
+                       FilterWindowType::Type windowType = FilterWindowType::HAMMING);
+
+    //! Destructor
+    virtual ~PolyphaseDecimator();
+
+    //! Reset the filter state (history and phase)
+    void reset();
+
+    //! Get the decimation ratio
+    size_t factor();
+
+    //! Number of outputs that inputLength more inputs will produce
+    size_t outputCount(size_t inputLength);
+
+    //! Decimate a block - returns the number of output samples written
+    size_t process(const DataType * const input, size_t inputLength, DataType * output);
+
+    //! Decimate from one fifo into another - returns the number of output 
+    //! samples written. Only consumes as much input as the output has room for.
+    size_t process(MirroredFifo<DataType>& input, MirroredFifo<DataType>& output);
+
+protected:
+
+private:
+    //! Set up the coefficients
+    void initialise(const BasicFilterHolderType<DataType>& filter);
+
+    //! Decimation ratio
+    size_t m_factor;
+
+    //! Number of taps
+    size_t m_tapCount;
+
+    //! Inputs since the last output
+    size_t m_phase;
+
+    //! Time-reversed coefficients to match the history layout
+    std::vector<DataType> m_coefficients;
+
+    //! Inputs copied into the history per pass
+    size_t m_blockLength;
+
+    //! Last m_tapCount-1 inputs, oldest first, then room for a block
+    std::vector<DataType> m_history;
+
+    //! Scratch buffers for fifo processing
+    std::vector<DataType> m_inputScratch;
+    std::vector<DataType> m_outputScratch;
+
+}; // class PolyphaseDecimator
+
+
+template <typename DataType>
+class PolyphaseInterpolator
+{
+public:
+
+    //! Constructor
+    //! filter = a LOWPASS design with its cut at or below Fs/(2*factor), where 
+    //! Fs is the output rate
+    //! factor = the interpolation ratio L
+    PolyphaseInterpolator(const BasicFilterHolderType<DataType>& filter, size_t factor);
+
+    //! Constructor - designs the anti-imaging LOWPASS filter
+    //! factor = the interpolation ratio L
+    //! order = the filter order
+    //! windowType = the window for the design
+    PolyphaseInterpolator(size_t factor, int order, 
+                          FilterWindowType::Type windowType = FilterWindowType::HAMMING);
+
+    //! Destructor
+    virtual ~PolyphaseInterpolator();
+
+    //! Reset the filter state (history)
+    void reset();
+
+    //! Get the interpolation ratio
+    size_t factor();
+
+    //! Get the number of taps in each branch
+    size_t branchLength();
+
+    //! Interpolate a block - writes inputLength*factor() output samples and 
+    //! returns the number written
+    size_t process(const DataType * const input, size_t inputLength, DataType * output);
+
+    //! Interpolate from one fifo into another - returns the number of output
+    //! samples written. Only consumes as much input as the output has room for.
+    size_t process(MirroredFifo<DataType>& input, MirroredFifo<DataType>& output);
+
+protected:
+
+private:
+    //! Set up the branches
+    void initialise(const BasicFilterHolderType<DataType>& filter);
+
+    //! Interpolation ratio
+    size_t m_factor;
+
+    //! Taps per branch
+    size_t m_branchLength;
+
+    //! Branch coefficients, each time-reversed - m_factor * m_branchLength
+    std::vector<DataType> m_branches;
+
+    //! Input history
+    MirroredDelayLine<DataType> m_delayLine;
+
+    //! Scratch buffers for fifo processing
+    std::vector<DataType> m_inputScratch;
+    std::vector<DataType> m_outputScratch;
+
+}; // class PolyphaseInterpolator
+
+
+template <typename DataType>
+class HalfbandDecimator
+{
+public:
+
+    //! Constructor
+    //! filter = a HALFBAND design, ideally of order 4k+2
+    HalfbandDecimator(const BasicFilterHolderType<DataType>& filter);
+
+    //! Constructor - designs the HALFBAND filter
+    //! order = the filter order, ideally 4k+2
+    //! windowType = the window for the design
+    HalfbandDecimator(int order, 
+                      FilterWindowType::Type windowType = FilterWindowType::HAMMING);
+
+    //! Destructor
+    virtual ~HalfbandDecimator();
+
+    //! Reset the filter state (history and phase)
+    void reset();
+
+    //! Get the decimation ratio - always 2
+    size_t factor();
+
+    //! Get the number of taps in the non-zero branch
+    size_t branchLength();
+
+    //! Number of outputs that inputLength more inputs will produce
+    size_t outputCount(size_t inputLength);
+
+    //! Decimate a block - returns the number of output samples written
+    size_t process(const DataType * const input, size_t inputLength, DataType * output);
+
+    //! Decimate from one fifo into another - returns the number of output 
+    //! samples written. Only consumes as much input as the output has room for.
+    size_t process(MirroredFifo<DataType>& input, MirroredFifo<DataType>& output);
+
+protected:
+
+private:
+    //! Split the design into the branch and centre tap
+    void initialise(const BasicFilterHolderType<DataType>& filter);
+
+    //! Outputs for the pairs in the histories, then keep the newest as history
+    size_t decimateBlock(size_t pairCount, DataType * output);
+
+    //! Taps in the non-zero branch
+    size_t m_branchLength;
+
+    //! Pairs of inputs between the newest and the one on the centre tap
+    size_t m_centreDelay;
+
+    //! Centre tap on the first input of each pair (else the second)
+    bool m_centreFirst;
+
+    //! Centre tap value
+    DataType m_centre;
+
+    //! Inputs since the last output (0 or 1)
+    size_t m_phase;
+
+    //! First input of an incomplete pair
+    DataType m_pending;
+
+    //! Pairs per pass
+    size_t m_blockLength;
+
+    //! Time-reversed branch coefficients
+    std::vector<DataType> m_branch;
+
+    //! Branch phase history, then room for a block
+    std::vector<DataType> m_branchHistory;
+
+    //! Centre phase history, then room for a block
+    std::vector<DataType> m_centreHistory;
+
+    //! Scratch buffers for fifo processing
+    std::vector<DataType> m_inputScratch;
+    std::vector<DataType> m_outputScratch;
+
+}; // class HalfbandDecimator
+
+
+//------------------------------------------------------------------------------
+// PolyphaseDecimator
+//------------------------------------------------------------------------------
+
+//! Constructor
+template <typename DataType>
+PolyphaseDecimator<DataType>::PolyphaseDecimator(const BasicFilterHolderType<DataType>& filter, size_t factor)
+    : m_factor(factor < 1 ? 1 : factor), m_tapCount(filter.coefficients.size()),
+      m_phase(0), m_coefficients(m_tapCount), 
+      m_blockLength(m_tapCount > POLYPHASE_FIFO_BLOCK ? m_tapCount : POLYPHASE_FIFO_BLOCK),
+      m_history((m_tapCount > 0 ? m_tapCount - 1 : 0) + m_blockLength, DataType(0)),
+      m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK)
+{
+    initialise(filter);
+}
+
+
+//! Constructor - designs the anti-aliasing LOWPASS filter
+template <typename DataType>
+PolyphaseDecimator<DataType>::PolyphaseDecimator(size_t factor, int order, 
+                                                 FilterWindowType::Type windowType)
+    : m_factor(factor < 1 ? 1 : factor), m_tapCount(order + 1),
+      m_phase(0), m_coefficients(m_tapCount), 
+      m_blockLength(m_tapCount > POLYPHASE_FIFO_BLOCK ? m_tapCount : POLYPHASE_FIFO_BLOCK),
+      m_history((m_tapCount > 0 ? m_tapCount - 1 : 0) + m_blockLength, DataType(0)),
+      m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK)
+{
+    // Normalised to Fs = 1, cut at the output Nyquist
+    DoubleFilterFactory filterFactory;
+    initialise(filterFactory.createFilter(order, windowType, FilterType::LOWPASS,
+                                          1.0, 0.5 / (double)m_factor));
+}
+
+
+//! Destructor
+template <typename DataType>
+PolyphaseDecimator<DataType>::~PolyphaseDecimator()
+{
+}
+
+
+//! Set up the coefficients
+template <typename DataType>
+void PolyphaseDecimator<DataType>::initialise(const BasicFilterHolderType<DataType>& filter)
+{
+    for( size_t j = 0; j < m_tapCount; j++ )
+    {
+        m_coefficients[j] = (DataType)filter.coefficients[m_tapCount - 1 - j];
+    }
+}
+
+
+//! Reset the filter state (history and phase)
+template <typename DataType>
+void PolyphaseDecimator<DataType>::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), DataType(0));
+    m_phase = 0;
+}
+
+
+//! Get the decimation ratio
+template <typename DataType>
+size_t PolyphaseDecimator<DataType>::factor()
+{
+    return m_factor;
+}
+
+
+//! Number of outputs that inputLength more inputs will produce
+template <typename DataType>
+size_t PolyphaseDecimator<DataType>::outputCount(size_t inputLength)
+{
+    return (m_phase + inputLength) / m_factor;
+}
+
+
+//! Decimate a block - returns the number of output samples written
+template <typename DataType>
+size_t PolyphaseDecimator<DataType>::process(const DataType * const input, size_t inputLength, 
+                                             DataType * output)
+{
+    // An empty design has no taps to filter with
+    if( m_tapCount == 0 )
+    {
+        size_t outputLength = outputCount(inputLength);
+        std::fill(output, output + outputLength, DataType(0));
+        m_phase = (m_phase + inputLength) % m_factor;
+        return outputLength;
+    }
+
+    size_t outputLength = 0;
+    size_t historyLength = m_tapCount - 1;
+
+    for( size_t offset = 0; offset < inputLength; offset += m_blockLength )
+    {
+        size_t length = inputLength - offset;
+        if( length > m_blockLength )
+        {
+            length = m_blockLength;
+        }
+
+        std::copy(input + offset, input + offset + length, m_history.begin() + historyLength);
+
+        // Only the kept samples are calculated - the window ending at block
+        // sample j starts at m_history[j]
+        for( size_t j = m_factor - 1 - m_phase; j < length; j += m_factor )
+        {
+            output[outputLength] = DotProduct::dot(&m_history[j], &m_coefficients[0], m_tapCount);
+            outputLength++;
+        }
+        m_phase = (m_phase + length) % m_factor;
+
+        // Keep the newest samples as history for the next block
+        std::copy(m_history.begin() + length, m_history.begin() + length + historyLength, 
+                  m_history.begin());
+    }
+
+    return outputLength;
+}
+
+
+//! Decimate from one fifo into another - returns the number of output samples written
+template <typename DataType>
+size_t PolyphaseDecimator<DataType>::process(MirroredFifo<DataType>& input, 
+                                             MirroredFifo<DataType>& output)
+{
+    size_t totalWritten = 0;
+
+    for( ;; )
+    {
+        // Limit the input so the outputs fit in the scratch and the fifo
+        size_t outputRoom = output.canWrite();
+        if( outputRoom > m_outputScratch.size() )
+        {
+            outputRoom = m_outputScratch.size();
+        }
+
+        size_t inputLength = (outputRoom + 1) * m_factor - 1 - m_phase;
+        if( inputLength > m_inputScratch.size() )
+        {
+            inputLength = m_inputScratch.size();
+        }
+
+        inputLength = input.read(inputLength, &m_inputScratch[0]);
+        if( inputLength == 0 )
+        {
+            break;
+        }
+
+        size_t outputLength = process(&m_inputScratch[0], inputLength, &m_outputScratch[0]);
+        totalWritten += output.write(outputLength, &m_outputScratch[0]);
+    }
+
+    return totalWritten;
+}
+
+
+//------------------------------------------------------------------------------
+// PolyphaseInterpolator
+//------------------------------------------------------------------------------
+
+//! Constructor
+template <typename DataType>
+PolyphaseInterpolator<DataType>::PolyphaseInterpolator(const BasicFilterHolderType<DataType>& filter, size_t factor)
+    : m_factor(factor < 1 ? 1 : factor), 
+      m_branchLength((filter.coefficients.size() + m_factor - 1) / m_factor),
+      m_branches(m_factor * m_branchLength, DataType(0)), 
+      m_delayLine(m_branchLength, DataType(0)),
+      m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK * m_factor)
+{
+    initialise(filter);
+}
+
+
+//! Constructor - designs the anti-imaging LOWPASS filter
+template <typename DataType>
+PolyphaseInterpolator<DataType>::PolyphaseInterpolator(size_t factor, int order, 
+                                                       FilterWindowType::Type windowType)
+    : m_factor(factor < 1 ? 1 : factor), 
+      m_branchLength((order + m_factor) / m_factor),
+      m_branches(m_factor * m_branchLength, DataType(0)), 
+      m_delayLine(m_branchLength, DataType(0)),
+      m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK * m_factor)
+{
+    // Normalised to the output rate Fs = 1, cut at the input Nyquist
+    DoubleFilterFactory filterFactory;
+    initialise(filterFactory.createFilter(order, windowType, FilterType::LOWPASS,
+                                          1.0, 0.5 / (double)m_factor));
+}
+
+
+//! Destructor
+template <typename DataType>
+PolyphaseInterpolator<DataType>::~PolyphaseInterpolator()
+{
+}
+
+
+//! Set up the branches
+template <typename DataType>
+void PolyphaseInterpolator<DataType>::initialise(const BasicFilterHolderType<DataType>& filter)
+{
+    size_t tapCount = filter.coefficients.size();
+
+    for( size_t p = 0; p < m_factor; p++ )
+    {
+        for( size_t k = 0; k < m_branchLength; k++ )
+        {
+            size_t tap = k * m_factor + p;
+            if( tap < tapCount )
+            {
+                // Time-reversed, with gain L to make up for the stuffed zeros
+                m_branches[p * m_branchLength + m_branchLength - 1 - k] = 
+                    filter.coefficients[tap] * (DataType)m_factor;
+            }
+        }
+    }
+}
+
+
+//! Reset the filter state (history)
+template <typename DataType>
+void PolyphaseInterpolator<DataType>::reset()
+{
+    m_delayLine.clear(DataType(0));
+}
+
+
+//! Get the interpolation ratio
+template <typename DataType>
+size_t PolyphaseInterpolator<DataType>::factor()
+{
+    return m_factor;
+}
+
+
+//! Get the number of taps in each branch
+template <typename DataType>
+size_t PolyphaseInterpolator<DataType>::branchLength()
+{
+    return m_branchLength;
+}
+
+
+//! Interpolate a block - returns the number of output samples written
+template <typename DataType>
+size_t PolyphaseInterpolator<DataType>::process(const DataType * const input, size_t inputLength, 
+                                                DataType * output)
+{
+    // An empty design has no delay line to append to
+    if( m_branchLength == 0 )
+    {
+        std::fill(output, output + inputLength * m_factor, DataType(0));
+        return inputLength * m_factor;
+    }
+
+    size_t outputLength = 0;
+
+    for( size_t i = 0; i < inputLength; i++ )
+    {
+        m_delayLine.append(input[i]);
+
+        for( size_t p = 0; p < m_factor; p++ )
+        {
+            output[outputLength] = DotProduct::dot(m_delayLine.data(), 
+                &m_branches[p * m_branchLength], m_branchLength);
+            outputLength++;
+        }
+    }
+
+    return outputLength;
+}
+
+
+//! Interpolate from one fifo into another - returns the number of output samples written
+template <typename DataType>
+size_t PolyphaseInterpolator<DataType>::process(MirroredFifo<DataType>& input, 
+                                                MirroredFifo<DataType>& output)
+{
+    size_t totalWritten = 0;
+
+    for( ;; )
+    {
+        // Limit the input so the outputs fit in the fifo
+        size_t inputLength = output.canWrite() / m_factor;
+        if( inputLength > m_inputScratch.size() )
+        {
+            inputLength = m_inputScratch.size();
+        }
+
+        inputLength = input.read(inputLength, &m_inputScratch[0]);
+        if( inputLength == 0 )
+        {
+            break;
+        }
+
+        size_t outputLength = process(&m_inputScratch[0], inputLength, &m_outputScratch[0]);
+        totalWritten += output.write(outputLength, &m_outputScratch[0]);
+    }
+
+    return totalWritten;
+}
+
+
+//------------------------------------------------------------------------------
+// HalfbandDecimator
+//------------------------------------------------------------------------------
+
+//! Constructor
+template <typename DataType>
+HalfbandDecimator<DataType>::HalfbandDecimator(const BasicFilterHolderType<DataType>& filter)
+    : m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK)
+{
+    initialise(filter);
+}
+
+
+//! Constructor - designs the HALFBAND filter
+template <typename DataType>
+HalfbandDecimator<DataType>::HalfbandDecimator(int order, FilterWindowType::Type windowType)
+    : m_inputScratch(POLYPHASE_FIFO_BLOCK), m_outputScratch(POLYPHASE_FIFO_BLOCK)
+{
+    // Normalised to Fs = 1
+    DoubleFilterFactory filterFactory;
+    initialise(filterFactory.createFilter(order, windowType, FilterType::HALFBAND, 1.0));
+}
+
+
+//! Destructor
+template <typename DataType>
+HalfbandDecimator<DataType>::~HalfbandDecimator()
+{
+}
+
+
+//! Split the design into the branch and centre tap
+template <typename DataType>
+void HalfbandDecimator<DataType>::initialise(const BasicFilterHolderType<DataType>& filter)
+{
+    // y[2m+1] = sum h[k] x[2m+1-k]. With centre c = order/2 the non-zero side 
+    // taps are the k of the other parity to c, which all land on one phase of
+    // the input pairs; the centre lands on the other.
+    size_t order = (filter.coefficients.size() > 0) ? filter.coefficients.size() - 1 : 0;
+    size_t centre = order / 2;
+    size_t parity = (centre + 1) % 2;
+
+    m_branchLength = (parity == 0) ? (order / 2 + 1) : (order / 2);
+    m_centreDelay = centre / 2;
+    m_centreFirst = (parity == 0);
+    m_centre = (filter.coefficients.size() > 0) ? filter.coefficients[centre] : DataType(0);
+    m_phase = 0;
+    m_pending = DataType(0);
+    m_blockLength = (m_branchLength > POLYPHASE_FIFO_BLOCK) ? m_branchLength : POLYPHASE_FIFO_BLOCK;
+
+    // Oldest first, so branch tap j is h[order - parity - 2j]
+    m_branch.assign(m_branchLength, DataType(0));
+    for( size_t j = 0; j < m_branchLength; j++ )
+    {
+        m_branch[j] = filter.coefficients[order - parity - 2 * j];
+    }
+
+    size_t historyLength = (m_branchLength > 0) ? (m_branchLength - 1) : 0;
+    m_branchHistory.assign(historyLength + m_blockLength, DataType(0));
+    m_centreHistory.assign(m_centreDelay + m_blockLength, DataType(0));
+}
+
+
+//! Reset the filter state (history and phase)
+template <typename DataType>
+void HalfbandDecimator<DataType>::reset()
+{
+    std::fill(m_branchHistory.begin(), m_branchHistory.end(), DataType(0));
+    std::fill(m_centreHistory.begin(), m_centreHistory.end(), DataType(0));
+    m_phase = 0;
+    m_pending = DataType(0);
+}
+
+
+//! Get the decimation ratio - always 2
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::factor()
+{
+    return 2;
+}
+
+
+//! Get the number of taps in the non-zero branch
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::branchLength()
+{
+    return m_branchLength;
+}
+
+
+//! Number of outputs that inputLength more inputs will produce
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::outputCount(size_t inputLength)
+{
+    return (m_phase + inputLength) / 2;
+}
+
+
+//! Decimate a block - returns the number of output samples written
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::process(const DataType * const input, size_t inputLength, 
+                                            DataType * output)
+{
+    size_t outputLength = 0;
+    size_t historyLength = (m_branchLength > 0) ? (m_branchLength - 1) : 0;
+    size_t i = 0;
+
+    while( i < inputLength )
+    {
+        // Split a block of pairs into the two phases
+        DataType * branch = &m_branchHistory[historyLength];
+        DataType * centre = &m_centreHistory[m_centreDelay];
+        DataType * second = m_centreFirst ? branch : centre;
+        DataType * first = m_centreFirst ? centre : branch;
+        size_t pairCount = 0;
+
+        if( m_phase == 1 )
+        {
+            // Complete the pair left over from the last call
+            first[0] = m_pending;
+            second[0] = input[i];
+            pairCount++;
+            i++;
+            m_phase = 0;
+        }
+
+        for( ; ((i + 1) < inputLength) && (pairCount < m_blockLength); i += 2 )
+        {
+            first[pairCount] = input[i];
+            second[pairCount] = input[i + 1];
+            pairCount++;
+        }
+
+        if( ((i + 1) == inputLength) && (pairCount < m_blockLength) )
+        {
+            // Odd one out waits for the next call
+            m_pending = input[i];
+            m_phase = 1;
+            i++;
+        }
+
+        outputLength += decimateBlock(pairCount, output + outputLength);
+    }
+
+    return outputLength;
+}
+
+
+//! Outputs for the pairs in the histories, then keep the newest as history
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::decimateBlock(size_t pairCount, DataType * output)
+{
+    for( size_t r = 0; r < pairCount; r++ )
+    {
+        output[r] = m_centre * m_centreHistory[r];
+    }
+
+    // A single tap design has only the centre
+    if( m_branchLength > 0 )
+    {
+        for( size_t r = 0; r < pairCount; r++ )
+        {
+            output[r] += DotProduct::dot(&m_branchHistory[r], &m_branch[0], m_branchLength);
+        }
+    }
+
+    size_t historyLength = (m_branchLength > 0) ? (m_branchLength - 1) : 0;
+    std::copy(m_branchHistory.begin() + pairCount, 
+              m_branchHistory.begin() + pairCount + historyLength, m_branchHistory.begin());
+    std::copy(m_centreHistory.begin() + pairCount, 
+              m_centreHistory.begin() + pairCount + m_centreDelay, m_centreHistory.begin());
+
+    return pairCount;
+}
+
+
+//! Decimate from one fifo into another - returns the number of output samples written
+template <typename DataType>
+size_t HalfbandDecimator<DataType>::process(MirroredFifo<DataType>& input, 
+                                            MirroredFifo<DataType>& output)
+{
+    size_t totalWritten = 0;
+
+    for( ;; )
+    {
+        // Limit the input so the outputs fit in the scratch and the fifo
+        size_t outputRoom = output.canWrite();
+        if( outputRoom > m_outputScratch.size() )
+        {
+            outputRoom = m_outputScratch.size();
+        }
+
+        size_t inputLength = (outputRoom + 1) * 2 - 1 - m_phase;
+        if( inputLength > m_inputScratch.size() )
+        {
+            inputLength = m_inputScratch.size();
+        }
+
+        inputLength = input.read(inputLength, &m_inputScratch[0]);
+        if( inputLength == 0 )
+        {
+            break;
+        }
+
+        size_t outputLength = process(&m_inputScratch[0], inputLength, &m_outputScratch[0]);
+        totalWritten += output.write(outputLength, &m_outputScratch[0]);
+    }
+
+    return totalWritten;
+}
+
+
+#endif // POLYPHASE_H
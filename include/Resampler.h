@@ -0,0 +1,342 @@
+//------------------------------------------------------------------------------
+// The MIT License (MIT)
+// 
+// Copyright (c) 2015 Benjamin Sherlock
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// Resampler.h
+//
+//------------------------------------------------------------------------------
+//
+// Arbitrary ratio resampler using a windowed-sinc prototype filter from 
+// FilterFactory::createFilterWeights.
+//
+// The prototype is designed at P times the input rate with K taps per input 
+// sample (order K*P) and is stored as P+1 time-reversed phase tables of K taps
+// each. An output at fractional input time n + f uses the two phases either 
+// side of f*P against the same MirroredDelayLine window, and linearly 
+// interpolates between the two dot products.
+// https://ccrma.stanford.edu/~jos/resample/
+//
+// The cut off is placed at rolloff * min(input, output)/2 so the same table 
+// works for up and down sampling. When down sampling K is scaled by the ratio
+// to keep the transition band the same width relative to the output rate.
+//
+// The streaming latency is K/2 input samples (latency()). For offline use
+// skipLatency() lines the first output up with the first input sample.
+//
+//------------------------------------------------------------------------------
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DotProduct.h"
+#include "FilterFactory.h"
+#include "MirroredDelayLine.h"
+#include "WavWriter.h"
+
+template <typename DataType>
+class Resampler
+{
+public:
+
+    //! Constructor
+    //! inputRate, outputRate = the sample rates (only the ratio matters)
+    //! tapsPerPhase = K, taps per input sample of the prototype when up sampling
+    //! phaseCount = P, the number of phases in the table
+    //! windowType = the window for the prototype design
+    //! rolloff = cut off as a fraction of the lower Nyquist frequency
+    Resampler(double inputRate, double outputRate, 
+              size_t tapsPerPhase = 32, size_t phaseCount = 256,
+              FilterWindowType::Type windowType = FilterWindowType::BLACKMAN,
+              double rolloff = 0.9);
+
+    //! Destructor
+    virtual ~Resampler();
+
+    //! Reset the filter state (history and timing)
+    void reset();
+
+    //! Align the first output with the first input sample instead of delaying
+    //! by latency(). Call after construction or reset() and before process().
+    void skipLatency();
+
+    //! Get the latency in input samples
+    double latency();
+
+    //! Get the number of taps per phase in use
+    size_t tapsPerPhase();
+
+    //! Upper bound on the number of outputs for inputLength more inputs
+    size_t maxOutputCount(size_t inputLength);
+
+    //! Resample a block - output must have room for maxOutputCount(inputLength)
+    //! samples. Returns the number of output samples written.
+    size_t process(const DataType * const input, size_t inputLength, DataType * output);
+
+    //! Offline: resample a mono 16-bit wav file to a new rate.
+    //! Returns false if the input could not be read.
+    static bool resampleWav16(std::string inputFilename, std::string outputFilename, 
+                              uint32_t outputRate, size_t tapsPerPhase = 32, 
+                              size_t phaseCount = 256);
+
+protected:
+
+private:
+    //! Taps per phase - even, and scaled up when down sampling
+    static size_t scaledTapsPerPhase(size_t tapsPerPhase, double step);
+
+    //! Input samples per output sample
+    double m_step;
+
+    //! Taps per phase
+    size_t m_tapsPerPhase;
+
+    //! Number of phases
+    size_t m_phaseCount;
+
+    //! Phase tables - (m_phaseCount+1) * m_tapsPerPhase, each time-reversed
+    std::vector<DataType> m_phases;
+
+    //! Input history
+    MirroredDelayLine<DataType> m_delayLine;
+
+    //! Time of the next output relative to the newest input sample
+    double m_nextTime;
+
+}; // class Resampler
+
+
+//! Constructor
+template <typename DataType>
+Resampler<DataType>::Resampler(double inputRate, double outputRate, 
+                               size_t tapsPerPhase, size_t phaseCount,
+                               FilterWindowType::Type windowType, double rolloff)
+    : m_step(inputRate / outputRate), 
+      m_tapsPerPhase(scaledTapsPerPhase(tapsPerPhase, m_step)), 
+      m_phaseCount(phaseCount < 1 ? 1 : phaseCount), 
+      m_phases((m_phaseCount + 1) * m_tapsPerPhase), 
+      m_delayLine(m_tapsPerPhase, DataType(0)), m_nextTime(0.0)
+{
+    double scale = (m_step > 1.0) ? m_step : 1.0;
+
+    // Prototype at P times the input rate (input rate normalised to 1)
+    int order = (int)(m_tapsPerPhase * m_phaseCount);
+    double Fc = rolloff * 0.5 / scale;
+
+    // Designed in double - the prototype is long and narrow
+    DoubleFilterFactory filterFactory;
+    std::vector<double> prototype = filterFactory.createFilterWeights(order, windowType, 
+        FilterType::LOWPASS, (double)m_phaseCount, Fc);
+
+    // Phase p, tap k (k = 0 is the newest sample) is prototype[k*P + p],
+    // scaled by P as each phase only sees one sample in P
+    for( size_t p = 0; p <= m_phaseCount; p++ )
+    {
+        DataType * phase = &m_phases[p * m_tapsPerPhase];
+
+        for( size_t k = 0; k < m_tapsPerPhase; k++ )
+        {
+            phase[m_tapsPerPhase - 1 - k] = 
+                (DataType)(prototype[k*m_phaseCount + p] * (double)m_phaseCount);
+        }
+    }
+}
+
+
+//! Taps per phase - even, and scaled up when down sampling
+template <typename DataType>
+size_t Resampler<DataType>::scaledTapsPerPhase(size_t tapsPerPhase, double step)
+{
+    // Keep the transition width relative to the output rate when down sampling
+    double scale = (step > 1.0) ? step : 1.0;
+    size_t taps = (size_t)ceil((double)(tapsPerPhase < 2 ? 2 : tapsPerPhase) * scale);
+    return taps + (taps & 1);
+}
+
+
+//! Destructor
+template <typename DataType>
+Resampler<DataType>::~Resampler()
+{
+}
+
+
+//! Reset the filter state (history and timing)
+template <typename DataType>
+void Resampler<DataType>::reset()
+{
+    m_delayLine.clear(DataType(0));
+    m_nextTime = 0.0;
+}
+
+
+//! Align the first output with the first input sample
+template <typename DataType>
+void Resampler<DataType>::skipLatency()
+{
+    // The output at time t is the input at t - latency(), so start later
+    m_nextTime = latency();
+}
+
+
+//! Get the latency in input samples
+template <typename DataType>
+double Resampler<DataType>::latency()
+{
+    return (double)m_tapsPerPhase / 2.0;
+}
+
+
+//! Get the number of taps per phase in use
+template <typename DataType>
+size_t Resampler<DataType>::tapsPerPhase()
+{
+    return m_tapsPerPhase;
+}
+
+
+//! Upper bound on the number of outputs for inputLength more inputs
+template <typename DataType>
+size_t Resampler<DataType>::maxOutputCount(size_t inputLength)
+{
+    return (size_t)ceil((double)inputLength / m_step) + 1;
+}
+
+
+//! Resample a block - returns the number of output samples written
+template <typename DataType>
+size_t Resampler<DataType>::process(const DataType * const input, size_t inputLength, 
+                                    DataType * output)
+{
+    size_t outputLength = 0;
+    double phaseScale = (double)m_phaseCount;
+
+    for( size_t i = 0; i < inputLength; i++ )
+    {
+        // Inputs before the next output need no dot products, so when 
+        // downsampling they are appended as one block
+        if( m_nextTime >= 1.0 )
+        {
+            size_t skip = (size_t)m_nextTime;
+            skip = (skip < inputLength - i) ? skip : (inputLength - i);
+
+            m_delayLine.appendBlock(input + i, skip);
+            m_nextTime -= (double)skip;
+            i += skip;
+
+            if( i == inputLength )
+            {
+                break;
+            }
+        }
+
+        m_delayLine.append(input[i]);
+
+        // Every output between this sample and the next
+        while( m_nextTime < 1.0 )
+        {
+            double position = m_nextTime * phaseScale;
+            size_t p = (size_t)position;
+            DataType alpha = (DataType)(position - (double)p);
+
+            const DataType * const window = m_delayLine.data();
+            DataType a = DotProduct::dot(window, &m_phases[p * m_tapsPerPhase], m_tapsPerPhase);
+            DataType b = DotProduct::dot(window, &m_phases[(p+1) * m_tapsPerPhase], m_tapsPerPhase);
+
+            output[outputLength] = a + alpha * (b - a);
+            outputLength++;
+
+            m_nextTime += m_step;
+        }
+
+        m_nextTime -= 1.0;
+    }
+
+    return outputLength;
+}
+
+
+//! Offline: resample a mono 16-bit wav file to a new rate.
+template <typename DataType>
+bool Resampler<DataType>::resampleWav16(std::string inputFilename, std::string outputFilename, 
+                                        uint32_t outputRate, size_t tapsPerPhase, 
+                                        size_t phaseCount)
+{
+    uint32_t inputRate = 0;
+    std::vector<int16_t> samples = WavWriter::readWav16(inputFilename, inputRate);
+
+    if( samples.empty() || (inputRate == 0) || (outputRate == 0) )
+    {
+        return false;
+    }
+
+    Resampler<DataType> resampler((double)inputRate, (double)outputRate, 
+                                  tapsPerPhase, phaseCount);
+    resampler.skipLatency();
+
+    // Convert, and pad with zeros to flush out the filter delay
+    size_t padding = (size_t)ceil(resampler.latency()) + 1;
+    std::vector<DataType> input(samples.size() + padding, DataType(0));
+    for( size_t i = 0; i < samples.size(); i++ )
+    {
+        input[i] = (DataType)samples[i];
+    }
+
+    std::vector<DataType> output(resampler.maxOutputCount(input.size()));
+    size_t outputLength = resampler.process(&input[0], input.size(), &output[0]);
+
+    // Trim to the length of the input at the new rate
+    size_t expectedLength = (size_t)(((uint64_t)samples.size() * outputRate) / inputRate);
+    if( outputLength > expectedLength )
+    {
+        outputLength = expectedLength;
+    }
+
+    // Round and saturate back to 16 bits
+    std::vector<int16_t> result(outputLength > 0 ? outputLength : 1, 0);
+    for( size_t i = 0; i < outputLength; i++ )
+    {
+        double value = floor((double)output[i] + 0.5);
+        if( value > 32767.0 )
+        {
+            value = 32767.0;
+        }
+        else if( value < -32768.0 )
+        {
+            value = -32768.0;
+        }
+        result[i] = (int16_t)value;
+    }
+
+    WavWriter::writeWav16(&result[0], (uint32_t)outputLength, outputRate, outputFilename);
+
+    return true;
+}
+
+
+#endif // RESAMPLER_H
@@ -34,6 +34,8 @@
 #include <string>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 #include <iostream>
 
@@ -124,6 +126,9 @@ public:
 	//! Static: Read Mono Wav File with 16-bit Signed Integers
 	static std::vector<int16_t> readWav16(std::string filename);
 
+	//! Static: Read Mono Wav File with 16-bit Signed Integers - and its sample rate
+	static std::vector<int16_t> readWav16(std::string filename, uint32_t& sampleRate);
+
 protected:
 
     //! Static: Create Empty Header Struct
@@ -138,19 +143,19 @@ private:
 
 
 //! Constructor
-WavWriter::WavWriter()
+inline WavWriter::WavWriter()
 {
 
 }
 
 //! Destructor
-WavWriter::~WavWriter()
+inline WavWriter::~WavWriter()
 {
 
 }
 
 
-void WavWriter::writeHeader(FILE *file, uint16_t audioFormat, uint16_t numChannels, uint32_t sampleRate, uint16_t bitsPerSample)
+inline void WavWriter::writeHeader(FILE *file, uint16_t audioFormat, uint16_t numChannels, uint32_t sampleRate, uint16_t bitsPerSample)
 {
     struct wavutil_header header = createEmptyHeader();
 
@@ -169,7 +174,7 @@ void WavWriter::writeHeader(FILE *file, uint16_t audioFormat, uint16_t numChanne
 
 
 // Write data bytes
-void WavWriter::writeData(FILE *file, uint8_t data[], uint32_t length)
+inline void WavWriter::writeData(FILE *file, uint8_t data[], uint32_t length)
 {
     // Append Data
     if( !file ) return;
@@ -200,7 +205,7 @@ void WavWriter::writeData(FILE *file, uint8_t data[], uint32_t length)
 }
 
 
-struct wavutil_header WavWriter::createEmptyHeader()
+inline struct wavutil_header WavWriter::createEmptyHeader()
 {
     struct wavutil_header header;
 
@@ -221,7 +226,7 @@ struct wavutil_header WavWriter::createEmptyHeader()
 
 
 //! Static: Write Mono Wav File with 16-bit Signed Integers
-void WavWriter::writeWav16(int16_t* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
+inline void WavWriter::writeWav16(int16_t* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
 {
     FILE* file;
 
@@ -247,7 +252,7 @@ void WavWriter::writeWav16(int16_t* data, uint32_t sampleCount, uint32_t sampleR
 
 
 //! Static: Write Mono Wav File with 32-bit Signed Integers
-void WavWriter::writeWav32(int32_t* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
+inline void WavWriter::writeWav32(int32_t* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
 {
     FILE* file;
 
@@ -273,7 +278,7 @@ void WavWriter::writeWav32(int32_t* data, uint32_t sampleCount, uint32_t sampleR
 
 
 //! Static: Write Mono Wav File with 32-bit Floats
-void WavWriter::writeWavFloat32(float* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
+inline void WavWriter::writeWavFloat32(float* data, uint32_t sampleCount, uint32_t sampleRate, std::string filename)
 {
     FILE* file;
 
@@ -297,7 +302,7 @@ void WavWriter::writeWavFloat32(float* data, uint32_t sampleCount, uint32_t samp
 }
 
 
-void WavWriter::writeLittleEndian(uint32_t word, uint32_t num_bytes, FILE *wav_file)
+inline void WavWriter::writeLittleEndian(uint32_t word, uint32_t num_bytes, FILE *wav_file)
 {
     uint8_t buf;
     while(num_bytes>0)
@@ -310,7 +315,14 @@ void WavWriter::writeLittleEndian(uint32_t word, uint32_t num_bytes, FILE *wav_f
 }
 
 //! Static: Read Mono Wav File with 16-bit Signed Integers
-std::vector<int16_t> WavWriter::readWav16(std::string filename)
+inline std::vector<int16_t> WavWriter::readWav16(std::string filename)
+{
+	uint32_t sampleRate = 0;
+	return readWav16(filename, sampleRate);
+}
+
+//! Static: Read Mono Wav File with 16-bit Signed Integers - and its sample rate
+inline std::vector<int16_t> WavWriter::readWav16(std::string filename, uint32_t& sampleRate)
 {
 	std::vector<int16_t> samples;
 	
@@ -348,6 +360,7 @@ std::vector<int16_t> WavWriter::readWav16(std::string filename)
 		return samples;
 	}
 	
+	sampleRate = header.sampleRate;
     //header.sampleRate = sampleRate;
     //header.byteRate = sampleRate * (bitsPerSample/8);
     //header.blockAlign = (bitsPerSample/8);